@@ -0,0 +1,30 @@
+# Shared by the benchmark programs: Qt and libzelda from common.pri and
+# the parts of the editor they exercise.
+#
+# Every benchmark prints its result through QTest, so the usual output
+# options apply: "-o results.xml,xml" (Qt 5) or "-xml -o results.xml"
+# (Qt 4) write machine readable results, "-csv" one line per benchmark.
+
+include($$PWD/common.pri)
+
+CONFIG += console
+CONFIG -= app_bundle
+
+include($$PWD/../wiiking2_editor/wiiking2_core.pri)
+
+SOURCES += \
+    $$PWD/../wiiking2_editor/src/skywardswordfile.cpp \
+    $$PWD/../wiiking2_editor/src/settingsmanager.cpp \
+    $$PWD/../wiiking2_editor/src/common.cpp \
+    $$PWD/../wiiking2_editor/src/qhexedit2/xbytearray.cpp \
+    $$PWD/../wiiking2_editor/src/qhexedit2/changebitmap.cpp \
+    $$PWD/../wiiking2_editor/src/qhexedit2/hexdumpformatter.cpp
+
+HEADERS += \
+    $$PWD/../wiiking2_editor/include/igamefile.h \
+    $$PWD/../wiiking2_editor/include/skywardswordfile.h \
+    $$PWD/../wiiking2_editor/include/settingsmanager.h \
+    $$PWD/../wiiking2_editor/include/common.h \
+    $$PWD/../wiiking2_editor/include/qhexedit2/xbytearray.h \
+    $$PWD/../wiiking2_editor/include/qhexedit2/changebitmap.h \
+    $$PWD/../wiiking2_editor/include/qhexedit2/hexdumpformatter.h
@@ -0,0 +1,26 @@
+# Qt and libzelda for the benchmark programs that link the editor.
+# benchmarks.pri adds the parts of the editor the model benchmarks
+# exercise, the UI benchmark takes the whole editor from wiiking2_gui.pri.
+
+QT += core gui testlib
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG(debug, debug|release){
+    DEFINES += DEBUG INTERNAL
+    unix:LIBS  += -L$$PWD/../libzelda -lzelda-d
+    win32:LIBS += -L$$PWD/../libzelda -lzelda-d
+}
+CONFIG(release, release|debug){
+    DEFINES -= DEBUG
+    DEFINES += INTERNAL
+    unix:LIBS  += -L$$PWD/../libzelda -lzelda
+    win32:LIBS += -L$$PWD/../libzelda -lzelda
+}
+
+QMAKE_CXXFLAGS = -O2 -std=c++0x
+
+TEMPLATE = app
+INCLUDEPATH += $$PWD/../wiiking2_editor/include \
+           $$PWD/../libzelda/include
+unix:LIBS  += -lz
+win32:LIBS += -lzlib
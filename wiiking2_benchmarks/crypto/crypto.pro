@@ -0,0 +1,27 @@
+#-------------------------------------------------
+#
+# Known-answer tests for the AES and ECDSA code
+#
+#-------------------------------------------------
+
+QT = core testlib
+
+CONFIG += console
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS = -O2 -std=c++0x
+
+TEMPLATE = app
+unix:TARGET =../../wiiking2_cryptotest.x86_64
+INCLUDEPATH += ./include \
+           ../../wiiking2_editor/include
+
+SOURCES += \
+    src/cryptotest.cpp \
+    ../../wiiking2_editor/src/aes128.cpp \
+    ../../wiiking2_editor/src/ec233.cpp
+
+HEADERS += \
+    include/cryptotest.h \
+    ../../wiiking2_editor/include/aes128.h \
+    ../../wiiking2_editor/include/ec233.h
@@ -0,0 +1,38 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef CRYPTOTEST_H
+#define CRYPTOTEST_H
+
+#include <QObject>
+
+// Known-answer tests for the code data.bin files are encrypted and signed
+// with. Every AES backend the CPU supports is checked against the
+// published vectors and Ec233 against a signature made by OpenSSL, so a
+// broken backend fails the run instead of writing saves the Wii rejects.
+class CryptoTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void aes128_data();
+    void aes128();
+    void aes128Cbc_data();
+    void aes128Cbc();
+    void ec233PublicKey();
+    void ec233Verify();
+    void ec233Sign();
+};
+
+#endif // CRYPTOTEST_H
@@ -0,0 +1,155 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "cryptotest.h"
+#include "aes128.h"
+#include "ec233.h"
+
+#include <QtTest>
+#include <string.h>
+
+Q_DECLARE_METATYPE(Aes128::Backend)
+
+static QByteArray fromHex(const char* hex)
+{
+    return QByteArray::fromHex(hex);
+}
+
+// One row per backend this CPU can run, the portable one always works
+static void addBackendRows()
+{
+    QTest::addColumn<Aes128::Backend>("backend");
+
+    QTest::newRow("portable") << Aes128::PortableBackend;
+    if (Aes128::isSupported(Aes128::AesNiBackend))
+        QTest::newRow("AES-NI") << Aes128::AesNiBackend;
+}
+
+void CryptoTest::aes128_data()
+{
+    addBackendRows();
+}
+
+// FIPS-197 appendix C.1, a single block with a zero IV is plain ECB
+void CryptoTest::aes128()
+{
+    QFETCH(Aes128::Backend, backend);
+
+    QByteArray key        = fromHex("000102030405060708090a0b0c0d0e0f");
+    QByteArray plaintext  = fromHex("00112233445566778899aabbccddeeff");
+    QByteArray ciphertext = fromHex("69c4e0d86a7b0430d8cdb78070b4c55a");
+
+    Aes128 aes((const quint8*)key.constData());
+    aes.setBackend(backend);
+    QCOMPARE(int(aes.backend()), int(backend));
+
+    QByteArray block = plaintext;
+    quint8 iv[Aes128::BLOCK_SIZE];
+    memset(iv, 0, sizeof(iv));
+    aes.encryptCbc((const quint8*)block.constData(), (quint8*)block.data(), block.size(), iv);
+    QCOMPARE(block.toHex(), ciphertext.toHex());
+
+    memset(iv, 0, sizeof(iv));
+    aes.decryptCbc((const quint8*)block.constData(), (quint8*)block.data(), block.size(), iv);
+    QCOMPARE(block.toHex(), plaintext.toHex());
+}
+
+void CryptoTest::aes128Cbc_data()
+{
+    addBackendRows();
+}
+
+// NIST SP 800-38A F.2.1 and F.2.2, four chained blocks; the AES-NI
+// backend decrypts several blocks at once, so chaining is checked too
+void CryptoTest::aes128Cbc()
+{
+    QFETCH(Aes128::Backend, backend);
+
+    QByteArray key        = fromHex("2b7e151628aed2a6abf7158809cf4f3c");
+    QByteArray iv         = fromHex("000102030405060708090a0b0c0d0e0f");
+    QByteArray plaintext  = fromHex("6bc1bee22e409f96e93d7e117393172a"
+                                    "ae2d8a571e03ac9c9eb76fac45af8e51"
+                                    "30c81c46a35ce411e5fbc1191a0a52ef"
+                                    "f69f2445df4f9b17ad2b417be66c3710");
+    QByteArray ciphertext = fromHex("7649abac8119b246cee98e9b12e9197d"
+                                    "5086cb9b507219ee95db113a917678b2"
+                                    "73bed6b8e3c1743b7116e69e22229516"
+                                    "3ff1caa1681fac09120eca307586e1a7");
+
+    Aes128 aes((const quint8*)key.constData());
+    aes.setBackend(backend);
+
+    QByteArray data = plaintext;
+    QByteArray state = iv;
+    aes.encryptCbc((const quint8*)data.constData(), (quint8*)data.data(), data.size(), (quint8*)state.data());
+    QCOMPARE(data.toHex(), ciphertext.toHex());
+    QCOMPARE(state.toHex(), ciphertext.right(Aes128::BLOCK_SIZE).toHex());
+
+    state = iv;
+    aes.decryptCbc((const quint8*)data.constData(), (quint8*)data.data(), data.size(), (quint8*)state.data());
+    QCOMPARE(data.toHex(), plaintext.toHex());
+}
+
+// A sect233r1 key and a SHA-1 signature of "WiiKing2 Editor", both made
+// with "openssl ecparam -name sect233r1 -genkey" and "openssl dgst -sha1
+// -sign". R and S are padded to 30 bytes.
+static const char EC_MESSAGE[]    = "WiiKing2 Editor";
+static const char EC_PRIVATE[]    = "00f75c3ae4b2709f8201d759178c85625f70fab48e2badcdb4ed1772dd15";
+static const char EC_PUBLIC[]     = "019d2fc0b75a096a7bd5b6d9a7414481548a11292f71ef5444952358429e"
+                                    "009358a3f0993ffd7e44724ff17ea3cf458486043bd7316c0af2c51bd3a3";
+static const char EC_SIGNATURE[]  = "00ff3c0f8dccb8aa617e22cbe6c3f4d40eecffa6d5be043a90d2a1495491"
+                                    "000015af43e8fb847c9aa4cad05d3e9ddb5b9c12ba6c426fe8b7bf5e612e";
+
+static QByteArray messageHash()
+{
+    return QCryptographicHash::hash(QByteArray(EC_MESSAGE), QCryptographicHash::Sha1);
+}
+
+void CryptoTest::ec233PublicKey()
+{
+    QByteArray priv = fromHex(EC_PRIVATE);
+    QByteArray pub(Ec233::POINT_SIZE, 0);
+    Ec233::publicKey((const quint8*)priv.constData(), (quint8*)pub.data());
+    QCOMPARE(pub.toHex(), QByteArray(EC_PUBLIC));
+}
+
+void CryptoTest::ec233Verify()
+{
+    QByteArray pub = fromHex(EC_PUBLIC);
+    QByteArray hash = messageHash();
+    QByteArray signature = fromHex(EC_SIGNATURE);
+    QVERIFY(Ec233::verify((const quint8*)pub.constData(), (const quint8*)hash.constData(), (const quint8*)signature.constData()));
+
+    // a single flipped bit in S or in the hash has to be rejected
+    signature[Ec233::SIGNATURE_SIZE - 1] = signature[Ec233::SIGNATURE_SIZE - 1] ^ 1;
+    QVERIFY(!Ec233::verify((const quint8*)pub.constData(), (const quint8*)hash.constData(), (const quint8*)signature.constData()));
+    signature = fromHex(EC_SIGNATURE);
+    hash[0] = hash[0] ^ 1;
+    QVERIFY(!Ec233::verify((const quint8*)pub.constData(), (const quint8*)hash.constData(), (const quint8*)signature.constData()));
+}
+
+// Signatures use a derived nonce, so they differ from OpenSSL's but have
+// to verify against the same public key
+void CryptoTest::ec233Sign()
+{
+    QByteArray priv = fromHex(EC_PRIVATE);
+    QByteArray pub = fromHex(EC_PUBLIC);
+    QByteArray hash = messageHash();
+    QByteArray signature(Ec233::SIGNATURE_SIZE, 0);
+    Ec233::sign((const quint8*)priv.constData(), (const quint8*)hash.constData(), (quint8*)signature.data());
+    QVERIFY(Ec233::verify((const quint8*)pub.constData(), (const quint8*)hash.constData(), (const quint8*)signature.constData()));
+}
+
+QTEST_APPLESS_MAIN(CryptoTest)
@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Open, edit and save cycles through SkywardSwordFile
+#
+#-------------------------------------------------
+
+include(../benchmarks.pri)
+
+unix:TARGET =../../wiiking2_cyclebench.x86_64
+INCLUDEPATH += ./include
+
+SOURCES += \
+    src/cyclebench.cpp
+
+HEADERS += \
+    include/cyclebench.h
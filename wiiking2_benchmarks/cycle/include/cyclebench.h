@@ -0,0 +1,54 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef CYCLEBENCH_H
+#define CYCLEBENCH_H
+
+#include <QObject>
+#include <QStringList>
+
+// Opens a corpus file with SkywardSwordFile, applies an edit script like a
+// short session in the editor would and saves it, over the whole corpus at
+// 1 to N threads. Every row reports the median cycle as its QTest result
+// and adds a line to a CSV summary with files/s, p50/p99 latency and where
+// the time went (I/O, crypto, checksums, the rest being the model).
+//
+// WIIKING2_CORPUS      directory of wiiking2.sav and data.bin files,
+//                      otherwise a corpus is generated
+// WIIKING2_CYCLES      size of the generated corpus, 400 by default
+// WIIKING2_THREADS     highest thread count, one per core by default
+// WIIKING2_SUMMARY     where the CSV summary goes, cyclebench.csv in the
+//                      temporary directory by default
+//
+// The generated corpus is made by SaveGenerator, every second save is
+// turned into a data.bin signed with test keys, so the crypto phase is
+// measured as well. A corpus of its own only uses data.bin files when the
+// keys set in the editor's preferences are valid, saving them needs a
+// signature.
+class CycleBench : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cycle_data();
+    void cycle();
+
+private:
+    QString     m_workDir;
+    QString     m_summary;
+    QStringList m_files;
+};
+
+#endif // CYCLEBENCH_H
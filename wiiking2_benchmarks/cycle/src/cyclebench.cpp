@@ -0,0 +1,291 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "cyclebench.h"
+#include "phasetimer.h"
+#include "savegenerator.h"
+#include "skywardswordfile.h"
+#include "wiikeys.h"
+
+#include <QAtomicInt>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QtEndian>
+#include <QtTest>
+#include <algorithm>
+#include <string.h>
+
+static const int DEFAULT_CYCLES = 400;
+
+static int envNumber(const char* name, int defaultValue)
+{
+    bool ok = false;
+    int value = qgetenv(name).toInt(&ok);
+    return (ok && value > 0) ? value : defaultValue;
+}
+
+// What a short session in the editor does to the current adventure
+static void editScript(SkywardSwordFile& file, int i)
+{
+    file.setRupees(i % 9900);
+    file.setBugQuantity(SkywardSwordFile::HornetBug, i % 99);
+    file.setMaterialQuantity(SkywardSwordFile::EldinOreMaterial, (i * 7) % 99);
+    file.setAmmo(SkywardSwordFile::ArrowAmmo, i % 50);
+    file.setSword(SkywardSwordFile::MasterSword, i & 1);
+    file.setHeroMode(i & 2);
+    file.setTotalHP(80);
+    file.setCurrentHP(i % 80);
+    file.setPlayerPosition(float(i), 1237.629517f, -6573.722656f);
+    file.setPlayerName((i & 1) ? "Link" : "Zelda");
+    file.setSaveTime(QDateTime::currentDateTime());
+}
+
+// A BackupMii keys.bin no Wii would accept, but enough to sign the
+// generated data.bin files; the private key is below the curve order
+static bool writeTestKeys(const QString& path)
+{
+    QByteArray data(0x400, 0);
+    memcpy(data.data(), "BackupMii v1", 12);
+    uchar* p = (uchar*)data.data();
+    qToBigEndian<quint32>(0x0403AC68, p + 0x124);
+    for (int i = 1; i < 0x1E; i++)
+        p[0x128 + i] = uchar(i);
+    qToBigEndian<quint32>(0x6AAB8C59, p + 0x208);
+    for (int i = 0; i < 0x3C; i++)
+        p[0x20C + i] = uchar(0xA5 ^ i);
+
+    QFile file(path);
+    return file.open(QFile::WriteOnly | QFile::Truncate) && file.write(data) == data.size();
+}
+
+// SaveGenerator's corpus with every second save turned into a data.bin
+static bool generateCorpus(const QString& corpus, int count, QString* error)
+{
+    QDir dir(corpus);
+    foreach (const QString& name, dir.entryList(QDir::Files))
+        dir.remove(name);
+
+    SaveGenerator generator;
+    if (!generator.run(corpus, count))
+    {
+        *error = generator.errors().join("\n");
+        return false;
+    }
+
+    QStringList saves = dir.entryList(QStringList() << "*.sav", QDir::Files, QDir::Name);
+    for (int i = 1; i < saves.size(); i += 2)
+    {
+        QString path = dir.filePath(saves[i]);
+        SkywardSwordFile file(path, SkywardSwordFile::Game1);
+        QString dataBin = path.left(path.size() - 4) + ".bin";
+        if (!file.isOpen() || !file.save(dataBin))
+        {
+            *error = dataBin + ": " + file.lastError();
+            return false;
+        }
+        dir.remove(saves[i]);
+    }
+    return true;
+}
+
+struct CycleRun
+{
+    QStringList     Files;
+    QAtomicInt      Next;
+    QMutex          Mutex;
+    QVector<qint64> LatencyNs;
+    qint64          PhaseNs[PhaseTimer::PhaseCount];
+    QStringList     Errors;
+};
+
+// Takes files off the run until there are none left
+class CycleTask : public QRunnable
+{
+public:
+    explicit CycleTask(CycleRun* run) :
+        m_run(run)
+    {
+    }
+
+    void run()
+    {
+        QVector<qint64> latencies;
+        QStringList errors;
+        QElapsedTimer timer;
+        PhaseTimer::reset();
+
+        int i;
+        while ((i = m_run->Next.fetchAndAddRelaxed(1)) < m_run->Files.size())
+        {
+            const QString& path = m_run->Files[i];
+            timer.start();
+            SkywardSwordFile file(path, SkywardSwordFile::Game1);
+            if (!file.isOpen())
+            {
+                errors << path + ": " + file.lastError();
+                continue;
+            }
+
+            // edit the first adventure in use, if there is one
+            for (int game = 0; game < SkywardSwordFile::GameCount; game++)
+            {
+                file.setGame((SkywardSwordFile::Game)game);
+                if (!file.isNew())
+                    break;
+            }
+            editScript(file, i);
+            if (!file.save())
+                errors << path + ": " + file.lastError();
+            latencies << timer.nsecsElapsed();
+        }
+
+        QMutexLocker locker(&m_run->Mutex);
+        m_run->LatencyNs << latencies;
+        m_run->Errors << errors;
+        for (int phase = 0; phase < PhaseTimer::PhaseCount; phase++)
+            m_run->PhaseNs[phase] += PhaseTimer::elapsed((PhaseTimer::Phase)phase);
+    }
+
+private:
+    CycleRun* m_run;
+};
+
+static double percentileMs(const QVector<qint64>& sorted, int percent)
+{
+    if (sorted.isEmpty())
+        return 0.0;
+    return sorted[(sorted.size() - 1) * percent / 100] / 1e6;
+}
+
+void CycleBench::initTestCase()
+{
+    QDir temp(QDir::temp().filePath("wiiking2_cyclebench"));
+    QVERIFY(temp.mkpath("."));
+    QString corpus = QString::fromLocal8Bit(qgetenv("WIIKING2_CORPUS"));
+    bool dataBin;
+    if (corpus.isEmpty())
+    {
+        // Settings of its own, the test keys must never reach the editor's
+        QCoreApplication::setOrganizationName("WiiKing2");
+        QCoreApplication::setApplicationName("WiiKing2 CycleBench");
+        QString keys = temp.filePath("keys.bin");
+        QVERIFY(writeTestKeys(keys));
+        QVERIFY(WiiKeys::instance()->open(keys, true));
+        WiiKeys::instance()->setMacAddr(QByteArray("\x00\x17\xAB\x12\x34\x56", 6));
+        dataBin = true;
+
+        QString error;
+        corpus = temp.filePath("corpus");
+        QVERIFY2(generateCorpus(corpus, envNumber("WIIKING2_CYCLES", DEFAULT_CYCLES), &error), qPrintable(error));
+    }
+    else
+    {
+        // The editor's settings, for the keys
+        QCoreApplication::setOrganizationName("WiiKing2");
+        QCoreApplication::setApplicationName("WiiKing2 Editor");
+        dataBin = WiiKeys::instance()->loadKeys() && WiiKeys::instance()->isValid();
+    }
+
+    // Saving overwrites the files, so the cycles run on copies
+    m_workDir = temp.filePath("work");
+    QDir work(m_workDir);
+    QVERIFY(work.mkpath("."));
+    foreach (const QString& name, QDir(corpus).entryList(QDir::Files, QDir::Name))
+    {
+        if (name.endsWith(".bin") && !dataBin)
+        {
+            qWarning("Skipping %s, no valid keys to sign data.bin", qPrintable(name));
+            continue;
+        }
+
+        QString copy = work.filePath(name);
+        QFile::remove(copy);
+        QVERIFY(QFile::copy(QDir(corpus).filePath(name), copy));
+        m_files << copy;
+    }
+    QVERIFY2(!m_files.isEmpty(), "The corpus is empty");
+
+    m_summary = QString::fromLocal8Bit(qgetenv("WIIKING2_SUMMARY"));
+    if (m_summary.isEmpty())
+        m_summary = temp.filePath("cyclebench.csv");
+    QFile summary(m_summary);
+    QVERIFY2(summary.open(QFile::WriteOnly | QFile::Truncate | QFile::Text), qPrintable(m_summary));
+    summary.write("threads,files,wall_ms,files_per_s,p50_ms,p99_ms,io_ms,crypto_ms,checksum_ms,model_ms\n");
+}
+
+void CycleBench::cycle_data()
+{
+    QTest::addColumn<int>("threads");
+
+    int maxThreads = envNumber("WIIKING2_THREADS", QThread::idealThreadCount());
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        QTest::newRow(qPrintable(QString("%1 threads").arg(threads))) << threads;
+    QTest::newRow(qPrintable(QString("%1 threads").arg(maxThreads))) << maxThreads;
+}
+
+void CycleBench::cycle()
+{
+    QFETCH(int, threads);
+
+    CycleRun run;
+    run.Files = m_files;
+    memset(run.PhaseNs, 0, sizeof(run.PhaseNs));
+
+    PhaseTimer::setEnabled(true);
+    QElapsedTimer wall;
+    wall.start();
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (int i = 0; i < threads; i++)
+        pool.start(new CycleTask(&run));
+    pool.waitForDone();
+    qint64 wallNs = wall.nsecsElapsed();
+    PhaseTimer::setEnabled(false);
+
+    foreach (const QString& error, run.Errors)
+        qWarning("%s", qPrintable(error));
+
+    QVector<qint64> sorted = run.LatencyNs;
+    std::sort(sorted.begin(), sorted.end());
+    qint64 busyNs = 0;
+    foreach (qint64 ns, sorted)
+        busyNs += ns;
+    qint64 modelNs = busyNs - run.PhaseNs[PhaseTimer::IoPhase] - run.PhaseNs[PhaseTimer::CryptoPhase]
+                            - run.PhaseNs[PhaseTimer::ChecksumPhase];
+
+    // Summed over the threads, so the shares add up to the busy time
+    QFile summary(m_summary);
+    QVERIFY2(summary.open(QFile::WriteOnly | QFile::Append | QFile::Text), qPrintable(m_summary));
+    char line[256];
+    qsnprintf(line, sizeof(line), "%d,%d,%.1f,%.1f,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f\n",
+           threads, sorted.size(), wallNs / 1e6, wallNs > 0 ? sorted.size() / (wallNs / 1e9) : 0.0,
+           percentileMs(sorted, 50), percentileMs(sorted, 99),
+           run.PhaseNs[PhaseTimer::IoPhase] / 1e6, run.PhaseNs[PhaseTimer::CryptoPhase] / 1e6,
+           run.PhaseNs[PhaseTimer::ChecksumPhase] / 1e6, modelNs / 1e6);
+    summary.write(line);
+
+    QTest::setBenchmarkResult(percentileMs(sorted, 50), QTest::WalltimeMilliseconds);
+    QVERIFY2(run.Errors.isEmpty(), "Some cycles failed");
+}
+
+QTEST_MAIN(CycleBench)
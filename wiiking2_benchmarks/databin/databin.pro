@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Loading data.bin files through SkywardSwordFile
+#
+#-------------------------------------------------
+
+include(../benchmarks.pri)
+
+unix:TARGET =../../wiiking2_databintest.x86_64
+INCLUDEPATH += ./include
+
+SOURCES += \
+    src/databintest.cpp
+
+HEADERS += \
+    include/databintest.h
@@ -0,0 +1,39 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+
+#ifndef DATABINTEST_H
+#define DATABINTEST_H
+
+#include <QObject>
+#include <QString>
+
+// Loads data.bin files built in memory through SkywardSwordFile. The
+// wiiking2.sav payload and the banner are read without libzelda, so these
+// check that what the editor shows comes from the file itself.
+class DataBinTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void bannerTitle();
+    void bannerImages();
+
+private:
+    QString m_path;
+};
+
+#endif // DATABINTEST_H
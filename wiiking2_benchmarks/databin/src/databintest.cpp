@@ -0,0 +1,122 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+
+#include "databintest.h"
+#include "databincodec.h"
+#include "databinreader.h"
+#include "savetemplate.h"
+#include "skywardswordfile.h"
+
+#include <QtEndian>
+#include <QtTest>
+#include <string.h>
+
+static const quint64 TITLE_ID    = Q_UINT64_C(0x00010000534F5545);  // SOUE
+static const quint32 BANNER_SIZE = 0xA0 + DataBinReader::BANNER_WIDTH * DataBinReader::BANNER_HEIGHT * 2
+                                        + DataBinReader::ICON_WIDTH * DataBinReader::ICON_HEIGHT * 2;
+
+static void writeBannerString(quint8* data, const QString& str)
+{
+    for (int i = 0; i < str.size(); i++)
+        qToBigEndian<quint16>(str[i].unicode(), data + i * 2);
+}
+
+// A data.bin with a single file, wiiking2.sav, and a banner with the given
+// titles and a white icon, encrypted the way the Wii writes it
+static QByteArray buildDataBin(const QString& title, const QString& subtitle)
+{
+    QByteArray save = SaveTemplate::emptyFile(SkywardSwordFile::NTSCURegion);
+    DataBinCodec::FileEntry entry;
+    entry.Type = 1;
+    entry.Size = save.size();
+
+    quint32 fileHeader = DataBinCodec::HEADER_SIZE + DataBinCodec::BK_HEADER_SIZE;
+    quint32 payload = fileHeader + DataBinCodec::FILE_HEADER_SIZE;
+    QByteArray image(payload + DataBinCodec::storedSize(entry), 0);
+    quint8* data = (quint8*)image.data();
+
+    qToBigEndian<quint64>(TITLE_ID, data);
+    qToBigEndian<quint32>(BANNER_SIZE, data + 0x08);
+    quint8* banner = data + 0x20;
+    memcpy(banner, "WIBN", 4);
+    writeBannerString(banner + 0x20, title);
+    writeBannerString(banner + 0x60, subtitle);
+    memset(banner + BANNER_SIZE - DataBinReader::ICON_WIDTH * DataBinReader::ICON_HEIGHT * 2, 0xFF,
+           DataBinReader::ICON_WIDTH * DataBinReader::ICON_HEIGHT * 2);
+
+    quint8* bk = data + DataBinCodec::HEADER_SIZE;
+    qToBigEndian<quint32>(0x70, bk);
+    qToBigEndian<quint16>(0x426B, bk + 0x04);
+    qToBigEndian<quint32>(1, bk + 0x0C);
+    qToBigEndian<quint64>(TITLE_ID, bk + 0x60);
+
+    quint8* header = data + fileHeader;
+    qToBigEndian<quint32>(DataBinCodec::FILE_MAGIC, header);
+    qToBigEndian<quint32>(entry.Size, header + 0x04);
+    header[0x08] = 0x35;
+    header[0x0A] = entry.Type;
+    strcpy((char*)header + 0x0B, "wiiking2.sav");
+    for (int i = 0; i < 16; i++)
+        header[0x50 + i] = quint8(i * 17);
+    memcpy(data + payload, save.constData(), save.size());
+
+    DataBinCodec codec;
+    if (!codec.encrypt(image))
+        return QByteArray();
+    return image;
+}
+
+static bool writeDataBin(const QString& path, const QByteArray& image)
+{
+    QFile file(path);
+    return !image.isEmpty() && file.open(QFile::WriteOnly) && file.write(image) == image.size();
+}
+
+void DataBinTest::init()
+{
+    m_path = QDir::temp().filePath(QString("wiiking2_databintest_%1.bin").arg(QCoreApplication::applicationPid()));
+}
+
+void DataBinTest::cleanup()
+{
+    QFile::remove(m_path);
+}
+
+// The title has to come from the file, not from the region's default
+void DataBinTest::bannerTitle()
+{
+    QVERIFY(writeDataBin(m_path, buildDataBin("Test Title", "Test Subtitle")));
+
+    SkywardSwordFile save(m_path);
+    QVERIFY2(save.isOpen(), qPrintable(save.lastError()));
+    QCOMPARE(int(save.region()), int(SkywardSwordFile::NTSCURegion));
+    QCOMPARE(save.bannerTitle(), QString("Test Title"));
+    QCOMPARE(save.bannerSubtitle(), QString("Test Subtitle"));
+}
+
+void DataBinTest::bannerImages()
+{
+    QVERIFY(writeDataBin(m_path, buildDataBin("Test Title", "Test Subtitle")));
+
+    SkywardSwordFile save(m_path);
+    QVERIFY2(save.isOpen(), qPrintable(save.lastError()));
+    QImage icon = save.icon().pixmap(DataBinReader::ICON_WIDTH, DataBinReader::ICON_HEIGHT).toImage();
+    QCOMPARE(icon.size(), QSize(DataBinReader::ICON_WIDTH, DataBinReader::ICON_HEIGHT));
+    QCOMPARE(QColor(icon.pixel(0, 0)), QColor(Qt::white));
+    QCOMPARE(save.banner().size(), QSize(DataBinReader::BANNER_WIDTH, DataBinReader::BANNER_HEIGHT));
+}
+
+QTEST_MAIN(DataBinTest)
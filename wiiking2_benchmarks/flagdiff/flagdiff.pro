@@ -0,0 +1,27 @@
+#-------------------------------------------------
+#
+# Rankings of FlagDiffAnalyzer
+#
+#-------------------------------------------------
+
+QT = core testlib
+
+CONFIG += console
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS = -O2 -std=c++0x
+
+TEMPLATE = app
+unix:TARGET =../../wiiking2_flagdifftest.x86_64
+INCLUDEPATH += ./include \
+           ../../wiiking2_editor/include
+
+SOURCES += \
+    src/flagdifftest.cpp \
+    ../../wiiking2_editor/src/flagdiffanalyzer.cpp
+
+HEADERS += \
+    include/flagdifftest.h \
+    ../../wiiking2_editor/include/flagdiffanalyzer.h \
+    ../../wiiking2_editor/include/bitops.h \
+    ../../wiiking2_editor/include/slotlayout.h
@@ -0,0 +1,67 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+
+#include "flagdifftest.h"
+#include "flagdiffanalyzer.h"
+#include "slotlayout.h"
+
+#include <QtTest>
+
+static const int FLAG_OFFSET = 0x0A20;  // Slot relative, 8 byte aligned
+
+static QByteArray flipped(const QByteArray& save, const QList<int>& slots, quint8 mask)
+{
+    QByteArray result = save;
+    foreach (int slot, slots)
+        result[SaveLayout::slotOffset(slot) + FLAG_OFFSET] = char(result[SaveLayout::slotOffset(slot) + FLAG_OFFSET] ^ mask);
+    return result;
+}
+
+void FlagDiffTest::fileOffsets()
+{
+    QByteArray save(SaveLayout::SIZE, 0);
+    FlagDiffAnalyzer analyzer;
+    QVERIFY(analyzer.addPair("event", save, flipped(save, QList<int>() << 1, 0x04)));
+    QVERIFY(analyzer.addPair("other", save, save));
+
+    QList<FlagDiffAnalyzer::Candidate> ranking = analyzer.ranking("event");
+    QCOMPARE(ranking.size(), 1);
+    QCOMPARE(ranking[0].Offset, quint32(SaveLayout::slotOffset(1) + FLAG_OFFSET));
+    QCOMPARE(ranking[0].Mask, quint8(0x04));
+    QCOMPARE(ranking[0].Hits, quint32(1));
+    QCOMPARE(ranking[0].Score, 1.0);
+}
+
+// The same bit flipped in two slots of one pair is one hit, not two
+void FlagDiffTest::slotRelative()
+{
+    QByteArray save(SaveLayout::SIZE, 0);
+    FlagDiffAnalyzer analyzer;
+    analyzer.setSlotRelative(true);
+    QVERIFY(analyzer.addPair("event", save, flipped(save, QList<int>() << 0 << 1, 0x04)));
+    QVERIFY(analyzer.addPair("event", save, flipped(save, QList<int>() << 2, 0x04)));
+    QVERIFY(analyzer.addPair("other", save, save));
+
+    QList<FlagDiffAnalyzer::Candidate> ranking = analyzer.ranking("event");
+    QCOMPARE(ranking.size(), 1);
+    QCOMPARE(ranking[0].Offset, quint32(FLAG_OFFSET));
+    QCOMPARE(ranking[0].Mask, quint8(0x04));
+    QCOMPARE(ranking[0].Hits, quint32(2));
+    QCOMPARE(ranking[0].Pairs, quint32(2));
+    QCOMPARE(ranking[0].Score, 1.0);
+}
+
+QTEST_APPLESS_MAIN(FlagDiffTest)
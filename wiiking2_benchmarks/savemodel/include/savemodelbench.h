@@ -0,0 +1,54 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef SAVEMODELBENCH_H
+#define SAVEMODELBENCH_H
+
+#include <QObject>
+#include <QByteArray>
+
+class SkywardSwordFile;
+
+// QBENCHMARK cases for the code every edit goes through: the checksums,
+// the accessor families of SkywardSwordFile, slot copies, banner decoding
+// and the hex editor's byte array. The input is save 0 of the generated
+// corpus (SaveGenerator) with BENCH_SEED, so runs are comparable.
+class SaveModelBench : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void crc32_data();
+    void crc32();
+    void checksum16_data();
+    void checksum16();
+    void convertTextureToImage_data();
+    void convertTextureToImage();
+    void accessor_data();
+    void accessor();
+    void updateChecksum();
+    void gameData();
+    void setGameData();
+    void xByteArray_data();
+    void xByteArray();
+
+private:
+    QByteArray        m_save;
+    SkywardSwordFile* m_file;
+};
+
+#endif // SAVEMODELBENCH_H
@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Microbenchmarks for the save model hot paths
+#
+#-------------------------------------------------
+
+include(../benchmarks.pri)
+
+unix:TARGET =../../wiiking2_savemodelbench.x86_64
+INCLUDEPATH += ./include
+
+SOURCES += \
+    src/savemodelbench.cpp
+
+HEADERS += \
+    include/savemodelbench.h
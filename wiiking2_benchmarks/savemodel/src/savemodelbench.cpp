@@ -0,0 +1,277 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "savemodelbench.h"
+#include "checksum.h"
+#include "common.h"
+#include "savegenerator.h"
+#include "skywardswordfile.h"
+#include "qhexedit2/xbytearray.h"
+
+#include <QtTest>
+
+static const quint64 BENCH_SEED = 0;
+
+static volatile quint32 sink;
+
+typedef void (*Accessor)(SkywardSwordFile& file, int i);
+
+static void flagRead(SkywardSwordFile& file, int)
+{
+    sink += file.sword(SkywardSwordFile::MasterSword);
+}
+
+static void flagWrite(SkywardSwordFile& file, int i)
+{
+    file.setSword(SkywardSwordFile::MasterSword, i & 1);
+}
+
+static void quantityRead(SkywardSwordFile& file, int)
+{
+    sink += file.bugQuantity(SkywardSwordFile::HornetBug);
+}
+
+static void quantityWrite(SkywardSwordFile& file, int i)
+{
+    file.setBugQuantity(SkywardSwordFile::HornetBug, i % 100);
+}
+
+static void ammoRead(SkywardSwordFile& file, int)
+{
+    sink += file.ammo(SkywardSwordFile::BombAmmo);
+}
+
+static void ammoWrite(SkywardSwordFile& file, int i)
+{
+    file.setAmmo(SkywardSwordFile::BombAmmo, i % 100);
+}
+
+static void vector3Read(SkywardSwordFile& file, int)
+{
+    sink += quint32(file.playerPosition().X);
+}
+
+static void vector3Write(SkywardSwordFile& file, int i)
+{
+    file.setPlayerPosition(float(i), 0.0f, 0.0f);
+}
+
+static void nameRead(SkywardSwordFile& file, int)
+{
+    sink += file.playerName().size();
+}
+
+static void nameWrite(SkywardSwordFile& file, int i)
+{
+    file.setPlayerName((i & 1) ? "Link" : "Zelda");
+}
+
+struct AccessorBench
+{
+    const char* Name;
+    Accessor    Function;
+};
+
+static const AccessorBench ACCESSORS[] =
+{
+    { "flag read",      flagRead },
+    { "flag write",     flagWrite },
+    { "quantity read",  quantityRead },
+    { "quantity write", quantityWrite },
+    { "ammo read",      ammoRead },
+    { "ammo write",     ammoWrite },
+    { "Vector3 read",   vector3Read },
+    { "Vector3 write",  vector3Write },
+    { "name read",      nameRead },
+    { "name write",     nameWrite },
+};
+
+enum XByteArrayOperation
+{
+    InsertRemove,
+    Replace,
+    DataChanged,
+    ToText
+};
+
+void SaveModelBench::initTestCase()
+{
+    m_save = SaveGenerator(BENCH_SEED).generate(0);
+
+    m_file = new SkywardSwordFile(SkywardSwordFile::NTSCURegion);
+    char* data = new char[m_save.size()];
+    memcpy(data, m_save.constData(), m_save.size());
+    m_file->setData(data);
+    m_file->setGame(SkywardSwordFile::Game1);
+}
+
+void SaveModelBench::cleanupTestCase()
+{
+    delete m_file;
+    m_file = NULL;
+}
+
+void SaveModelBench::crc32_data()
+{
+    QTest::addColumn<int>("offset");
+    QTest::addColumn<int>("length");
+
+    QTest::newRow("64 bytes")   << 0x20 << 64;
+    QTest::newRow("slot")       << 0x20 << 0x53BC;
+    QTest::newRow("whole file") << 0    << m_save.size();
+}
+
+void SaveModelBench::crc32()
+{
+    QFETCH(int, offset);
+    QFETCH(int, length);
+
+    Checksum checksum;
+    const quint8* data = (const quint8*)m_save.constData();
+    QBENCHMARK
+    {
+        sink += checksum.CRC32(data, offset, length);
+    }
+}
+
+void SaveModelBench::checksum16_data()
+{
+    crc32_data();
+}
+
+void SaveModelBench::checksum16()
+{
+    QFETCH(int, offset);
+    QFETCH(int, length);
+
+    Checksum checksum;
+    const quint8* data = (const quint8*)m_save.constData();
+    QBENCHMARK
+    {
+        sink += checksum.checksum16(data, offset, length);
+    }
+}
+
+void SaveModelBench::convertTextureToImage_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+
+    QTest::newRow("icon")   << 48  << 48;
+    QTest::newRow("banner") << 192 << 64;
+}
+
+void SaveModelBench::convertTextureToImage()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+
+    // RGB5A3 texels, two bytes each, the save bytes are as good as any
+    QByteArray texture = m_save.left(width * height * 2);
+    QBENCHMARK
+    {
+        sink += ::convertTextureToImage(texture, width, height).width();
+    }
+}
+
+void SaveModelBench::accessor_data()
+{
+    QTest::addColumn<int>("accessor");
+
+    for (unsigned i = 0; i < sizeof(ACCESSORS) / sizeof(ACCESSORS[0]); i++)
+        QTest::newRow(ACCESSORS[i].Name) << int(i);
+}
+
+void SaveModelBench::accessor()
+{
+    QFETCH(int, accessor);
+
+    Accessor function = ACCESSORS[accessor].Function;
+    int i = 0;
+    QBENCHMARK
+    {
+        function(*m_file, i++);
+    }
+}
+
+void SaveModelBench::updateChecksum()
+{
+    int i = 0;
+    QBENCHMARK
+    {
+        // setTotalHP leaves the checksum alone, so every call has work to do
+        m_file->setTotalHP(i++ % 81);
+        m_file->updateChecksum();
+    }
+}
+
+void SaveModelBench::gameData()
+{
+    QBENCHMARK
+    {
+        sink += m_file->gameData().size();
+    }
+}
+
+void SaveModelBench::setGameData()
+{
+    QByteArray slot = m_file->gameData();
+    QBENCHMARK
+    {
+        m_file->setGameData(slot);
+    }
+}
+
+void SaveModelBench::xByteArray_data()
+{
+    QTest::addColumn<int>("operation");
+
+    QTest::newRow("insert and remove") << int(InsertRemove);
+    QTest::newRow("replace")           << int(Replace);
+    QTest::newRow("dataChanged")       << int(DataChanged);
+    QTest::newRow("toText")            << int(ToText);
+}
+
+void SaveModelBench::xByteArray()
+{
+    QFETCH(int, operation);
+
+    XByteArray data;
+    data.setData(m_save);
+    int size = data.size();
+    int i = 0;
+    QBENCHMARK
+    {
+        switch (operation)
+        {
+            case InsertRemove:
+                data.insert(size / 2, char(i++));
+                data.remove(size / 2, 1);
+                break;
+            case Replace:
+                data.replace(i % size, char(i));
+                i++;
+                break;
+            case DataChanged:
+                sink += data.dataChanged(0, size).size();
+                break;
+            case ToText:
+                sink += data.toText(HexDumpFormatter::HexDump).size();
+                break;
+        }
+    }
+}
+
+QTEST_MAIN(SaveModelBench)
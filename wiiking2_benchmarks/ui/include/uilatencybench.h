@@ -0,0 +1,68 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef UILATENCYBENCH_H
+#define UILATENCYBENCH_H
+
+#include <QObject>
+#include <QVector>
+#include <QWidget>
+
+class MainWindow;
+
+// Opens a save in the real MainWindow and replays scripted input through
+// QTest, timing every action from the input event until the window has
+// painted again. Every row reports the median latency as its QTest result
+// and prints p50/p99/max and the time spent in MainWindow::updateInfo and
+// QHexEditPrivate::paintEvent as one key=value line. Actions which paint
+// nothing within a second are reported as missed and left out of the
+// percentiles.
+//
+// WIIKING2_SAVE        save to open, otherwise one is generated (SaveGenerator)
+// WIIKING2_UI_STEPS    actions measured per row, 200 by default
+//
+// Needs a display, or QT_QPA_PLATFORM=offscreen with Qt 5.
+class UiLatencyBench : public QObject
+{
+    Q_OBJECT
+public:
+    enum Action
+    {
+        CheckBoxToggle,
+        SpinBoxStep,
+        NameTyping,
+        HexTyping,
+        SlotSwitch
+    };
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void action_data();
+    void action();
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event);
+
+private:
+    void prepare(Action action);
+    void step(Action action, int i);
+
+    MainWindow*       m_window;
+    QVector<QWidget*> m_targets;            //!< Widgets the current row sends input to
+    bool              m_painted;
+};
+
+#endif // UILATENCYBENCH_H
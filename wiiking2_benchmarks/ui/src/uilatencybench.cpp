@@ -0,0 +1,265 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "uilatencybench.h"
+#include "mainwindow.h"
+#include "phasetimer.h"
+#include "savegenerator.h"
+#include "savetemplate.h"
+#include "skywardswordfile.h"
+#include "qhexedit2/qhexedit.h"
+
+#include <QAction>
+#include <QApplication>
+#include <QCheckBox>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLineEdit>
+#include <QSpinBox>
+#include <QTabWidget>
+#include <QtTest>
+#include <algorithm>
+
+static const int DEFAULT_STEPS   = 200;
+static const int WARMUP_STEPS    = 10;
+static const int OPEN_TIMEOUT    = 10000;   // ms
+static const int REPAINT_TIMEOUT = 1000;    // ms, actions which paint nothing end here
+
+static int envNumber(const char* name, int defaultValue)
+{
+    bool ok = false;
+    int value = qgetenv(name).toInt(&ok);
+    return (ok && value > 0) ? value : defaultValue;
+}
+
+static double percentileMs(const QVector<qint64>& sorted, int percent)
+{
+    if (sorted.isEmpty())
+        return 0.0;
+    return sorted[(sorted.size() - 1) * percent / 100] / 1e6;
+}
+
+void UiLatencyBench::initTestCase()
+{
+    m_window = NULL;
+    m_painted = false;
+
+    QString path = QString::fromLocal8Bit(qgetenv("WIIKING2_SAVE"));
+    if (path.isEmpty())
+    {
+        QDir temp(QDir::temp().filePath("wiiking2_uibench"));
+        QVERIFY(temp.mkpath("."));
+        path = temp.filePath("wiiking2.sav");
+        QFile file(path);
+        QVERIFY(file.open(QFile::WriteOnly));
+        QVERIFY(file.write(SaveGenerator().generate(0)) == SaveTemplate::SAVE_SIZE);
+    }
+
+    // The editor's settings, for the preferences it restores
+    QCoreApplication::setOrganizationName("WiiKing2");
+    QCoreApplication::setApplicationName("WiiKing2 Editor");
+
+    m_window = new MainWindow;
+    m_window->show();
+#if QT_VERSION >= 0x050000
+    QVERIFY(QTest::qWaitForWindowExposed(m_window));
+#else
+    QTest::qWaitForWindowShown(m_window);
+#endif
+
+    m_window->openFile(path);
+    QElapsedTimer timer;
+    timer.start();
+    while (!m_window->gameFile() && timer.elapsed() < OPEN_TIMEOUT)
+        QTest::qWait(10);
+    QVERIFY2(m_window->gameFile(), qPrintable("Could not open " + path));
+
+    qApp->installEventFilter(this);
+}
+
+void UiLatencyBench::cleanupTestCase()
+{
+    qApp->removeEventFilter(this);
+    // Deleted without closing, closing would ask to save the edits
+    delete m_window;
+    m_window = NULL;
+}
+
+bool UiLatencyBench::eventFilter(QObject* watched, QEvent* event)
+{
+    if (event->type() == QEvent::Paint && watched->isWidgetType()
+            && m_window && m_window->isAncestorOf(static_cast<QWidget*>(watched)))
+        m_painted = true;
+    return false;
+}
+
+void UiLatencyBench::action_data()
+{
+    QTest::addColumn<int>("action");
+
+    QTest::newRow("checkbox toggle") << int(CheckBoxToggle);
+    QTest::newRow("spinbox step")    << int(SpinBoxStep);
+    QTest::newRow("name typing")     << int(NameTyping);
+    QTest::newRow("hex typing")      << int(HexTyping);
+    QTest::newRow("slot switch")     << int(SlotSwitch);
+}
+
+// Brings the row's tab up and collects the widgets it sends input to
+void UiLatencyBench::prepare(Action action)
+{
+    QTabWidget* tabs = m_window->findChild<QTabWidget*>("tabWidget");
+    m_targets.clear();
+    switch (action)
+    {
+        case CheckBoxToggle:
+        {
+            QWidget* tab = m_window->findChild<QWidget*>("equipmentTab");
+            tabs->setCurrentWidget(tab);
+            foreach (QCheckBox* box, tab->findChildren<QCheckBox*>())
+                if (box->isEnabled() && box->isVisible())
+                    m_targets << box;
+            break;
+        }
+        case SpinBoxStep:
+        {
+            QWidget* tab = m_window->findChild<QWidget*>("playerTab");
+            tabs->setCurrentWidget(tab);
+            foreach (QSpinBox* box, tab->findChildren<QSpinBox*>())
+                if (box->isEnabled() && box->isVisible())
+                    m_targets << box;
+            break;
+        }
+        case NameTyping:
+        {
+            tabs->setCurrentWidget(m_window->findChild<QWidget*>("playerTab"));
+            QLineEdit* edit = m_window->findChild<QLineEdit*>("nameLineEdit");
+            edit->setFocus();
+            edit->end(false);
+            m_targets << edit;
+            break;
+        }
+        case HexTyping:
+        {
+            tabs->setCurrentWidget(m_window->findChild<QWidget*>("hexEditorTab"));
+            QHexEdit* edit = m_window->findChild<QHexEdit*>();
+            edit->setFocus();
+            edit->setCursorPosition(0);
+            // the keys go to the private widget doing the painting
+            QApplication::processEvents();
+            m_targets << QApplication::focusWidget();
+            break;
+        }
+        case SlotSwitch:
+            break;
+    }
+    QApplication::processEvents();
+}
+
+void UiLatencyBench::step(Action action, int i)
+{
+    switch (action)
+    {
+        case CheckBoxToggle:
+            QTest::mouseClick(m_targets[i % m_targets.size()], Qt::LeftButton);
+            break;
+        case SpinBoxStep:
+        {
+            // up then down again, so the values stay in range; the arrow
+            // keys step the same way the wheel does
+            QWidget* box = m_targets[(i / 2) % m_targets.size()];
+            box->setFocus();
+            QTest::keyClick(box, (i & 1) ? Qt::Key_Down : Qt::Key_Up);
+            break;
+        }
+        case NameTyping:
+        {
+            // eight letters, then eight backspaces
+            if ((i % 16) < 8)
+                QTest::keyClick(m_targets[0], char('a' + i % 26));
+            else
+                QTest::keyClick(m_targets[0], Qt::Key_Backspace);
+            break;
+        }
+        case HexTyping:
+            QTest::keyClick(m_targets[0], "0123456789abcdef"[i % 16]);
+            break;
+        case SlotSwitch:
+        {
+            QAction* game = m_window->findChild<QAction*>(QString("actionGame%1").arg(i % 3 + 1));
+            game->trigger();
+            break;
+        }
+    }
+}
+
+void UiLatencyBench::action()
+{
+    QFETCH(int, action);
+
+    prepare((Action)action);
+    QVERIFY2(action == SlotSwitch || !m_targets.isEmpty(), "Nothing to send input to");
+
+    for (int i = 0; i < WARMUP_STEPS; i++)
+    {
+        step((Action)action, i);
+        QApplication::processEvents();
+    }
+
+    int steps = envNumber("WIIKING2_UI_STEPS", DEFAULT_STEPS);
+    QVector<qint64> latencies;
+    latencies.reserve(steps);
+    int missed = 0;
+    QElapsedTimer timer;
+    PhaseTimer::reset();
+    PhaseTimer::setEnabled(true);
+    for (int i = 0; i < steps; i++)
+    {
+        m_painted = false;
+        timer.start();
+        step((Action)action, WARMUP_STEPS + i);
+        while (!m_painted && timer.elapsed() < REPAINT_TIMEOUT)
+            QApplication::processEvents(QEventLoop::AllEvents);
+        if (!m_painted)
+        {
+            missed++;
+            continue;
+        }
+
+        // The filter sees the Paint before the widget handles it, the clock
+        // stops once that paint and whatever it posted have run
+        QApplication::sendPostedEvents();
+        QApplication::processEvents(QEventLoop::AllEvents);
+        latencies << timer.nsecsElapsed();
+    }
+    PhaseTimer::setEnabled(false);
+
+    // Missed steps only count in missed, a timeout is not a latency
+    QVector<qint64> sorted = latencies;
+    std::sort(sorted.begin(), sorted.end());
+    qDebug("action=%s steps=%d missed=%d p50_ms=%.3f p99_ms=%.3f max_ms=%.3f "
+           "updateinfo_ms=%.3f hexpaint_ms=%.3f",
+           QTest::currentDataTag(), steps, missed,
+           percentileMs(sorted, 50), percentileMs(sorted, 99), sorted.isEmpty() ? 0.0 : sorted.last() / 1e6,
+           PhaseTimer::elapsed(PhaseTimer::UpdateInfoPhase) / 1e6 / steps,
+           PhaseTimer::elapsed(PhaseTimer::HexPaintPhase) / 1e6 / steps);
+
+    // e.g. a spin box already at its maximum
+    if (missed > 0)
+        qWarning("%d actions did not repaint the window", missed);
+    QTest::setBenchmarkResult(percentileMs(sorted, 50), QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(UiLatencyBench)
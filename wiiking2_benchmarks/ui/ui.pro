@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# Input to repaint latency of the main window
+#
+#-------------------------------------------------
+
+include(../common.pri)
+
+unix:TARGET =../../wiiking2_uibench.x86_64
+INCLUDEPATH += ./include
+
+include(../../wiiking2_editor/wiiking2_gui.pri)
+
+SOURCES += \
+    src/uilatencybench.cpp
+
+HEADERS += \
+    include/uilatencybench.h
@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# Benchmarks, one QTest program each
+#
+#   savemodel   microbenchmarks of the save model hot paths
+#   cycle       open, edit and save cycles over a corpus
+#   ui          input to repaint latency of the main window
+#   crypto      known-answer tests for the AES and ECDSA code
+#   databin     loading data.bin files through SkywardSwordFile
+#   flagdiff    rankings of FlagDiffAnalyzer
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS = savemodel \
+          cycle \
+          ui \
+          crypto \
+          databin \
+          flagdiff
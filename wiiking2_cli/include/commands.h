@@ -0,0 +1,53 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+#include <QStringList>
+#include <QTextStream>
+
+// Every command gets the arguments following its name and returns the
+// process exit code.
+typedef int (*CommandFunc)(QStringList args);
+
+struct Command
+{
+    const char* Name;
+    CommandFunc Func;
+    const char* Usage;
+    const char* Description;
+};
+
+// Helpers shared by the commands, see main.cpp
+QTextStream& out();
+QTextStream& err();
+bool    takeFlag(QStringList& args, const QString& name);
+QString takeOption(QStringList& args, const QString& name, const QString& defaultValue = QString());
+int     usageError(const char* command);
+// "NTSCU", "NTSCJ" or "PAL" to a SaveLayout::Region
+bool    regionFromName(const QString& name, quint32* region);
+
+int flagDiffCommand(QStringList args);
+int aesBenchCommand(QStringList args);
+int resignCommand(QStringList args);
+int infoCommand(QStringList args);
+int convertCommand(QStringList args);
+int fieldBenchCommand(QStringList args);
+int slotCommand(QStringList args);
+int newCommand(QStringList args);
+int generateCommand(QStringList args);
+
+#endif // COMMANDS_H
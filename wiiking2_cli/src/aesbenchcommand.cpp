@@ -0,0 +1,153 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <string.h>
+
+#include "commands.h"
+#include "aes128.h"
+#include "databincodec.h"
+
+// FIPS-197 appendix C.1
+static bool knownAnswer(Aes128::Backend backend)
+{
+    static const quint8 expected[16] =
+    {
+        0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+        0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A
+    };
+    quint8 key[16], block[16], iv[16];
+    for (int i = 0; i < 16; i++)
+    {
+        key[i] = quint8(i);
+        block[i] = quint8(i * 0x11);
+    }
+
+    Aes128 aes(key);
+    aes.setBackend(backend);
+    memset(iv, 0, sizeof(iv));
+    aes.encryptCbc(block, block, sizeof(block), iv);
+    return memcmp(block, expected, sizeof(block)) == 0;
+}
+
+// The buffer is a single QByteArray, its size has to fit an int
+static const int MAX_MEGABYTES = 1024;
+
+static double megabytesPerSecond(qint64 bytes, qint64 nsecs)
+{
+    return nsecs > 0 ? (bytes / (1024.0 * 1024.0)) / (nsecs / 1e9) : 0.0;
+}
+
+int aesBenchCommand(QStringList args)
+{
+    bool ok = true;
+    int megabytes = takeOption(args, "--size", "64").toInt(&ok);
+    if (!ok || megabytes <= 0 || megabytes > MAX_MEGABYTES)
+        return usageError("aesbench");
+
+    QList<Aes128::Backend> backends;
+    backends << Aes128::PortableBackend;
+    if (Aes128::isSupported(Aes128::AesNiBackend))
+        backends << Aes128::AesNiBackend;
+    out() << "Best backend: " << Aes128::backendName(Aes128::bestBackend()) << endl;
+
+    int failures = 0;
+    foreach (Aes128::Backend backend, backends)
+    {
+        if (!knownAnswer(backend))
+        {
+            err() << Aes128::backendName(backend) << " fails the FIPS-197 test vector" << endl;
+            failures++;
+        }
+    }
+
+    QByteArray buffer(megabytes * 1024 * 1024, 'Z');
+    quint8* data = (quint8*)buffer.data();
+    QByteArray reference;
+    QElapsedTimer timer;
+    foreach (Aes128::Backend backend, backends)
+    {
+        Aes128 aes;
+        aes.setBackend(backend);
+        quint8 iv[Aes128::BLOCK_SIZE];
+
+        memset(iv, 0, sizeof(iv));
+        timer.start();
+        aes.encryptCbc(data, data, buffer.size(), iv);
+        qint64 encryptTime = timer.nsecsElapsed();
+
+        // every backend has to produce the same ciphertext
+        if (reference.isEmpty())
+            reference = buffer;
+        else if (buffer != reference)
+        {
+            err() << Aes128::backendName(backend) << " disagrees with the portable backend" << endl;
+            failures++;
+        }
+
+        memset(iv, 0, sizeof(iv));
+        timer.start();
+        aes.decryptCbc(data, data, buffer.size(), iv);
+        qint64 decryptTime = timer.nsecsElapsed();
+
+        out() << QString(Aes128::backendName(backend)).leftJustified(9)
+              << " encrypt " << QString::number(megabytesPerSecond(buffer.size(), encryptTime), 'f', 1).rightJustified(8)
+              << " MB/s  decrypt " << QString::number(megabytesPerSecond(buffer.size(), decryptTime), 'f', 1).rightJustified(8)
+              << " MB/s" << endl;
+    }
+
+    foreach (const QString& path, args)
+    {
+        QFile file(path);
+        if (!file.open(QFile::ReadOnly))
+        {
+            err() << "Unable to open " << path << endl;
+            failures++;
+            continue;
+        }
+        QByteArray original = file.readAll();
+        file.close();
+
+        foreach (Aes128::Backend backend, backends)
+        {
+            DataBinCodec codec;
+            codec.setBackend(backend);
+            QByteArray bin = original;
+            timer.start();
+            bool decrypted = codec.decrypt(bin);
+            qint64 decryptTime = timer.nsecsElapsed();
+            timer.start();
+            bool encrypted = decrypted && codec.encrypt(bin);
+            qint64 encryptTime = timer.nsecsElapsed();
+
+            if (!encrypted)
+            {
+                err() << path << ": " << codec.errorString() << endl;
+                failures++;
+                break;
+            }
+            if (bin != original)
+            {
+                err() << path << ": round trip changed the file" << endl;
+                failures++;
+            }
+            out() << path << " (" << Aes128::backendName(backend) << ", " << codec.files().size() << " files)"
+                  << " decrypt " << decryptTime / 1000 << " us, encrypt " << encryptTime / 1000 << " us" << endl;
+        }
+    }
+
+    return failures == 0 ? 0 : 2;
+}
@@ -0,0 +1,91 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include <QElapsedTimer>
+
+#include "commands.h"
+#include "convertpipeline.h"
+#include "wiikeys.h"
+
+int convertCommand(QStringList args)
+{
+    bool toSav = takeFlag(args, "--to-sav");
+    bool toBin = takeFlag(args, "--to-bin");
+    QString keysFile = takeOption(args, "--keys");
+    QByteArray mac = QByteArray::fromHex(takeOption(args, "--mac").toLatin1());
+    QStringList templates;
+    QString file;
+    while (!(file = takeOption(args, "--template")).isEmpty())
+        templates << file;
+    bool ok[4] = { true, true, true, true };
+    int readers = takeOption(args, "--readers", "2").toInt(&ok[0]);
+    int workers = takeOption(args, "--workers", "0").toInt(&ok[1]);
+    int queue = takeOption(args, "--queue", "32").toInt(&ok[2]);
+    if (args.size() != 2 || toSav == toBin || !ok[0] || !ok[1] || !ok[2])
+        return usageError("convert");
+
+    ConvertPipeline pipeline(toBin ? ConvertPipeline::SavToDataBin : ConvertPipeline::DataBinToSav);
+    pipeline.setReaderThreads(readers);
+    pipeline.setWorkerThreads(workers);
+    pipeline.setQueueCapacity(queue);
+
+    if (toBin)
+    {
+        quint32    ngId;
+        quint32    ngKeyId;
+        QByteArray ngPriv;
+        QByteArray ngSig;
+        if (mac.size() != 6 || templates.isEmpty())
+            return usageError("convert");
+        if (!WiiKeys::readKeysFile(keysFile, &ngId, &ngKeyId, &ngPriv, &ngSig))
+        {
+            err() << keysFile << " is not a BootMii keys.bin" << endl;
+            return 1;
+        }
+        pipeline.setSigningContext(SigningContext::cached(ngId, ngKeyId, ngPriv, ngSig, mac));
+
+        foreach (const QString& dataBin, templates)
+        {
+            QString error;
+            if (!pipeline.addTemplate(dataBin, &error))
+            {
+                err() << error << endl;
+                return 1;
+            }
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    bool result = pipeline.run(args[0], args[1]);
+    qint64 runTime = timer.elapsed();
+
+    foreach (const QString& error, pipeline.errors())
+        err() << error << endl;
+
+    out() << "Converted " << pipeline.converted() << " files and copied " << pipeline.duplicates()
+          << " duplicates in " << runTime << " ms" << endl;
+    foreach (const ConvertPipeline::StageStats& stage, pipeline.stats())
+    {
+        double wallMs = stage.WallNs / 1e6;
+        out() << "  " << stage.Name.leftJustified(8) << stage.Items << " items, "
+              << QString::number(wallMs > 0 ? stage.Items * 1000.0 / wallMs : 0.0, 'f', 1) << " files/s, "
+              << QString::number(wallMs > 0 ? stage.BusyNs / 1e6 / (wallMs * stage.Threads) * 100.0 : 0.0, 'f', 0)
+              << "% busy on " << stage.Threads << " threads, queue max " << stage.MaxQueueDepth
+              << " avg " << QString::number(stage.AverageQueueDepth, 'f', 1) << endl;
+    }
+
+    return result && pipeline.errors().isEmpty() ? 0 : 2;
+}
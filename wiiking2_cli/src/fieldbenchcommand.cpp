@@ -0,0 +1,189 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include <QElapsedTimer>
+#include <QtEndian>
+
+#include "commands.h"
+#include "beview.h"
+#include "savegenerator.h"
+#include "slotlayout.h"
+
+typedef BEField<quint16, offsetof(SlotLayout, rupees)>         RupeesField;
+typedef BEField<Vector3, offsetof(SlotLayout, playerPosition)> PositionField;
+
+static const int RUPEES   = offsetof(SlotLayout, rupees);
+static const int POSITION = offsetof(SlotLayout, playerPosition);
+static const int AMMO     = offsetof(SlotLayout, ammo);
+// The hornet and mantis quantities share a word, 7 bits each
+static const int PACKED   = offsetof(SlotLayout, bugQuantities) + 4 * sizeof(BEValue<quint16>);
+
+static volatile quint32 sink;
+
+static char* slotData(char* data, int i)
+{
+    return data + SaveLayout::slotOffset(i % SaveLayout::SLOT_COUNT);
+}
+
+// The casts the model used before BEView, kept for comparison
+static quint32 castRupees(char* data, int iterations)
+{
+    quint32 sum = 0;
+    for (int i = 0; i < iterations; i++)
+        sum += qFromBigEndian<quint16>(*(quint16*)(slotData(data, i) + RUPEES));
+    return sum;
+}
+
+static quint32 viewRupees(char* data, int iterations)
+{
+    quint32 sum = 0;
+    for (int i = 0; i < iterations; i++)
+        sum += BEView(slotData(data, i)).get<RupeesField>();
+    return sum;
+}
+
+static quint32 castPosition(char* data, int iterations)
+{
+    float sum = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        char* slot = slotData(data, i);
+        quint32 x = qFromBigEndian<quint32>(*(quint32*)(slot + POSITION));
+        quint32 y = qFromBigEndian<quint32>(*(quint32*)(slot + POSITION + 4));
+        quint32 z = qFromBigEndian<quint32>(*(quint32*)(slot + POSITION + 8));
+        Vector3 pos(*(float*)&x, *(float*)&y, *(float*)&z);
+        sum += pos.X + pos.Y + pos.Z;
+    }
+    return quint32(sum);
+}
+
+static quint32 viewPosition(char* data, int iterations)
+{
+    float sum = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        Vector3 pos = BEView(slotData(data, i)).get<PositionField>();
+        sum += pos.X + pos.Y + pos.Z;
+    }
+    return quint32(sum);
+}
+
+static quint32 castAmmo(char* data, int iterations)
+{
+    for (int i = 0; i < iterations; i++)
+    {
+        char* slot = slotData(data, i);
+        quint32 tmp = qFromBigEndian(*(quint32*)(slot + AMMO));
+        quint32 bombs = (((tmp >> 7) & 127) + 1) & 127;
+        *(quint32*)(slot + AMMO) = qToBigEndian((tmp & ~(127u << 7)) | (bombs << 7));
+    }
+    return qFromBigEndian(*(quint32*)(data + SaveLayout::slotOffset(0) + AMMO));
+}
+
+static quint32 viewAmmo(char* data, int iterations)
+{
+    for (int i = 0; i < iterations; i++)
+    {
+        BEView slot(slotData(data, i));
+        slot.set<BombAmmoField>(slot.get<BombAmmoField>() + 1);
+    }
+    return BEView(slotData(data, 0)).get<quint32>(AMMO);
+}
+
+static quint32 castPacked(char* data, int iterations)
+{
+    for (int i = 0; i < iterations; i++)
+    {
+        char* slot = slotData(data, i);
+        quint16 oldVal = qFromBigEndian<quint16>(*(quint16*)(slot + PACKED));
+        quint16 high = ((oldVal >> 7) + 1) & 127;
+        *(quint16*)(slot + PACKED) = qToBigEndian<quint16>((oldVal & ~(127 << 7)) | (high << 7));
+    }
+    return qFromBigEndian<quint16>(*(quint16*)(data + SaveLayout::slotOffset(0) + PACKED));
+}
+
+static quint32 viewPacked(char* data, int iterations)
+{
+    for (int i = 0; i < iterations; i++)
+    {
+        BEView slot(slotData(data, i));
+        slot.setPacked7(PACKED, true, slot.packed7(PACKED, true) + 1);
+    }
+    return BEView(slotData(data, 0)).get<quint16>(PACKED);
+}
+
+typedef quint32 (*Accessor)(char* data, int iterations);
+
+struct AccessorBench
+{
+    const char* Name;
+    Accessor    Cast;
+    Accessor    View;
+};
+
+static const AccessorBench BENCHES[] =
+{
+    { "quint16 read",       castRupees,   viewRupees },
+    { "Vector3 read",       castPosition, viewPosition },
+    { "7 bit field update", castAmmo,     viewAmmo },
+    { "packed pair update", castPacked,   viewPacked },
+};
+
+static double millionsPerSecond(int iterations, qint64 nsecs)
+{
+    return nsecs > 0 ? (iterations / 1e6) / (nsecs / 1e9) : 0.0;
+}
+
+int fieldBenchCommand(QStringList args)
+{
+    bool ok[2] = { true, true };
+    int iterations = takeOption(args, "--iterations", "50").toInt(&ok[0]) * 1000000;
+    quint64 seed = takeOption(args, "--seed", "0").toULongLong(&ok[1]);
+    if (!ok[0] || !ok[1] || iterations <= 0 || !args.isEmpty())
+        return usageError("fieldbench");
+
+    QByteArray castData = SaveGenerator(seed).generate(0);
+    QByteArray viewData = castData;
+
+    int failures = 0;
+    QElapsedTimer timer;
+    for (unsigned b = 0; b < sizeof(BENCHES) / sizeof(BENCHES[0]); b++)
+    {
+        const AccessorBench& bench = BENCHES[b];
+
+        timer.start();
+        quint32 castResult = bench.Cast(castData.data(), iterations);
+        qint64 castTime = timer.nsecsElapsed();
+
+        timer.start();
+        quint32 viewResult = bench.View(viewData.data(), iterations);
+        qint64 viewTime = timer.nsecsElapsed();
+        sink = castResult + viewResult;
+
+        // both have to read the same values and leave the same bytes
+        if (castResult != viewResult || castData != viewData)
+        {
+            err() << bench.Name << ": BEView disagrees with the casts" << endl;
+            failures++;
+        }
+
+        out() << QString(bench.Name).leftJustified(20)
+              << " cast " << QString::number(millionsPerSecond(iterations, castTime), 'f', 1).rightJustified(8)
+              << " M/s  view " << QString::number(millionsPerSecond(iterations, viewTime), 'f', 1).rightJustified(8)
+              << " M/s" << endl;
+    }
+
+    return failures == 0 ? 0 : 2;
+}
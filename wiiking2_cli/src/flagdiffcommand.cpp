@@ -0,0 +1,84 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "commands.h"
+#include "flagdiffanalyzer.h"
+
+int flagDiffCommand(QStringList args)
+{
+    bool slotRelative = takeFlag(args, "--slot-relative");
+    QString onlyLabel = takeOption(args, "--label");
+    bool ok = true;
+    int top = takeOption(args, "--top", "10").toInt(&ok);
+    if (args.size() != 1 || !ok)
+        return usageError("flagdiff");
+
+    QString error;
+    QList<FlagDiffAnalyzer::PairFile> files = FlagDiffAnalyzer::readPairList(args[0], &error);
+    if (!error.isEmpty())
+    {
+        err() << error << endl;
+        return 1;
+    }
+
+    FlagDiffAnalyzer analyzer;
+    analyzer.setSlotRelative(slotRelative);
+
+    QElapsedTimer timer;
+    timer.start();
+    QStringList errors;
+    int added = analyzer.addPairFiles(files, &errors);
+    qint64 loadTime = timer.elapsed();
+
+    foreach (const QString& e, errors)
+        err() << e << endl;
+
+    out() << "Loaded " << added << " of " << files.size() << " pairs in " << loadTime << " ms using "
+          << QThread::idealThreadCount() << " threads, "
+          << QString::number(analyzer.averageChangedBits(), 'f', 1) << " bits changed per pair" << endl;
+
+    QStringList labels = analyzer.labels();
+    if (!onlyLabel.isEmpty())
+    {
+        if (!labels.contains(onlyLabel))
+        {
+            err() << "No pairs with label \"" << onlyLabel << "\"" << endl;
+            return 1;
+        }
+        labels = QStringList() << onlyLabel;
+    }
+
+    timer.restart();
+    foreach (const QString& label, labels)
+    {
+        QList<FlagDiffAnalyzer::Candidate> ranking = analyzer.ranking(label, top);
+        out() << endl << label << " (" << analyzer.pairCount(label) << " pairs)" << endl;
+        out() << "  offset   mask  hits   other  score" << endl;
+        foreach (const FlagDiffAnalyzer::Candidate& c, ranking)
+        {
+            out() << "  0x" << QString::number(c.Offset, 16).toUpper().rightJustified(4, '0')
+                  << "   0x" << QString::number(c.Mask, 16).toUpper().rightJustified(2, '0')
+                  << "  " << QString("%1/%2").arg(c.Hits).arg(c.Pairs).leftJustified(6)
+                  << " " << QString::number(c.OtherHits).leftJustified(6)
+                  << " " << QString::number(c.Score, 'f', 3) << endl;
+        }
+    }
+    out() << endl << "Ranked " << labels.size() << " labels in " << timer.elapsed() << " ms" << endl;
+
+    return errors.isEmpty() ? 0 : 2;
+}
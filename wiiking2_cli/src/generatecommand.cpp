@@ -0,0 +1,71 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include <QElapsedTimer>
+
+#include "commands.h"
+#include "savegenerator.h"
+
+// "NTSCU:3,PAL:1" style region weights, every weight has to be positive
+static bool addRegions(SaveGenerator& generator, const QString& mix)
+{
+    foreach (const QString& part, mix.split(','))
+    {
+        QStringList pair = part.split(':');
+        bool ok = true;
+        int weight = pair.size() > 1 ? pair[1].toInt(&ok) : 1;
+        quint32 region;
+        if (!ok || weight <= 0 || pair.size() > 2 || !regionFromName(pair[0], &region))
+            return false;
+        generator.addRegion(region, weight);
+    }
+    return true;
+}
+
+int generateCommand(QStringList args)
+{
+    bool ok[4] = { true, true, true, true };
+    quint64 count = takeOption(args, "--count", "1000").toULongLong(&ok[0]);
+    quint64 seed = takeOption(args, "--seed", "0").toULongLong(&ok[1]);
+    int occupancy = takeOption(args, "--occupancy", "100").toInt(&ok[2]);
+    int threads = takeOption(args, "--threads", "0").toInt(&ok[3]);
+    QString regions = takeOption(args, "--regions", "NTSCU");
+    if (args.size() != 1 || !ok[0] || !ok[1] || !ok[2] || !ok[3] || occupancy < 0 || occupancy > 100)
+        return usageError("generate");
+
+    SaveGenerator generator(seed);
+    generator.setOccupancy(occupancy);
+    generator.setThreads(threads);
+    if (!addRegions(generator, regions))
+        return usageError("generate");
+
+    QElapsedTimer timer;
+    timer.start();
+    bool result = generator.run(args[0], count);
+    qint64 runTime = timer.elapsed();
+
+    foreach (const QString& error, generator.errors())
+        err() << error << endl;
+
+    double seconds = runTime / 1000.0;
+    out() << "Generated " << generator.written() << " saves with seed " << seed << " in " << runTime << " ms";
+    if (seconds > 0)
+        out() << " (" << QString::number(generator.written() / seconds, 'f', 0) << " saves/s)";
+    out() << endl;
+
+    if (generator.written() == 0 && count > 0)
+        return 1;
+    return result ? 0 : 2;
+}
@@ -0,0 +1,114 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include <QElapsedTimer>
+#include <QFile>
+
+#include "commands.h"
+#include "databinreader.h"
+#include "slotlayout.h"
+#include "wiitime.h"
+
+static void printSlots(const QByteArray& save)
+{
+    for (int slot = 0; slot < SaveLayout::SLOT_COUNT; slot++)
+    {
+        const SlotLayout* s = (const SlotLayout*)(save.constData() + SaveLayout::slotOffset(slot));
+        out() << "  slot " << slot + 1 << ": ";
+        if (s->newGame.get())
+        {
+            out() << "(new)" << endl;
+            continue;
+        }
+
+        ushort name[9];
+        for (int i = 0; i < 8; i++)
+            name[i] = s->playerName[i].get();
+        name[8] = 0;
+        quint64 seconds = s->playTime.get() / TICKS_PER_SECOND;
+        out() << QString::fromUtf16(name).leftJustified(9)
+              << QString("%1:%2:%3").arg(seconds / 3600).arg((seconds / 60) % 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'))
+              << endl;
+    }
+}
+
+static bool printDataBin(const QString& path, bool metadataOnly)
+{
+    DataBinReader reader(path);
+    if (!reader.open())
+    {
+        err() << path << ": " << reader.errorString() << endl;
+        return false;
+    }
+
+    out() << path << ": " << reader.gameId() << ", NG" << QString::number(reader.ngId(), 16).rightJustified(8, '0')
+          << ", MAC " << reader.macAddress().toHex() << endl;
+    foreach (const DataBinCodec::FileEntry& entry, reader.files())
+    {
+        out() << "  " << (entry.Type == 2 ? "dir  " : "file ") << entry.Name.leftJustified(16) << " "
+              << QString::number(entry.Size).rightJustified(7) << " bytes at 0x" << QString::number(entry.Offset, 16) << endl;
+    }
+    if (metadataOnly)
+        return true;
+
+    QByteArray save = reader.readFile("wiiking2.sav");
+    if (save.size() != SaveLayout::SIZE)
+    {
+        err() << path << ": no readable wiiking2.sav" << endl;
+        return false;
+    }
+    printSlots(save);
+    return true;
+}
+
+static bool printSave(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        err() << "Unable to open " << path << endl;
+        return false;
+    }
+    QByteArray save = file.readAll();
+    if (save.size() != SaveLayout::SIZE)
+    {
+        err() << path << ": not a wiiking2.sav" << endl;
+        return false;
+    }
+
+    out() << path << ": " << QString::fromLatin1(save.left(4)) << endl;
+    printSlots(save);
+    return true;
+}
+
+int infoCommand(QStringList args)
+{
+    bool metadataOnly = takeFlag(args, "--metadata");
+    if (args.isEmpty())
+        return usageError("info");
+
+    QElapsedTimer timer;
+    timer.start();
+    int failed = 0;
+    foreach (const QString& path, args)
+    {
+        bool ok = path.endsWith(".bin") ? printDataBin(path, metadataOnly) : printSave(path);
+        if (!ok)
+            failed++;
+    }
+    out() << endl << "Read " << args.size() - failed << " of " << args.size() << " files in " << timer.elapsed() << " ms" << endl;
+
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,157 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <stdio.h>
+
+#include "commands.h"
+#include "slotlayout.h"
+#include "tracer.h"
+
+static const Command COMMANDS[] =
+{
+    { "flagdiff", flagDiffCommand, "flagdiff <pairlist> [--slot-relative] [--label <label>] [--top <n>]",
+      "Ranks the bits which flip for each label of before/after save pairs" },
+    { "aesbench", aesBenchCommand, "aesbench [--size <1-1024 MiB>] [<data.bin>...]",
+      "Measures AES-128-CBC throughput per backend and times data.bin round trips" },
+    { "resign", resignCommand, "resign <keys.bin> --mac <hex> [--out <dir>] [--threads <n>] [--strict] <data.bin>...",
+      "Re-signs data.bin files with another console's keys, in parallel" },
+    { "info", infoCommand, "info [--metadata] <wiiking2.sav|data.bin>...",
+      "Lists region and slots; for data.bin only wiiking2.sav is decrypted, --metadata decrypts nothing" },
+    { "convert", convertCommand, "convert (--to-bin --keys <keys.bin> --mac <hex> --template <data.bin>... | --to-sav) [--readers <n>] [--workers <n>] [--queue <n>] <in-dir> <out-dir>",
+      "Converts a directory of saves to signed data.bin files or back, reporting throughput and queue depth per stage" },
+    { "fieldbench", fieldBenchCommand, "fieldbench [--iterations <millions>] [--seed <n>]",
+      "Compares BEView save field accessors against pointer casts" },
+    { "slot", slotCommand, "slot (copy|move|swap|duplicate) <wiiking2.sav> <slot> [<slot>] [--from-file <wiiking2.sav>] [--out <file>]",
+      "Copies, moves, swaps or duplicates adventure slots, their checksums are kept as they are" },
+    { "new", newCommand, "new [--region NTSCU|NTSCJ|PAL] [--count <files>] [--games <0-3>] [--name <player>] <out-dir>",
+      "Creates wiiking2.sav files from the prebuilt region and adventure templates" },
+    { "generate", generateCommand, "generate [--count <saves>] [--seed <n>] [--occupancy <percent>] [--regions NTSCU:3,PAL:1] [--threads <n>] <out-dir>",
+      "Writes a reproducible corpus of random, valid saves, the standard input for the benchmarks" },
+};
+
+static const int COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+
+QTextStream& out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream& err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+bool takeFlag(QStringList& args, const QString& name)
+{
+    return args.removeAll(name) > 0;
+}
+
+QString takeOption(QStringList& args, const QString& name, const QString& defaultValue)
+{
+    int idx = args.indexOf(name);
+    if (idx < 0 || idx + 1 >= args.size())
+        return defaultValue;
+
+    QString value = args[idx + 1];
+    args.removeAt(idx + 1);
+    args.removeAt(idx);
+    return value;
+}
+
+int usageError(const char* command)
+{
+    for (int i = 0; i < COMMAND_COUNT; i++)
+    {
+        if (qstrcmp(COMMANDS[i].Name, command) == 0)
+            err() << "usage: wiiking2_cli " << COMMANDS[i].Usage << endl;
+    }
+    return 1;
+}
+
+bool regionFromName(const QString& name, quint32* region)
+{
+    if (name == "NTSCU")
+        *region = SaveLayout::NTSCURegion;
+    else if (name == "NTSCJ")
+        *region = SaveLayout::NTSCJRegion;
+    else if (name == "PAL")
+        *region = SaveLayout::PALRegion;
+    else
+        return false;
+    return true;
+}
+
+static void printUsage()
+{
+    err() << "usage: wiiking2_cli <command> [arguments] [--trace <trace.json>]" << endl << endl;
+    for (int i = 0; i < COMMAND_COUNT; i++)
+    {
+        err() << "  " << COMMANDS[i].Usage << endl;
+        err() << "      " << COMMANDS[i].Description << endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    a.setOrganizationName("WiiKing2");
+    a.setApplicationName("WiiKing2 CLI");
+
+    QStringList args = a.arguments();
+    args.removeFirst();
+    if (args.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    // Any command can record a Chrome trace of its hot paths
+    QString tracePath = takeOption(args, "--trace");
+    Tracer::setEnabled(!tracePath.isEmpty());
+    if (args.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    QString name = args.takeFirst();
+    for (int i = 0; i < COMMAND_COUNT; i++)
+    {
+        if (name != COMMANDS[i].Name)
+            continue;
+
+        int result = COMMANDS[i].Func(args);
+        if (!tracePath.isEmpty())
+        {
+            Tracer::setEnabled(false);
+            if (!Tracer::save(tracePath))
+            {
+                err() << "Could not write " << tracePath << endl;
+                return qMax(result, 1);
+            }
+            err() << "Wrote " << Tracer::eventCount() << " trace events to " << tracePath << endl;
+        }
+        return result;
+    }
+
+    err() << "Unknown command \"" << name << "\"" << endl;
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,71 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+
+#include "commands.h"
+#include "savetemplate.h"
+#include "wiitime.h"
+
+int newCommand(QStringList args)
+{
+    QString regionName = takeOption(args, "--region", "NTSCU");
+    QString name = takeOption(args, "--name");
+    bool ok[2] = { true, true };
+    int count = takeOption(args, "--count", "1").toInt(&ok[0]);
+    int games = takeOption(args, "--games", "0").toInt(&ok[1]);
+    quint32 region;
+    if (args.size() != 1 || !ok[0] || !ok[1] || count < 1 || games < 0 || games > SaveTemplate::SLOT_COUNT ||
+        !regionFromName(regionName, &region))
+        return usageError("new");
+
+    QDir dir(args[0]);
+    if (!dir.mkpath("."))
+    {
+        err() << "Unable to create " << args[0] << endl;
+        return 1;
+    }
+
+    QByteArray save(SaveTemplate::SAVE_SIZE, '\0');
+    quint64 saveTime = toWiiTime(QDateTime::currentDateTime());
+    int width = QString::number(count).length();
+    int failed = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; i++)
+    {
+        SaveTemplate::createFile(save.data(), region);
+        // one second apart, so every adventure gets its own checksum
+        for (int game = 0; game < games; game++)
+            SaveTemplate::createGame(save.data(), game, saveTime + quint64(i) * TICKS_PER_SECOND, name);
+
+        QString path = dir.filePath(QString("wiiking2-%1.sav").arg(i + 1, width, 10, QChar('0')));
+        QFile file(path);
+        if (!file.open(QFile::WriteOnly) || file.write(save) != save.size())
+        {
+            err() << "Unable to write " << path << endl;
+            failed++;
+        }
+    }
+    qint64 runTime = timer.elapsed();
+
+    out() << "Created " << count - failed << " " << regionName << " saves with " << games
+          << " adventures each in " << runTime << " ms" << endl;
+    return failed ? 2 : 0;
+}
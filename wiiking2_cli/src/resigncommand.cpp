@@ -0,0 +1,81 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "commands.h"
+#include "databinresigner.h"
+#include "wiikeys.h"
+
+int resignCommand(QStringList args)
+{
+    QByteArray mac = QByteArray::fromHex(takeOption(args, "--mac").toLatin1());
+    QString outputDir = takeOption(args, "--out");
+    bool strict = takeFlag(args, "--strict");
+    bool ok = true;
+    int threads = takeOption(args, "--threads", "0").toInt(&ok);
+    if (args.size() < 2 || mac.size() != 6 || !ok)
+        return usageError("resign");
+
+    quint32    ngId;
+    quint32    ngKeyId;
+    QByteArray ngPriv;
+    QByteArray ngSig;
+    QString keysFile = args.takeFirst();
+    if (!WiiKeys::readKeysFile(keysFile, &ngId, &ngKeyId, &ngPriv, &ngSig))
+    {
+        err() << keysFile << " is not a BootMii keys.bin" << endl;
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    DataBinResigner resigner(SigningContext::cached(ngId, ngKeyId, ngPriv, ngSig, mac));
+    resigner.setOutputDirectory(outputDir);
+    resigner.setRequireValidSignature(strict);
+    resigner.setThreadCount(threads);
+    qint64 setupTime = timer.elapsed();
+
+    timer.restart();
+    QList<DataBinResigner::Result> results = resigner.resignFiles(args);
+    qint64 runTime = timer.elapsed();
+
+    int failed = 0;
+    int unverified = 0;
+    foreach (const DataBinResigner::Result& r, results)
+    {
+        if (!r.Ok)
+        {
+            err() << r.Input << ": " << r.Error << endl;
+            failed++;
+        }
+        else if (!r.WasVerified)
+        {
+            out() << r.Input << ": original signature did not verify" << endl;
+            unverified++;
+        }
+    }
+
+    out() << "Re-signed " << results.size() - failed << " of " << results.size() << " files for NG"
+          << QString::number(ngId, 16).rightJustified(8, '0') << " in " << runTime << " ms ("
+          << QString::number(runTime > 0 ? results.size() * 1000.0 / runTime : 0.0, 'f', 1) << " files/s, "
+          << (threads > 0 ? threads : QThread::idealThreadCount()) << " threads, " << setupTime << " ms key setup)";
+    if (unverified > 0)
+        out() << ", " << unverified << " had an invalid signature";
+    out() << endl;
+
+    return failed == 0 ? 0 : 2;
+}
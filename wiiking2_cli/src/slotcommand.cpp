@@ -0,0 +1,118 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include <QFile>
+
+#include "commands.h"
+#include "databinresigner.h"
+#include "slottransfer.h"
+
+static bool readSave(const QString& path, QByteArray* save)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        err() << "Unable to open " << path << endl;
+        return false;
+    }
+    *save = file.readAll();
+    if (save->size() != SlotTransfer::SAVE_SIZE)
+    {
+        err() << path << " is not a wiiking2.sav" << endl;
+        return false;
+    }
+    return true;
+}
+
+static bool writeSave(const QString& path, const QByteArray& save)
+{
+    QString error;
+    if (!DataBinResigner::writeFile(path, save, &error))
+    {
+        err() << error << endl;
+        return false;
+    }
+    return true;
+}
+
+// Slots are numbered 1 to 3 on the command line
+static int slotIndex(const QString& arg)
+{
+    bool ok = false;
+    int slot = arg.toInt(&ok);
+    return ok ? slot - 1 : -1;
+}
+
+int slotCommand(QStringList args)
+{
+    QString sourcePath = takeOption(args, "--from-file");
+    QString outputPath = takeOption(args, "--out");
+    if (args.size() < 3)
+        return usageError("slot");
+
+    QString operation = args.takeFirst();
+    QString savePath = args.takeFirst();
+    int from = slotIndex(args.takeFirst());
+    int to = args.isEmpty() ? -1 : slotIndex(args.takeFirst());
+    bool needsTarget = (operation == "copy" || operation == "move" || operation == "swap");
+    if ((needsTarget && to < 0) || (!needsTarget && operation != "duplicate") || !args.isEmpty() ||
+        (!sourcePath.isEmpty() && operation != "copy" && operation != "move"))
+        return usageError("slot");
+    if (outputPath.isEmpty())
+        outputPath = savePath;
+
+    QByteArray save;
+    QByteArray source;
+    if (!readSave(savePath, &save) || (!sourcePath.isEmpty() && !readSave(sourcePath, &source)))
+        return 1;
+    char* sourceData = sourcePath.isEmpty() ? save.data() : source.data();
+
+    bool ok = false;
+    if (operation == "copy")
+        ok = SlotTransfer::copy(sourceData, from, save.data(), to);
+    else if (operation == "move")
+        ok = SlotTransfer::move(sourceData, from, save.data(), to);
+    else if (operation == "swap")
+        ok = SlotTransfer::swap(save.data(), from, to);
+    else
+    {
+        to = SlotTransfer::duplicate(save.data(), from);
+        ok = (to >= 0);
+        if (!ok && from >= 0 && from < SlotTransfer::SLOT_COUNT)
+        {
+            err() << savePath << " has no new slot to duplicate into" << endl;
+            return 2;
+        }
+    }
+    if (!ok)
+    {
+        err() << "Slots are numbered 1 to " << SlotTransfer::SLOT_COUNT << endl;
+        return 1;
+    }
+
+    // a move empties the slot in the other file, that one is updated in place
+    if (operation == "move" && !sourcePath.isEmpty() && !writeSave(sourcePath, source))
+        return 2;
+    if (!writeSave(outputPath, save))
+        return 2;
+
+    out() << operation << " slot " << from + 1;
+    if (!sourcePath.isEmpty())
+        out() << " of " << sourcePath;
+    if (to >= 0)
+        out() << (operation == "swap" ? " with" : " to") << " slot " << to + 1;
+    out() << ", wrote " << outputPath << endl;
+    return 0;
+}
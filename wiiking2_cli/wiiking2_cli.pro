@@ -0,0 +1,41 @@
+#-------------------------------------------------
+#
+# Command line tools working on Skyward Sword saves
+#
+#-------------------------------------------------
+
+QT += core
+QT -= gui
+
+CONFIG += console
+CONFIG -= app_bundle
+
+CONFIG(debug, debug|release){
+    DEFINES += DEBUG
+}
+CONFIG(release, release|debug){
+    DEFINES -= DEBUG
+}
+
+QMAKE_CXXFLAGS = -O2 -std=c++0x
+
+TEMPLATE = app
+unix:TARGET =../wiiking2_cli.x86_64
+INCLUDEPATH += ./include
+
+include(../wiiking2_editor/wiiking2_core.pri)
+
+SOURCES += \
+    src/main.cpp \
+    src/flagdiffcommand.cpp \
+    src/aesbenchcommand.cpp \
+    src/resigncommand.cpp \
+    src/infocommand.cpp \
+    src/convertcommand.cpp \
+    src/fieldbenchcommand.cpp \
+    src/slotcommand.cpp \
+    src/newcommand.cpp \
+    src/generatecommand.cpp
+
+HEADERS += \
+    include/commands.h
@@ -0,0 +1,64 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef AES128_H
+#define AES128_H
+
+#include <QtGlobal>
+
+// AES-128 in CBC mode, as used for data.bin files. Uses the AES-NI
+// instructions when the CPU has them and a portable T-table implementation
+// otherwise. The choice is made once at runtime, so the same binary runs
+// everywhere.
+class Aes128
+{
+public:
+    enum Backend
+    {
+        PortableBackend,
+        AesNiBackend
+    };
+
+    static const int BLOCK_SIZE = 16;
+    static const int KEY_SIZE   = 16;
+
+    Aes128();
+    explicit Aes128(const quint8* key);
+
+    void    setKey(const quint8* key);
+
+    // length has to be a multiple of BLOCK_SIZE, in and out may be the same
+    // buffer. iv is updated to the last ciphertext block, so a stream can be
+    // processed in pieces.
+    void    encryptCbc(const quint8* in, quint8* out, quint64 length, quint8* iv) const;
+    void    decryptCbc(const quint8* in, quint8* out, quint64 length, quint8* iv) const;
+
+    Backend backend() const;
+    // Falls back to the portable backend if the CPU lacks AES-NI
+    void    setBackend(Backend backend);
+
+    static Backend     bestBackend();
+    static bool        isSupported(Backend backend);
+    static const char* backendName(Backend backend);
+
+private:
+    Backend m_backend;
+    quint32 m_encKey[44];                   //!< Portable round keys
+    quint32 m_decKey[44];
+    quint8  m_niEncKey[11 * 16];            //!< AES-NI round keys
+    quint8  m_niDecKey[11 * 16];
+};
+
+#endif // AES128_H
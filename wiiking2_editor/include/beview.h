@@ -0,0 +1,206 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef BEVIEW_H
+#define BEVIEW_H
+
+#include <QtGlobal>
+#include <string.h>
+
+#include "bitops.h"
+
+// Typed access to the big-endian save data. Values are copied in and out
+// with memcpy, which is defined for any alignment and does not alias the
+// buffer, so each access compiles to one load or store plus a bswap.
+//
+//   BEField<T, Offset>               integers, float and Vector3
+//   BEValue<T>                       the same as a struct member, see
+//                                    slotlayout.h
+//   BEBits<T, Offset, Shift, Width>  a bit field inside a big-endian word,
+//                                    e.g. the 7 bit counters packed in pairs
+//   BEView                           the same accessors at runtime offsets,
+//                                    usually over one slot
+
+struct Vector3
+{
+    float X;
+    float Y;
+    float Z;
+
+    Vector3(float x, float y, float z) : X(x), Y(y), Z(z)
+    {}
+};
+
+// Unsigned integer of the same size as T and the swap for it
+template<int Size> struct BEWord;
+template<> struct BEWord<1> { typedef quint8  Type; static Type swap(Type v) { return v; } };
+template<> struct BEWord<2> { typedef quint16 Type; static Type swap(Type v) { return byteSwap16(v); } };
+template<> struct BEWord<4> { typedef quint32 Type; static Type swap(Type v) { return byteSwap32(v); } };
+template<> struct BEWord<8> { typedef quint64 Type; static Type swap(Type v) { return byteSwap64(v); } };
+
+template<typename T>
+inline T beLoad(const char* p)
+{
+    typedef BEWord<sizeof(T)> Word;
+    typename Word::Type word;
+    memcpy(&word, p, sizeof(word));
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    word = Word::swap(word);
+#endif
+    T value;
+    memcpy(&value, &word, sizeof(value));
+    return value;
+}
+
+template<typename T>
+inline void beStore(char* p, T value)
+{
+    typedef BEWord<sizeof(T)> Word;
+    typename Word::Type word;
+    memcpy(&word, &value, sizeof(word));
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    word = Word::swap(word);
+#endif
+    memcpy(p, &word, sizeof(word));
+}
+
+template<>
+inline Vector3 beLoad<Vector3>(const char* p)
+{
+    return Vector3(beLoad<float>(p), beLoad<float>(p + 4), beLoad<float>(p + 8));
+}
+
+template<>
+inline void beStore<Vector3>(char* p, Vector3 value)
+{
+    beStore<float>(p, value.X);
+    beStore<float>(p + 4, value.Y);
+    beStore<float>(p + 8, value.Z);
+}
+
+template<typename T, int Offset>
+struct BEField
+{
+    typedef T Type;
+    enum { OFFSET = Offset };
+
+    static T get(const char* base)
+    {
+        return beLoad<T>(base + Offset);
+    }
+
+    static void set(char* base, T value)
+    {
+        beStore<T>(base + Offset, value);
+    }
+};
+
+// A big-endian T stored as plain bytes, so structs of these have no
+// padding and can be laid over the save data
+template<typename T>
+struct BEValue
+{
+    char Bytes[sizeof(T)];
+
+    T get() const
+    {
+        return beLoad<T>(Bytes);
+    }
+
+    void set(T value)
+    {
+        beStore<T>(Bytes, value);
+    }
+};
+
+// Width bits starting at bit Shift (counted from the least significant) of
+// the big-endian T at Offset, setting keeps the other bits
+template<typename T, int Offset, int Shift, int Width>
+struct BEBits
+{
+    typedef quint32 Type;
+    enum { OFFSET = Offset, SHIFT = Shift, WIDTH = Width };
+
+    static T mask()
+    {
+        return T(((T(1) << Width) - 1) << Shift);
+    }
+
+    static quint32 get(const char* base)
+    {
+        return quint32((beLoad<T>(base + Offset) & mask()) >> Shift);
+    }
+
+    static void set(char* base, quint32 value)
+    {
+        T word = beLoad<T>(base + Offset);
+        beStore<T>(base + Offset, T((word & ~mask()) | ((T(value) << Shift) & mask())));
+    }
+};
+
+class BEView
+{
+public:
+    explicit BEView(char* data) : m_data(data)
+    {}
+
+    char* data() const
+    {
+        return m_data;
+    }
+
+    template<typename Field>
+    typename Field::Type get() const
+    {
+        return Field::get(m_data);
+    }
+
+    template<typename Field>
+    void set(typename Field::Type value) const
+    {
+        Field::set(m_data, value);
+    }
+
+    template<typename T>
+    T get(int offset) const
+    {
+        return beLoad<T>(m_data + offset);
+    }
+
+    template<typename T>
+    void set(int offset, T value) const
+    {
+        beStore<T>(m_data + offset, value);
+    }
+
+    // One counter of the pair packed into the big-endian quint16 at offset,
+    // the low 7 bits or bits 7-13
+    quint32 packed7(int offset, bool high) const
+    {
+        return (beLoad<quint16>(m_data + offset) >> (high ? 7 : 0)) & 127;
+    }
+
+    void setPacked7(int offset, bool high, quint32 value) const
+    {
+        int shift = high ? 7 : 0;
+        quint16 word = beLoad<quint16>(m_data + offset) & ~(127 << shift);
+        beStore<quint16>(m_data + offset, quint16(word | ((value & 127) << shift)));
+    }
+
+private:
+    char* m_data;
+};
+
+#endif // BEVIEW_H
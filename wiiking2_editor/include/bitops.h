@@ -0,0 +1,95 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef BITOPS_H
+#define BITOPS_H
+
+#include <QtGlobal>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// BITOPS_SSE2 is set where SSE2 needs no runtime check: every x86-64
+// target and x86 builds compiled for SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BITOPS_SSE2
+#endif
+
+// Small helpers for the bitset based scanners and the big-endian field
+// views, they map to a single instruction on every compiler we build with.
+
+inline int popCount64(quint64 val)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    return int(__popcnt64(val));
+#elif defined(_MSC_VER)
+    return int(__popcnt(quint32(val)) + __popcnt(quint32(val >> 32)));
+#else
+    return __builtin_popcountll(val);
+#endif
+}
+
+// val must not be 0
+inline int countTrailingZeros64(quint64 val)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, val);
+    return int(idx);
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    if (quint32(val))
+        _BitScanForward(&idx, quint32(val));
+    else
+    {
+        _BitScanForward(&idx, quint32(val >> 32));
+        idx += 32;
+    }
+    return int(idx);
+#else
+    return __builtin_ctzll(val);
+#endif
+}
+
+inline quint16 byteSwap16(quint16 val)
+{
+#if defined(_MSC_VER)
+    return _byteswap_ushort(val);
+#else
+    return __builtin_bswap16(val);
+#endif
+}
+
+inline quint32 byteSwap32(quint32 val)
+{
+#if defined(_MSC_VER)
+    return _byteswap_ulong(val);
+#else
+    return __builtin_bswap32(val);
+#endif
+}
+
+inline quint64 byteSwap64(quint64 val)
+{
+#if defined(_MSC_VER)
+    return _byteswap_uint64(val);
+#else
+    return __builtin_bswap64(val);
+#endif
+}
+
+#endif // BITOPS_H
@@ -26,8 +26,14 @@ public:
     Checksum();
     quint32 CRC32(const quint8* data, quint64 pos, quint64 length); //!< Used by Skyward Sword just a basic CRC32 with default Polynomial.
     quint16 checksum16(const quint8* data, quint64 pos, quint64 length); //!< Used by the oracle games.
+
+    // CRC32 of length bytes after count bytes at offset changed from before
+    // to after, crc being the CRC32 from before the change. Only the changed
+    // bytes are read, the rest of the data is not needed.
+    quint32 CRC32Patch(quint32 crc, quint64 length, quint64 offset, const quint8* before, const quint8* after, quint64 count);
 private:
     quint32 reflect(quint32 reflect, char c);
+    static quint32 shiftZeros(quint32 crc, quint64 count);
     static const quint32 m_crcTable[256];
 };
 
@@ -18,13 +18,8 @@
 
 #include <QImage>
 #include <QDateTime>
-
-const quint64 SECONDS_TO_2000 = 946684800LL;
-const quint64 TICKS_PER_SECOND = 60750000LL;
+#include "wiitime.h"
 
 QImage convertTextureToImage( const QByteArray &ba, quint32 w, quint32 h );
-quint64 getWiiTime();
-quint64 toWiiTime(QDateTime time);
-QDateTime fromWiiTime(quint64 wiiTime);
 
 #endif // COMMON_H
@@ -0,0 +1,60 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef COMPAREDIALOG_H
+#define COMPAREDIALOG_H
+
+#include <QDialog>
+
+class SkywardSwordFile;
+class QHexDiffView;
+class QComboBox;
+class QPushButton;
+class QAbstractButton;
+class QDialogButtonBox;
+
+// Compares two adventures side by side, either two slots of the open file or
+// a slot of the open file against a slot of another save
+class CompareDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit CompareDialog(SkywardSwordFile* gameFile, QWidget *parent = 0);
+    ~CompareDialog();
+
+    bool applied() const; // true once changes were written to the open file
+
+private slots:
+    void onOpenOther();
+    void onSourceChanged();
+    void onButtonClicked(QAbstractButton* button);
+
+private:
+    QByteArray sourceData(int source);
+    QString    sourceName(int source) const;
+    void       fillRightSources();
+    void       writeGame(int game, const QByteArray& data);
+
+    SkywardSwordFile* m_gameFile;
+    SkywardSwordFile* m_otherFile;
+    QHexDiffView*     m_diffView;
+    QComboBox*        m_leftCombo;
+    QComboBox*        m_rightCombo;
+    QPushButton*      m_openOtherBtn;
+    QDialogButtonBox* m_buttonBox;
+    bool              m_applied;
+};
+
+#endif // COMPAREDIALOG_H
@@ -0,0 +1,107 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef CONVERTPIPELINE_H
+#define CONVERTPIPELINE_H
+
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+#include "databincodec.h"
+#include "signingcontext.h"
+
+// Converts a directory of wiiking2.sav files to signed data.bin files or
+// back. The work runs in three stages connected by bounded queues:
+//
+//   readers (pool)  load and hash the inputs, identical inputs are only
+//                   converted once
+//   workers (pool)  patch a save into the template for its region, encrypt
+//                   and sign, or decrypt wiiking2.sav out of a data.bin
+//   writer          writes the results in input order, duplicates are
+//                   copied from the first output
+//
+// Files are recognised by their content, not their suffix. Outputs are
+// named after the input without its suffix; a run where two inputs would
+// get the same output name is refused before anything is converted.
+class ConvertPipeline
+{
+public:
+    enum Direction
+    {
+        SavToDataBin,
+        DataBinToSav
+    };
+
+    struct StageStats
+    {
+        QString Name;
+        int     Items;
+        qint64  BusyNs;         //!< Summed over the stage's threads
+        qint64  WallNs;
+        int     Threads;
+        int     MaxQueueDepth;  //!< Of the queue feeding the next stage
+        double  AverageQueueDepth;
+    };
+
+    explicit ConvertPipeline(Direction direction);
+
+    Direction direction() const;
+
+    // Needed for SavToDataBin
+    void setSigningContext(QSharedPointer<const SigningContext> context);
+    // A data.bin whose banner and layout new files are built from, one per
+    // region
+    bool addTemplate(const QString& dataBin, QString* error = NULL);
+
+    void setReaderThreads(int count);
+    void setWorkerThreads(int count);       //!< 0 uses one thread per core
+    void setQueueCapacity(int count);
+
+    // Returns false if nothing could be converted
+    bool run(const QString& inputDir, const QString& outputDir);
+
+    int               converted() const;
+    int               duplicates() const;
+    QStringList       errors() const;
+    QList<StageStats> stats() const;
+
+private:
+    friend class ConvertRun;
+
+    // The template stays encrypted, new files only encrypt their own
+    // wiiking2.sav and skip.dat into a copy
+    struct Template
+    {
+        QByteArray              Image;      //!< Encrypted data.bin
+        DataBinCodec::FileEntry Save;       //!< wiiking2.sav
+        DataBinCodec::FileEntry Skip;       //!< skip.dat, Size is 0 if there is none
+    };
+
+    Direction m_direction;
+    QSharedPointer<const SigningContext> m_context;
+    QHash<quint32, Template> m_templates;       //!< By region
+    int         m_readerThreads;
+    int         m_workerThreads;
+    int         m_queueCapacity;
+    int         m_converted;
+    int         m_duplicates;
+    QStringList m_errors;
+    QList<StageStats> m_stats;
+};
+
+#endif // CONVERTPIPELINE_H
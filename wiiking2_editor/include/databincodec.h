@@ -0,0 +1,90 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef DATABINCODEC_H
+#define DATABINCODEC_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "aes128.h"
+
+// Decrypts and encrypts a whole data.bin in memory. The banner header is
+// encrypted with the SD key and IV, every file with the SD key and the IV
+// from its own file header. The Bk header, the file headers and the
+// certificates at the end are stored in the clear and are left as they are.
+class DataBinCodec
+{
+public:
+    struct FileEntry
+    {
+        QString Name;
+        quint32 Size;
+        quint8  Permissions;
+        quint8  Attributes;
+        quint8  Type;                       //!< 1 file, 2 directory
+        quint32 Offset;                     //!< Offset of the file data in data.bin
+        QByteArray Iv;
+    };
+
+    static const quint32 HEADER_SIZE      = 0xF0C0;
+    static const quint32 BK_HEADER_SIZE   = 0x80;
+    static const quint32 FILE_HEADER_SIZE = 0x80;
+    static const quint32 FILE_MAGIC       = 0x03ADF17E;
+
+    DataBinCodec();
+
+    // Both work in place, the file list is filled in as a side effect
+    bool decrypt(QByteArray& data);
+    bool encrypt(QByteArray& data);
+
+    // The banner header at the start, HEADER_SIZE bytes in place
+    void             decryptHeader(quint8* data) const;
+    void             encryptHeader(quint8* data) const;
+    // Decrypts the payload of one entry in place, data holds storedSize()
+    // bytes
+    void             decryptFile(const FileEntry& entry, quint8* data) const;
+    void             encryptFile(const FileEntry& entry, quint8* data) const;
+
+    // Overwrites a payload in data decrypted by the last decrypt(), the
+    // size has to stay the same
+    bool             replaceFile(QByteArray& data, const QString& name, const QByteArray& contents) const;
+    // Same for a data.bin that is still encrypted, e.g. with an entry from
+    // DataBinReader. Only the new payload is encrypted, the rest of the
+    // image is left alone; the padding after it is kept.
+    bool             replaceEncryptedFile(QByteArray& image, const FileEntry& entry, const QByteArray& contents) const;
+
+    QList<FileEntry> files() const;
+    QString          errorString() const;
+
+    Aes128::Backend  backend() const;
+    void             setBackend(Aes128::Backend backend);
+
+    static bool      isBkHeader(const quint8* header);
+    // Reads the file header at offset, false if the magic is wrong
+    static bool      parseFileHeader(const quint8* header, quint32 offset, FileEntry* entry);
+    // Payload size on disk, padded to 64 bytes, 0 for directories
+    static quint32   storedSize(const FileEntry& entry);
+
+private:
+    bool process(QByteArray& data, bool encrypt);
+
+    Aes128           m_aes;
+    QList<FileEntry> m_files;
+    QString          m_error;
+};
+
+#endif // DATABINCODEC_H
@@ -0,0 +1,83 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef DATABINREADER_H
+#define DATABINREADER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QList>
+#include <QString>
+
+#include "databincodec.h"
+
+// Reads a data.bin piece by piece instead of decrypting all of it. open()
+// only reads the Bk header and the file headers, which are stored in the
+// clear, and seeks over the payloads. Nothing is decrypted until readFile()
+// asks for one entry, so listing a backup or finding its region costs a few
+// small reads.
+class DataBinReader
+{
+public:
+    // banner.bin from the encrypted header, the textures are RGB5A3
+    struct Banner
+    {
+        QString           Title;
+        QString           Subtitle;
+        QByteArray        Image;        //!< 192x64
+        QList<QByteArray> Icons;        //!< 48x48 each, one frame per icon
+    };
+
+    enum
+    {
+        BANNER_WIDTH  = 192,
+        BANNER_HEIGHT = 64,
+        ICON_WIDTH    = 48,
+        ICON_HEIGHT   = 48
+    };
+
+    explicit DataBinReader(const QString& filepath);
+    // Reads from an already open device, e.g. a QBuffer over a file in memory
+    explicit DataBinReader(QIODevice* device);
+
+    bool    open();
+    void    close();
+    QString errorString() const;
+
+    quint32    ngId() const;
+    QByteArray macAddress() const;
+    quint64    titleId() const;
+    QString    gameId() const;              //!< The four character code, e.g. "SOUE"
+
+    QList<DataBinCodec::FileEntry> files() const;
+    // Names can be given with or without the leading '/'
+    int        indexOf(const QString& name) const;
+    // Decrypts a single entry, an empty array if it can't be read
+    QByteArray readFile(const QString& name);
+    QByteArray readFile(int index);
+    // Decrypts the header, which holds nothing but the banner
+    bool       readBanner(Banner* banner);
+
+private:
+    QFile      m_file;
+    QIODevice* m_device;
+    QString    m_error;
+    QByteArray m_bkHeader;
+    QList<DataBinCodec::FileEntry> m_files;
+    DataBinCodec m_codec;
+};
+
+#endif // DATABINREADER_H
@@ -0,0 +1,85 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef DATABINRESIGNER_H
+#define DATABINRESIGNER_H
+
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+#include "signingcontext.h"
+
+// Moves data.bin files to another console's keys. Every file is decrypted
+// to check its layout, its current signature is verified, then it is
+// encrypted again, signed with the target context and written back through
+// a temporary file, so an interrupted run never leaves a half written save.
+//
+// Files are processed on a thread pool. Each worker holds one file at a
+// time, memory use is bounded by the thread count, not the number of files.
+class DataBinResigner
+{
+public:
+    struct Result
+    {
+        QString Input;
+        QString Output;
+        bool    Ok;
+        bool    WasVerified;    //!< The original signature checked out
+        QString Error;
+    };
+
+    explicit DataBinResigner(QSharedPointer<const SigningContext> context);
+
+    // Writes next to the input when empty. Otherwise every input keeps its
+    // path relative to the deepest directory all inputs of a batch share,
+    // so data.bin files from different folders do not meet.
+    void    setOutputDirectory(const QString& dir);
+    QString outputDirectory() const;
+    // Refuse files whose current signature does not verify
+    void    setRequireValidSignature(bool require);
+    bool    requireValidSignature() const;
+    // 0 uses one thread per core
+    void    setThreadCount(int count);
+    int     threadCount() const;
+
+    // Where resignFiles() writes each of paths
+    QStringList   outputPaths(const QStringList& paths) const;
+
+    // Thread safe
+    Result        resignFile(const QString& path) const;
+    // Fails every file without writing any if two of them map to the same
+    // output
+    QList<Result> resignFiles(const QStringList& paths) const;
+
+    // Checks the AP certificate against the NG certificate and the data
+    // signature against the AP certificate
+    static bool verifySignature(const QByteArray& dataBin, QString* error = NULL);
+
+    // Replaces path through a temporary file
+    static bool writeFile(const QString& path, const QByteArray& data, QString* error);
+
+private:
+    friend class ResignTask;
+    Result resignFile(const QString& path, const QString& output) const;
+
+    QSharedPointer<const SigningContext> m_context;
+    QString m_outputDir;
+    bool    m_requireValid;
+    int     m_threadCount;
+};
+
+#endif // DATABINRESIGNER_H
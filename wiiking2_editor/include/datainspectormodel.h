@@ -0,0 +1,59 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef DATAINSPECTORMODEL_H
+#define DATAINSPECTORMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+// Table model behind the hex editor's data inspector. setCursor() only copies
+// a small window of bytes behind the cursor, the values are decoded when the
+// view asks for them, so only visible rows cost anything.
+class DataInspectorModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    static const int WINDOW_SIZE = 32;
+
+    // Decodes the value at data, available is at least the type's size
+    typedef QString (*Decoder)(const uchar* data, int available);
+
+    explicit DataInspectorModel(QObject *parent = 0);
+
+    void addType(const QString& name, int size, Decoder decoder);
+    void setCursor(const QByteArray& data, int address);
+    int  address() const;
+
+    int      rowCount(const QModelIndex& parent = QModelIndex()) const;
+    int      columnCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+private:
+    struct Type
+    {
+        QString Name;
+        int     Size;
+        Decoder Decode;
+    };
+
+    QVector<Type> m_types;
+    uchar         m_window[WINDOW_SIZE];
+    int           m_available;
+    int           m_address;
+};
+
+#endif // DATAINSPECTORMODEL_H
@@ -0,0 +1,41 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef EC233_H
+#define EC233_H
+
+#include <QtGlobal>
+
+// ECDSA on sect233r1, the curve the Wii signs saves with. Private keys and
+// field elements are 30 byte big endian numbers, points are x followed by y
+// and signatures R followed by S.
+//
+// Multiples of the generator come from a table of G * 2^i built on first
+// use, so signing costs additions only. Nonces are derived from the private
+// key and the hash, signing needs no random source and is repeatable.
+class Ec233
+{
+public:
+    static const int ELEMENT_SIZE   = 30;
+    static const int POINT_SIZE     = 60;
+    static const int SIGNATURE_SIZE = 60;
+    static const int HASH_SIZE      = 20;   //!< SHA-1
+
+    static void publicKey(const quint8* priv, quint8* pub);
+    static void sign(const quint8* priv, const quint8* hash, quint8* signature);
+    static bool verify(const quint8* pub, const quint8* hash, const quint8* signature);
+};
+
+#endif // EC233_H
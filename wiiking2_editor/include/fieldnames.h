@@ -0,0 +1,35 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef FIELDNAMES_H
+#define FIELDNAMES_H
+
+#include <QtGlobal>
+
+// A known field inside an adventure slot, offsets are relative to the slot
+struct SaveField
+{
+    quint32     Offset;
+    quint32     Length;
+    const char* Name;
+};
+
+extern const SaveField SAVE_FIELDS[];
+extern const int       SAVE_FIELD_COUNT;
+
+// Returns the field containing offset or NULL
+const SaveField* findSaveField(quint32 offset);
+
+#endif // FIELDNAMES_H
@@ -0,0 +1,76 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef FILEJOB_H
+#define FILEJOB_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include "skywardswordfile.h"
+
+// Runs an open or a save off the GUI thread. data.bin files go through
+// libzelda's AES and ECDSA code, which takes long enough to freeze the
+// window. Progress is reported per stage, as libzelda has no finer hook.
+//
+// cancel() is honoured between stages. A save can only be cancelled before
+// it starts writing, so a file is never left half written.
+class FileJob : public QThread
+{
+    Q_OBJECT
+public:
+    enum Type
+    {
+        OpenJob,
+        SaveJob
+    };
+
+    // Opens filepath into a new SkywardSwordFile, see takeFile()
+    explicit FileJob(const QString& filepath, QObject* parent = 0);
+    // Saves file to its current filename. The file must not be touched
+    // until the job finished.
+    explicit FileJob(SkywardSwordFile* file, QObject* parent = 0);
+    ~FileJob();
+
+    Type    type() const;
+    QString filename() const;
+
+    void    cancel();
+    bool    isCancelled() const;
+
+    bool    succeeded() const;
+    QString errorString() const;
+    bool    hasValidChecksum() const; //!< Open only, the checksum of the first adventure
+    SkywardSwordFile* takeFile();     //!< Open only, the caller owns the file afterwards
+
+signals:
+    void progress(int percent, const QString& stage);
+
+protected:
+    void run();
+
+private:
+    void runOpen();
+    void runSave();
+
+    Type              m_type;
+    QString           m_filename;
+    SkywardSwordFile* m_file;
+    bool              m_succeeded;
+    bool              m_validChecksum;
+    QString           m_error;
+    mutable QAtomicInt m_cancelled;
+};
+
+#endif // FILEJOB_H
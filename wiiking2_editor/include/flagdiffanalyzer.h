@@ -0,0 +1,95 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef FLAGDIFFANALYZER_H
+#define FLAGDIFFANALYZER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QMutex>
+
+// Finds the bits behind an in game event by diffing many saves made right
+// before and right after it. Every pair is tagged with a label (e.g.
+// "got-big-wallet"), the bits which flip in the pairs of one label but rarely
+// in the pairs of the others are ranked first.
+class FlagDiffAnalyzer
+{
+public:
+    struct PairFile
+    {
+        QString Label;
+        QString Before;
+        QString After;
+    };
+
+    struct Candidate
+    {
+        quint32 Offset;
+        quint8  Mask;       //!< Bit inside the byte at Offset, as used by SkywardSwordFile::flag()
+        quint32 Hits;       //!< Pairs of the label where this bit flipped
+        quint32 Pairs;      //!< Pairs with the label
+        quint32 OtherHits;  //!< Pairs of other labels where this bit flipped
+        double  Score;
+    };
+
+    FlagDiffAnalyzer();
+
+    // Folds the three adventure slots onto slot relative offsets, so pairs
+    // recorded in different slots count towards the same bits. Clears the
+    // analyzer.
+    void setSlotRelative(bool slotRelative);
+    bool isSlotRelative() const;
+    void clear();
+
+    // Thread safe
+    bool addPair(const QString& label, const QByteArray& before, const QByteArray& after);
+    // Loads and diffs the files on all cores, returns the number of pairs added
+    int  addPairFiles(const QList<PairFile>& files, QStringList* errors = NULL);
+
+    // Reads a list of "label before after" lines, paths are relative to the list
+    static QList<PairFile> readPairList(const QString& filename, QString* error = NULL);
+
+    QStringList labels() const;
+    int         pairCount() const;
+    int         pairCount(const QString& label) const;
+    double      averageChangedBits() const;
+
+    QList<Candidate> ranking(const QString& label, int max = 20) const;
+
+private:
+    // XOR of a pair, only the words which differ are kept
+    struct Diff
+    {
+        int               Label;
+        QVector<quint32>  Words;
+        QVector<quint64>  Bits;
+    };
+
+    Diff diff(const QByteArray& before, const QByteArray& after) const;
+    void countBits(const Diff& d, QVector<quint32>& counts) const;
+    int  bitCount() const;
+
+    bool             m_slotRelative;
+    int              m_size;
+    QStringList      m_labels;
+    QList<Diff>      m_diffs;
+    quint64          m_changedBits;
+    mutable QMutex   m_mutex;
+};
+
+#endif // FLAGDIFFANALYZER_H
@@ -0,0 +1,68 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef FLAGDIFFDOCK_H
+#define FLAGDIFFDOCK_H
+
+#include <QDockWidget>
+#include "flagdiffanalyzer.h"
+
+class QComboBox;
+class QCheckBox;
+class QPushButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+class QLabel;
+class QProgressBar;
+class FlagDiffJob;
+
+class FlagDiffDock : public QDockWidget
+{
+    Q_OBJECT
+public:
+    explicit FlagDiffDock(QWidget *parent = 0);
+    ~FlagDiffDock();
+
+signals:
+    // game is GameNone for slot relative offsets
+    void addressActivated(int game, int offset);
+
+private slots:
+    void onLoadPairList();
+    void onCancelLoad();
+    void onLoadProgress(int percent, const QString& stage);
+    void onLoadFinished();
+    void onClear();
+    void onSlotRelativeToggled(bool checked);
+    void onLabelChanged(int index);
+    void onItemActivated(QTreeWidgetItem* item);
+
+private:
+    void updateLabels();
+    void setLoading(bool loading);
+
+    FlagDiffAnalyzer m_analyzer;
+    QPushButton*     m_loadBtn;
+    QPushButton*     m_clearBtn;
+    QPushButton*     m_cancelBtn;
+    QCheckBox*       m_slotRelativeCheck;
+    QComboBox*       m_labelCombo;
+    QTreeWidget*     m_resultTree;
+    QLabel*          m_statusLabel;
+    QProgressBar*    m_progress;
+    FlagDiffJob*     m_job;             //!< Running pair list load, NULL when idle
+};
+
+#endif // FLAGDIFFDOCK_H
@@ -0,0 +1,60 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef FLAGDIFFJOB_H
+#define FLAGDIFFJOB_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QStringList>
+#include "flagdiffanalyzer.h"
+
+// Loads a pair list into a FlagDiffAnalyzer off the GUI thread. The pairs
+// go through FlagDiffAnalyzer::addPairFiles() in batches, progress is
+// reported and cancel() is honoured between them; pairs of finished
+// batches stay in the analyzer.
+//
+// The analyzer must not be cleared or reconfigured until the job finished.
+class FlagDiffJob : public QThread
+{
+    Q_OBJECT
+public:
+    FlagDiffJob(FlagDiffAnalyzer* analyzer, const QList<FlagDiffAnalyzer::PairFile>& files, QObject* parent = 0);
+    ~FlagDiffJob();
+
+    void        cancel();
+    bool        isCancelled() const;
+
+    int         pairCount() const;  //!< Pairs in the list
+    int         added() const;      //!< Pairs added to the analyzer
+    QStringList errors() const;
+    qint64      elapsed() const;    //!< In ms
+
+signals:
+    void progress(int percent, const QString& stage);
+
+protected:
+    void run();
+
+private:
+    FlagDiffAnalyzer*                m_analyzer;
+    QList<FlagDiffAnalyzer::PairFile> m_files;
+    int                              m_added;
+    QStringList                      m_errors;
+    qint64                           m_elapsed;
+    mutable QAtomicInt               m_cancelled;
+};
+
+#endif // FLAGDIFFJOB_H
@@ -0,0 +1,62 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef HEXSEARCHWIDGET_H
+#define HEXSEARCHWIDGET_H
+
+#include <QWidget>
+#include "qhexedit2/searchengine.h"
+
+class QHexEdit;
+class QComboBox;
+class QLineEdit;
+class QPushButton;
+class QListWidget;
+class QListWidgetItem;
+class QLabel;
+
+class HexSearchWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit HexSearchWidget(QHexEdit* hexEdit, QWidget *parent = 0);
+
+public slots:
+    void findNext();
+    void findPrevious();
+    void findAll();
+    void clear();
+
+private slots:
+    void onHitsFound(const QList<int>& hits);
+    void onSearchFinished(int count);
+    void onSearchCleared();
+    void onResultActivated(QListWidgetItem* item);
+
+private:
+    bool currentPattern(SearchPattern& pattern);
+
+    QHexEdit*    m_hexEdit;
+    QComboBox*   m_typeCombo;
+    QLineEdit*   m_searchEdit;
+    QPushButton* m_nextBtn;
+    QPushButton* m_prevBtn;
+    QPushButton* m_allBtn;
+    QListWidget* m_resultList;
+    QLabel*      m_statusLabel;
+    SearchPattern m_lastPattern;
+};
+
+#endif // HEXSEARCHWIDGET_H
@@ -27,6 +27,13 @@ class QActionGroup;
 class QButtonGroup;
 class QAbstractButton;
 class QHexEdit;
+class HexSearchWidget;
+class ValueScannerDock;
+class FlagDiffDock;
+class DataInspectorModel;
+class FileJob;
+class QProgressBar;
+class QPushButton;
 class NewFileDialog;
 class FileInfoDialog;
 class SettingsManager;
@@ -46,6 +53,8 @@ public:
     explicit MainWindow(QWidget *parent = 0);
     ~MainWindow();
     SkywardSwordFile* gameFile();
+    // Loads in the background, gameFile() changes once the file is open
+    void openFile(const QString& filename);
 
 public slots:
     void updateInfo();
@@ -76,6 +85,14 @@ private slots:
     void closeEvent(QCloseEvent* e);
     void onExport();
     void onImport();
+    void onScannerAddressActivated(int game, int offset);
+    void onFlagDiffAddressActivated(int game, int offset);
+    void onCompare();
+    void onRecordTrace(bool record);
+    void onSaveTrace();
+    void onFileJobProgress(int percent, const QString& stage);
+    void onFileJobFinished();
+    void onCancelFileJob();
 
 private:
     bool askOnClose();
@@ -87,9 +104,17 @@ private:
     QTimer* m_checkTimer;
     void setRegion(SkywardSwordFile::Region);
     void setupHexEdit();
+    void setupTools();
     void setupActions();
     void setupConnections();
     void setupFileConnections();
+    void setupFileJobs();
+    void startFileJob(FileJob* job);
+    void finishFileJob(FileJob* job);
+    void finishOpen(FileJob* job);
+    void finishSave(FileJob* job);
+    void waitForFileJob();
+    void setFileJobRunning(bool running);
     Ui::MainWindow*           m_ui;
     QString                   m_oldFilename;
     SkywardSwordFile*         m_gameFile;
@@ -99,11 +124,19 @@ private:
     QActionGroup*             m_gameGroup;
     QFileSystemWatcher*       m_fileWatcher;
     QHexEdit*                 m_hexEdit;
+    HexSearchWidget*          m_hexSearch;
     NewFileDialog*            m_newFileDialog;
     FileInfoDialog*           m_fileInfoDialog;
     PreferencesDialog*        m_preferencesDialog;
     SettingsManager*          m_settingsManager;
     PlayTimeWidget*           m_playTime;
+    ValueScannerDock*         m_valueScanner;
+    FlagDiffDock*             m_flagDiff;
+    DataInspectorModel*       m_inspectorModel;
+    FileJob*                  m_fileJob;
+    QString                   m_filenameBeforeSave;
+    QProgressBar*             m_jobProgress;
+    QPushButton*              m_jobCancelBtn;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,60 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef PHASETIMER_H
+#define PHASETIMER_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+// Sums the time a thread spends in each phase of opening and saving a file
+// and of updating the main window, for the cycle and UI benchmarks.
+// Disabled by default. The hot paths mark their phases with
+// TRACE_PHASE_SCOPE from tracer.h, whose scope adds its time here;
+// PHASE_SCOPE only stands in for it when tracing is compiled out. Scopes of
+// different phases must not nest or the inner time is counted twice.
+class PhaseTimer
+{
+public:
+    enum Phase
+    {
+        IoPhase,
+        CryptoPhase,
+        ChecksumPhase,
+        UpdateInfoPhase,    //!< MainWindow::updateInfo
+        HexPaintPhase,      //!< QHexEditPrivate::paintEvent
+        PhaseCount
+    };
+
+    explicit PhaseTimer(Phase phase);
+    ~PhaseTimer();
+
+    static void   setEnabled(bool enabled);
+    static bool   isEnabled();
+    static void   reset();              //!< The calling thread's totals
+    static qint64 elapsed(Phase phase); //!< In ns, for the calling thread
+    static void   add(Phase phase, qint64 ns);
+
+private:
+    Phase         m_phase;
+    bool          m_running;
+    QElapsedTimer m_timer;
+};
+
+#define PHASE_TIMER_CONCAT2(a, b) a##b
+#define PHASE_TIMER_CONCAT(a, b)  PHASE_TIMER_CONCAT2(a, b)
+#define PHASE_SCOPE(phase) PhaseTimer PHASE_TIMER_CONCAT(phaseTimer, __LINE__)(PhaseTimer::phase)
+
+#endif // PHASETIMER_H
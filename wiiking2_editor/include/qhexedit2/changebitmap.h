@@ -0,0 +1,48 @@
+#ifndef CHANGEBITMAP_H
+#define CHANGEBITMAP_H
+
+/** \cond docNever */
+
+#include <QtCore>
+
+/*! ChangeBitmap keeps the changed state of every byte in QHexEdit as one bit.
+The bits are stored in 64 bit words, so setting or clearing a range and
+looking for the next or previous changed byte work a word at a time. Insert
+and remove shift the bits behind the position, which is also done word wise.
+
+Bits at and above size() are always zero.
+*/
+class ChangeBitmap
+{
+public:
+    ChangeBitmap();
+
+    void reset(int size);                   // size bits, all clear
+    int size() const;
+
+    bool testBit(int i) const;
+    void setRange(int from, int length, bool state);
+    void insert(int pos, int length, bool state);
+    void remove(int pos, int length);
+
+    int nextSet(int from) const;            // first set bit >= from, -1 if none
+    int nextClear(int from) const;          // first clear bit >= from, size() if none
+    int previousSet(int from) const;        // last set bit <= from, -1 if none
+    int previousClear(int from) const;      // last clear bit <= from, -1 if none
+
+    QByteArray toBytes(int from, int length) const;     // one 0/1 byte per bit
+    void setBytes(int from, const QByteArray & states);
+
+private:
+    quint64 bits(int pos, int count) const;
+    void setBits(int pos, int count, quint64 value);
+    void moveBits(int to, int from, int count);
+    void clearTail();
+
+    QVector<quint64> _words;
+    int _size;
+};
+
+/** \endcond docNever */
+
+#endif // CHANGEBITMAP_H
@@ -0,0 +1,50 @@
+#ifndef DIFFENGINE_H
+#define DIFFENGINE_H
+
+/** \cond docNever */
+
+#include <QtCore>
+
+/*! DiffRange is a run of bytes which differ between two buffers.
+*/
+struct DiffRange
+{
+    int start;
+    int length;
+
+    int end() const { return start + length; }
+};
+
+/*! DiffEngine compares two buffers and keeps the differing bytes as a sorted
+list of DiffRange runs. The compare runs 16 bytes at a time, equal blocks are
+skipped with a single test. After an edit only the touched area is compared
+again and spliced into the existing runs. If the buffers have different sizes
+the bytes behind the shorter one count as different.
+*/
+class DiffEngine
+{
+public:
+    DiffEngine();
+
+    void compute(const QByteArray & left, const QByteArray & right);
+    void update(const QByteArray & left, const QByteArray & right, int index, int length);
+    void clear();
+
+    const QVector<DiffRange> & ranges() const;
+    int differentBytes() const;
+
+    int rangeAt(int pos) const;             // index of the range containing pos, -1 if none
+    int nextRange(int pos) const;           // first range starting behind pos, -1 if none
+    int previousRange(int pos) const;       // last range starting before pos, -1 if none
+
+private:
+    static void scan(const uchar *left, const uchar *right, int from, int to, QVector<DiffRange> & out);
+
+    QVector<DiffRange> _ranges;
+    int _leftSize;
+    int _rightSize;
+};
+
+/** \endcond docNever */
+
+#endif // DIFFENGINE_H
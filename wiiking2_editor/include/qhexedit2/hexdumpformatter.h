@@ -0,0 +1,61 @@
+#ifndef HEXDUMPFORMATTER_H
+#define HEXDUMPFORMATTER_H
+
+/** \cond docNever */
+
+#include <QtCore>
+
+/*! HexDumpFormatter turns binary data into text. The output is built in a
+preallocated buffer from precomputed hex pair and ascii tables, there is no
+allocation per byte or per line. Large ranges can be streamed to a
+QIODevice in chunks, so the whole text never has to be in memory.
+
+The styles are
+- HexDump: address, 16 hex bytes and ascii per line (the classic dump)
+- HexBytes: "xx " per byte, 16 per line, the format paste understands
+- CArray: a "const unsigned char data[] = { 0x.., };" definition
+- PythonBytes: a parenthesised run of b"\x.." literals
+- Base64: MIME style, 76 characters per line
+*/
+class HexDumpFormatter
+{
+public:
+    enum Style
+    {
+        HexDump,
+        HexBytes,
+        CArray,
+        PythonBytes,
+        Base64
+    };
+
+    enum { BYTES_PER_LINE = 16 };
+    enum { CHUNK_SIZE = 64 * 1024 };        // input bytes per streamed chunk
+
+    explicit HexDumpFormatter(Style style = HexDump);
+
+    void setStyle(Style style);
+    Style style() const;
+    void setAddressOffset(int offset);      // added to addresses in HexDump
+    void setAddressWidth(int width);        // minimum number of address digits
+
+    // index is the position of data[0] in the whole buffer, it places the
+    // line breaks and addresses
+    QByteArray format(const char *data, int size, int index = 0) const;
+    bool write(QIODevice *device, const char *data, int size, int index = 0) const;
+
+private:
+    int maxOutputSize(int size) const;
+    int header(char *out, int size) const;
+    int body(char *out, const uchar *data, int size, int index) const;
+    int footer(char *out, int size) const;
+    int chunkSize() const;
+
+    Style _style;
+    int _addressOffset;
+    int _addressWidth;
+};
+
+/** \endcond docNever */
+
+#endif // HEXDUMPFORMATTER_H
@@ -0,0 +1,47 @@
+#ifndef INTERVALTREE_H
+#define INTERVALTREE_H
+
+/** \cond docNever */
+
+#include <QtCore>
+
+/*! IntervalTree answers which of a set of half open intervals [start, end)
+overlap a position or a range. The intervals are kept sorted by start in a
+flat array, which is read as an implicit balanced tree: the middle element
+of every subrange is its root. Each root also stores the largest end of its
+subrange, so whole subtrees ending before the query are skipped. A query
+costs O(log n + k) for k reported intervals.
+*/
+class IntervalTree
+{
+public:
+    IntervalTree();
+
+    // Replaces all intervals, id is what the queries report
+    void build(const QVector<int> & starts, const QVector<int> & ends);
+    void clear();
+    bool isEmpty() const;
+
+    void overlapping(int from, int to, QVector<int> & ids) const;
+    void containing(int pos, QVector<int> & ids) const;
+
+private:
+    struct Node
+    {
+        int start;
+        int end;
+        int id;
+        int maxEnd;                         // largest end in the subtree rooted here
+
+        bool operator<(const Node & other) const { return start < other.start; }
+    };
+
+    int buildMaxEnd(int lo, int hi);
+    void query(int lo, int hi, int from, int to, QVector<int> & ids) const;
+
+    QVector<Node> _nodes;
+};
+
+/** \endcond docNever */
+
+#endif // INTERVALTREE_H
@@ -0,0 +1,99 @@
+#ifndef QHEXDIFFVIEW_H
+#define QHEXDIFFVIEW_H
+
+#include <QWidget>
+#include <QMap>
+#include "qhexedit.h"
+#include "diffengine.h"
+
+class QLabel;
+class QPushButton;
+
+/*! QHexDiffView shows two buffers side by side in two QHexEdit widgets. Bytes
+which differ are highlighted in both editors (QHexEdit::diffColor), the views
+scroll together and the cursor can jump to the next or previous difference.
+
+Both sides stay editable. After every edit only the bytes touched by it are
+compared again, so typing stays fast even when the buffers are large.
+
+Known fields can be registered with addField(), the name of the field under
+the current difference is then shown in the status line.
+*/
+class QHexDiffView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /*! Creates an instance of QHexDiffView.
+    \param parent Parent widget of QHexDiffView.
+    */
+    QHexDiffView(QWidget *parent = 0);
+
+    /*! Sets the two buffers to compare and computes all differences. */
+    void setData(const QByteArray & left, const QByteArray & right);
+
+    /*! Sets the captions shown above the left and the right editor. */
+    void setLabels(const QString & left, const QString & right);
+
+    /*! Registers a named field of length bytes at offset. Fields must not
+    overlap, a later field with the same offset replaces the earlier one.
+    */
+    void addField(int offset, int length, const QString & name);
+
+    /*! Removes all fields registered with addField(). */
+    void clearFields();
+
+    /*! Returns the name of the field containing offset, an empty string
+    if there is none.
+    */
+    QString fieldAt(int offset) const;
+
+    /*! \cond docNever */
+    QHexEdit *leftEdit() const;
+    QHexEdit *rightEdit() const;
+    QByteArray leftData() const;
+    QByteArray rightData() const;
+    const DiffEngine & diff() const;
+    /*! \endcond docNever */
+
+public slots:
+    /*! Moves the cursor of both editors to the next difference. */
+    void nextDifference();
+
+    /*! Moves the cursor of both editors to the previous difference. */
+    void previousDifference();
+
+signals:
+    /*! Emitted whenever the set of differences changes. */
+    void differencesChanged(int ranges, int bytes);
+
+private slots:
+    void onBytesChanged(int index, int length);
+    void onCurrentAddressChanged(int address);
+
+private:
+    /*! \cond docNever */
+    struct Field
+    {
+        int length;
+        QString name;
+    };
+
+    void showDifference(int rangeIdx);
+    void refresh();
+    void updateStatus(int address);
+
+    QHexEdit *_left;
+    QHexEdit *_right;
+    QLabel *_leftLabel;
+    QLabel *_rightLabel;
+    QLabel *_statusLabel;
+    QPushButton *_prevButton;
+    QPushButton *_nextButton;
+
+    DiffEngine _diff;
+    QMap<int, Field> _fields;               // keyed by offset
+    /*! \endcond docNever */
+};
+
+#endif // QHEXDIFFVIEW_H
@@ -37,6 +37,9 @@ characters will be ignored.
 
 QHexEdit comes with undo/redo functionality. All changes can be undone, by
 pressing the undo-key (usually ctr-z). They can also be redone afterwards.
+Consecutive single byte edits are merged into one step. The history is
+bounded in memory (16 MB by default, see undoEngine()), when it grows
+beyond that the oldest steps are dropped.
 The undo/redo framework is cleared, when setData() sets up a new
 content for the editor. You can search data inside the content with indexOf()
 and lastIndexOf(). The replace() function is to change located subdata. This
@@ -83,6 +86,17 @@ more.
     */
     Q_PROPERTY(QColor selectionColor READ selectionColor WRITE setSelectionColor)
 
+    /*! Property search hit color sets (setSearchHitColor()) the background
+    color of the matches found by findAll(). You can also read the color
+    (searchHitColor()).
+    */
+    Q_PROPERTY(QColor searchHitColor READ searchHitColor WRITE setSearchHitColor)
+
+    /*! Property diff color sets (setDiffColor()) the background color of the
+    ranges passed to setDiffRanges(). You can also read the color (diffColor()).
+    */
+    Q_PROPERTY(QColor diffColor READ diffColor WRITE setDiffColor)
+
     /*! Property overwrite mode sets (setOverwriteMode()) or gets (overwriteMode()) the mode
     in which the editor works. In overwrite mode the user will overwrite existing data. The
     size of data will be constant. In insert mode the size will grow, when inserting
@@ -118,6 +132,11 @@ public:
     */
     int indexOf(const QByteArray & ba, int from = 0) const;
 
+    /*! Same as indexOf(const QByteArray &, int), but searches for a
+    SearchPattern, which may contain wildcard nibbles or a typed value.
+    */
+    int indexOf(const SearchPattern & pattern, int from = 0) const;
+
     /*! Inserts a byte array.
     \param i Index position, where to insert
     \param ba byte array, which is to insert
@@ -143,6 +162,44 @@ public:
     */
     int lastIndexOf(const QByteArray & ba, int from = 0) const;
 
+    /*! Same as lastIndexOf(const QByteArray &, int), but searches for a
+    SearchPattern.
+    */
+    int lastIndexOf(const SearchPattern & pattern, int from = 0) const;
+
+    /*! Searches the whole content for pattern in a background thread. Every
+    match is highlighted, the positions are reported through searchHitsFound()
+    while the search runs and searchFinished() tells when it is done. A running
+    search is cancelled first.
+    */
+    void findAll(const SearchPattern & pattern);
+
+    /*! Stops a running findAll(). Matches found so far stay highlighted. */
+    void cancelFindAll();
+
+    /*! Cancels a running findAll() and removes all search highlights.
+    setData() does the same, the matches belong to the old data.
+    */
+    void clearSearchHits();
+
+    /*! Returns the start positions of all matches of the last findAll(). */
+    QList<int> searchHits();
+
+    /*! Marks the bytes which differ from a compared buffer. The ranges have to
+    be sorted and must not overlap, DiffEngine::ranges() gives them that way.
+    An empty vector removes the marks.
+    */
+    void setDiffRanges(const QVector<DiffRange> & ranges);
+
+    /*! Sets named fields which are drawn as colored overlay below the other
+    highlights. Hovering a field shows its name and range as tooltip. An empty
+    template removes the overlay.
+    */
+    void setStructTemplate(const StructTemplate & structTemplate);
+
+    /*! Returns the template set by setStructTemplate(). */
+    const StructTemplate & structTemplate() const;
+
     /*! Removes len bytes from the content.
     \param pos Index position, where to remove
     \param len Amount of bytes to remove
@@ -175,6 +232,10 @@ public:
     QColor highlightingColor();
     void setSelectionColor(QColor const &color);
     QColor selectionColor();
+    void setSearchHitColor(QColor const &color);
+    QColor searchHitColor();
+    void setDiffColor(QColor const &color);
+    QColor diffColor();
     void setOverwriteMode(bool);
     bool overwriteMode();
     void setReadOnly(bool);
@@ -185,11 +246,21 @@ public:
     void setInsertAllowed(bool);
     bool isInsertAllowed();
 
-    QUndoStack* undoStack() const;
+    UndoEngine* undoEngine() const;
 
     /*! \endcond docNever */
 
 public slots:
+    /*! Selects the next run of changed bytes behind the cursor. Returns
+      false if there is none.
+      */
+    bool nextChange();
+
+    /*! Selects the previous run of changed bytes before the cursor. Returns
+      false if there is none.
+      */
+    bool previousChange();
+
     /*! Redoes the last operation. If there is no operation to redo, i.e.
       there is no redo step in the undo/redo history, nothing happens.
       */
@@ -231,9 +302,24 @@ signals:
     /*! The signal is emited every time, the data is changed. */
     void dataChanged();
 
+    /*! Emited right before dataChanged() with the range of bytes the change
+    touched. After an insert or remove the range reaches to the end of data.
+    */
+    void bytesChanged(int index, int length);
+
     /*! The signal is emited every time, the overwrite mode is changed. */
     void overwriteModeChanged(bool state);
 
+    /*! Contains the next batch of positions found by findAll(). */
+    void searchHitsFound(const QList<int> & hits);
+
+    /*! The signal is emited when findAll() has searched all data. */
+    void searchFinished(int count);
+
+    /*! The signal is emited when the matches are removed, by
+    clearSearchHits() or by setData(). */
+    void searchCleared();
+
 private:
     /*! \cond docNever */
     QHexEditPrivate *qHexEdit_p;
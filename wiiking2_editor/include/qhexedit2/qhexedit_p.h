@@ -6,7 +6,10 @@
 
 #include <QtGui>
 #include "xbytearray.h"
-class QUndoStack;
+#include "searchengine.h"
+#include "diffengine.h"
+#include "structtemplate.h"
+class UndoEngine;
 class QScrollArea;
 
 class QHexEditPrivate : public QWidget
@@ -15,6 +18,7 @@ Q_OBJECT
 
 public:
     QHexEditPrivate(QScrollArea *parent);
+    ~QHexEditPrivate();
 
     void setAddressAreaColor(QColor const &color);
     QColor addressAreaColor();
@@ -43,12 +47,24 @@ public:
     void setInsertAllowed(bool);
     bool isInsertAllowed();
 
+    void setSearchHitColor(QColor const &color);
+    QColor searchHitColor();
+
+    void setDiffColor(QColor const &color);
+    QColor diffColor();
+    void setDiffRanges(const QVector<DiffRange> &ranges);
+
+    void setStructTemplate(const StructTemplate &structTemplate);
+    const StructTemplate & structTemplate() const;
+
     XByteArray & xData();
 
     int indexOf(const QByteArray & ba, int from = 0);
+    int indexOf(const SearchPattern & pattern, int from = 0);
     void insert(int index, const QByteArray & ba);
     void insert(int index, char ch);
     int lastIndexOf(const QByteArray & ba, int from = 0);
+    int lastIndexOf(const SearchPattern & pattern, int from = 0);
     void remove(int index, int len=1);
     void replace(int index, char ch);
     void replace(int index, const QByteArray & ba);
@@ -63,18 +79,34 @@ public:
     void undo();
     void redo();
 
+    bool nextChange();
+    bool previousChange();
+
     QString toRedableString();
     QString selectionToReadableString();
+    QString selectionToText(HexDumpFormatter::Style style);
+    bool exportSelection(const QString &fileName, HexDumpFormatter::Style style);
 
-    QUndoStack* undoStack() const;
+    UndoEngine* undoEngine() const;
+
+    void findAll(const SearchPattern & pattern);
+    void cancelFindAll();
+    void clearSearchHits();
+    QList<int> searchHits();
 
 signals:
     void currentAddressChanged(int address);
     void currentSizeChanged(int size);
     void dataChanged();
+    void bytesChanged(int index, int length);
     void overwriteModeChanged(bool state);
+    void searchHitsFound(const QList<int> & hits);
+    void searchFinished(int count);
+    void searchCleared();
 
 protected:
+    bool event(QEvent * event);
+    void contextMenuEvent(QContextMenuEvent * event);
     void keyPressEvent(QKeyEvent * event);
     void mouseMoveEvent(QMouseEvent * event);
     void mousePressEvent(QMouseEvent * event);
@@ -92,17 +124,23 @@ protected:
 
 private slots:
     void updateCursor();
+    void onSearchHitsFound(const QList<int> & hits);
+    void onSearchThreadFinished();
 
 private:
     void adjust();
     void ensureVisible();
+    void select(int index, int length, bool cursorAtEnd);
+    void emitDataChanged();                 // emits bytesChanged() for the dirty range and dataChanged()
 
     QColor _addressAreaColor;
     QColor _highlightingColor;
     QColor _selectionColor;
+    QColor _searchHitColor;
+    QColor _diffColor;
     QScrollArea *_scrollArea;
     QTimer _cursorTimer;
-    QUndoStack *_undoStack;
+    UndoEngine *_undoEngine;
 
     XByteArray _xData;                      // Hält den Inhalt des Hex Editors
 
@@ -125,6 +163,14 @@ private:
     int _selectionInit;                     // That's, where we pressed the mouse button
 
     int _size;
+
+    SearchThread *_searchThread;            // running find-all, NULL when idle
+    QVector<int> _searchHits;               // sorted start positions of find-all hits
+    int _searchHitLength;
+
+    QVector<DiffRange> _diffRanges;         // sorted runs differing from a compared buffer
+
+    StructTemplate _structTemplate;         // named fields drawn as overlay
 };
 
 /** \endcond docNever */
@@ -0,0 +1,107 @@
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+/** \cond docNever */
+
+#include <QtCore>
+
+/*! SearchPattern describes what QHexEdit looks for. A pattern is a sequence of
+bytes plus a mask of the same length; a mask nibble of 0 turns the
+corresponding data nibble into a wildcard. Patterns are built either from a
+hex string like "3F ?? 00 1?" or from a typed value, which is encoded in the
+big endian layout the Wii uses.
+*/
+class SearchPattern
+{
+public:
+    enum ValueType
+    {
+        HexBytes,
+        Int16Value,
+        Int32Value,
+        Int64Value,
+        FloatValue,
+        Utf16String
+    };
+
+    SearchPattern();
+
+    static SearchPattern fromBytes(const QByteArray & ba);
+    static SearchPattern fromHexString(const QString & text, bool *ok = 0);
+    // integers have to fit the width, as signed or unsigned values
+    static SearchPattern fromValue(ValueType type, const QString & text, bool *ok = 0);
+
+    bool isValid() const;
+    bool isMasked() const;
+    int length() const;
+
+    const QByteArray & bytes() const;       // already and-ed with mask()
+    const QByteArray & mask() const;
+
+private:
+    QByteArray _bytes;
+    QByteArray _mask;
+    bool _masked;
+};
+
+/*! SearchEngine finds a SearchPattern inside a block of memory.
+Exact patterns shorter than HORSPOOL_MIN_LENGTH are located with a SIMD filter
+on their first and last byte, longer ones with Boyer-Moore-Horspool. Masked
+patterns are filtered on their first fully specified byte and verified with a
+masked compare.
+*/
+class SearchEngine
+{
+public:
+    enum { HORSPOOL_MIN_LENGTH = 12 };
+
+    explicit SearchEngine(const SearchPattern & pattern = SearchPattern());
+
+    const SearchPattern & pattern() const;
+
+    int indexIn(const char *data, int size, int from = 0) const;
+    int lastIndexIn(const char *data, int size, int from) const;
+
+private:
+    int exactScan(const uchar *data, int size, int from) const;
+    int horspoolScan(const uchar *data, int size, int from) const;
+    int maskedScan(const uchar *data, int size, int from) const;
+    bool matchesAt(const uchar *data) const;
+
+    SearchPattern _pattern;
+    int _anchor;                            // first byte without wildcard, -1 if none
+    int _skip[256];                         // Horspool bad character shifts
+};
+
+/*! SearchThread runs a find-all in the background. The data is a shallow
+copy of the editor content, so the user can keep editing while the search
+runs. Hits are streamed in batches through hitsFound().
+*/
+class SearchThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    SearchThread(const QByteArray & data, const SearchPattern & pattern, QObject *parent = 0);
+
+    void cancel();
+    bool isCancelled() const;
+    int hitCount() const;
+
+signals:
+    void hitsFound(const QList<int> & hits);
+    void progress(int percent);
+
+protected:
+    void run();
+
+private:
+    QByteArray _data;
+    SearchEngine _engine;
+    mutable QAtomicInt _cancelled;
+    mutable QAtomicInt _hitCount;           // read by hitCount() from other threads
+};
+
+/** \endcond docNever */
+
+#endif // SEARCHENGINE_H
@@ -0,0 +1,46 @@
+#ifndef STRUCTTEMPLATE_H
+#define STRUCTTEMPLATE_H
+
+/** \cond docNever */
+
+#include <QtGui>
+#include "intervaltree.h"
+
+/*! StructField is a named region of the data, drawn in color. */
+struct StructField
+{
+    int offset;
+    int length;
+    QString name;
+    QColor color;
+};
+
+/*! StructTemplate is a set of StructFields which QHexEdit overlays on the
+data and names in tooltips. Fields may nest, the shortest field containing
+a byte wins. Lookups go through an IntervalTree, which is rebuilt on the
+first lookup after the fields changed.
+*/
+class StructTemplate
+{
+public:
+    StructTemplate();
+
+    void addField(int offset, int length, const QString & name, const QColor & color);
+    void clear();
+    bool isEmpty() const;
+    const QVector<StructField> & fields() const;
+
+    int fieldAt(int pos) const;             // index of the innermost field containing pos, -1 if none
+    void fieldsIn(int from, int to, QVector<int> & ids) const;
+
+private:
+    void ensureTree() const;
+
+    QVector<StructField> _fields;
+    mutable IntervalTree _tree;
+    mutable bool _treeValid;
+};
+
+/** \endcond docNever */
+
+#endif // STRUCTTEMPLATE_H
@@ -0,0 +1,91 @@
+#ifndef UNDOENGINE_H
+#define UNDOENGINE_H
+
+/** \cond docNever */
+
+#include <QtCore>
+
+#include "xbytearray.h"
+
+/*! UndoEngine provides undo/redo functionality in QHexEdit.
+Every edit is kept as a range delta: the position, the bytes it overwrote
+together with their changed state (packed to one bit per byte) and the bytes
+it wrote. The deltas of all entries live back to back in a single arena, so
+an entry costs its payload plus a few integers, no matter if it was a single
+keystroke or a large paste.
+
+Single byte edits which touch the previous single byte edit are merged into
+it, as long as the merged range stays below MERGE_LIMIT bytes. Typing a row
+of hex digits therefore undoes as one step. Merging stops after undo(),
+redo() and clear().
+
+The history is capped by memoryLimit(). When a new entry pushes the usage
+above the cap, the oldest entries are dropped and the arena is compacted
+once the dropped part makes up half of it. The newest entry is always kept,
+even if it alone is larger than the cap.
+*/
+class UndoEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Cmd {insert, remove, replace};
+    enum { MERGE_LIMIT = 16 };
+    enum { DEFAULT_MEMORY_LIMIT = 16 * 1024 * 1024 };
+
+    explicit UndoEngine(XByteArray * xData, QObject *parent = 0);
+
+    // Applies the edit to xData and records it. insert uses ba, remove uses
+    // len, replace overwrites ba.length() bytes at pos.
+    void push(Cmd cmd, int pos, const QByteArray & ba, int len, bool mergeable = false);
+
+    void undo();
+    void redo();
+    void clear();
+
+    bool canUndo() const;
+    bool canRedo() const;
+    int count() const;                      // recorded entries
+    int index() const;                      // entries currently applied
+
+    void setMemoryLimit(int bytes);
+    int memoryLimit() const;
+    int memoryUsage() const;                // payload plus bookkeeping of all entries
+
+signals:
+    void indexChanged(int index);
+    void memoryUsageChanged(int bytes);
+
+private:
+    struct Entry
+    {
+        int pos;
+        int oldLength;
+        int newLength;
+        int offset;                         // start of the payload in _arena
+        bool mergeable;
+    };
+
+    static int flagBytes(int length);
+    int payloadSize(const Entry & entry) const;
+    QByteArray oldBytes(const Entry & entry) const;
+    QByteArray oldFlags(const Entry & entry) const;
+    QByteArray newBytes(const Entry & entry) const;
+    void append(Entry entry, const QByteArray & oldBa, const QByteArray & oldChanged, const QByteArray & newBa);
+    bool mergeWithTop(const Entry & next, const QByteArray & oldBa, const QByteArray & oldChanged);
+    void truncate(int count);
+    void enforceLimit();
+    void apply(int pos, int removeLength, const QByteArray & ba);
+
+    XByteArray * _xData;
+    QByteArray _arena;
+    QVector<Entry> _entries;
+    int _arenaHead;                         // payload before this offset belongs to dropped entries
+    int _index;
+    int _memoryLimit;
+    bool _mergeBarrier;
+};
+
+/** \endcond docNever */
+
+#endif // UNDOENGINE_H
@@ -5,6 +5,9 @@
 
 #include <QtCore>
 
+#include "hexdumpformatter.h"
+#include "changebitmap.h"
+
 /*! XByteArray represents the content of QHexEcit.
 XByteArray comprehend the data itself and informations to store if it was
 changed. The QHexEdit component uses these informations to perform nice
@@ -32,6 +35,10 @@ public:
     QByteArray dataChanged(int i, int len);
     void setDataChanged(int i, bool state);
     void setDataChanged(int i, const QByteArray & state);
+    int nextChanged(int from);              // first changed byte >= from, -1 if none
+    int previousChanged(int from);          // last changed byte <= from, -1 if none
+    int changedRunStart(int from);          // one past the last unchanged byte <= from
+    int changedRunEnd(int from);            // first unchanged byte >= from
 
     int realAddressNumbers();
     int size();
@@ -47,6 +54,11 @@ public:
 
     QChar asciiChar(int index);
     QString toRedableString(int start=0, int end=-1);
+    QByteArray toText(HexDumpFormatter::Style style, int start=0, int end=-1);
+    bool writeText(QIODevice *device, HexDumpFormatter::Style style, int start=0, int end=-1);
+
+    // Range touched by insert/remove/replace since the last call, false if none
+    bool takeDirtyRange(int &index, int &length);
 
 signals:
 
@@ -54,12 +66,16 @@ public slots:
 
 private:
     QByteArray _data;
-    QByteArray _changedData;
+    ChangeBitmap _changedData;
 
     int _addressNumbers;                    // wanted width of address area
     int _addressOffset;                     // will be added to the real addres inside bytearray
     int _realAddressNumbers;                // real width of address area (can be greater then wanted width)
     int _oldSize;                           // size of data
+    int _dirtyBegin;                        // first modified byte, -1 if clean
+    int _dirtyEnd;                          // one past the last modified byte
+
+    void markDirty(int begin, int end);
 };
 
 /** \endcond docNever */
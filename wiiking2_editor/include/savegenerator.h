@@ -0,0 +1,77 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef SAVEGENERATOR_H
+#define SAVEGENERATOR_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// Builds synthetic but valid wiiking2.sav files for benchmarks. Every known
+// field of an occupied slot is randomised within the range the game uses,
+// the slots carry correct checksums and unoccupied slots are marked new.
+//
+// Save number n only depends on the seed, n and the settings, not on the
+// thread which built it, so a corpus can be rebuilt byte for byte from the
+// same command line.
+class SaveGenerator
+{
+public:
+    struct RegionWeight
+    {
+        quint32 Region;     //!< As SkywardSwordFile::Region
+        int     Weight;
+    };
+
+    explicit SaveGenerator(quint64 seed = 0);
+
+    void setSeed(quint64 seed);
+    quint64 seed() const;
+    // Chance of each slot holding an adventure, 0 to 100
+    void setOccupancy(int percent);
+    int occupancy() const;
+    // Regions are picked in proportion to their weights, NTSC-U only if
+    // none are set
+    void addRegion(quint32 region, int weight);
+    void setThreads(int count);            //!< 0 uses one thread per core
+
+    // Fills save (0xFBE0 bytes) with save number index
+    void generate(quint64 index, char* save) const;
+    QByteArray generate(quint64 index) const;
+
+    // Writes count saves as wiiking2-<index>.sav, returns false if any of
+    // them could not be written
+    bool run(const QString& outputDir, quint64 count);
+
+    quint64     written() const;
+    QStringList errors() const;
+
+private:
+    friend class GenerateTask;
+
+    quint32 pickRegion(quint64 random) const;
+    void    randomizeSlot(char* save, int slot, quint64 state) const;
+
+    quint64 m_seed;
+    int     m_occupancy;
+    int     m_threads;
+    QList<RegionWeight> m_regions;
+    int     m_totalWeight;
+    quint64 m_written;
+    QStringList m_errors;
+};
+
+#endif // SAVEGENERATOR_H
@@ -0,0 +1,59 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef SAVETEMPLATE_H
+#define SAVETEMPLATE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "slotlayout.h"
+
+// Prebuilt images for new saves. The empty wiiking2.sav of a region and the
+// slot of a fresh adventure are built once, checksums included, so creating
+// either is a single memcpy. The fields which differ between new saves, the
+// save time and the player name, are patched in afterwards and the slot
+// checksum is updated from the changed bytes only (Checksum::CRC32Patch).
+//
+// region is the game id from the file header ("SOUE", "SOUJ", "SOUP") read
+// as a little endian quint32, the values of SkywardSwordFile::Region.
+class SaveTemplate
+{
+public:
+    static const int SAVE_SIZE   = SaveLayout::SIZE;
+    static const int SLOT_COUNT  = SaveLayout::SLOT_COUNT;
+    static const int SLOT_OFFSET = SaveLayout::SLOT_OFFSET;
+
+    // Where Link wakes up in Skyloft
+    static const float START_POS_X;
+    static const float START_POS_Y;
+    static const float START_POS_Z;
+
+    static QByteArray emptyFile(quint32 region); //!< Three new slots, no skip data
+    static SlotLayout freshGame();               //!< Save time and name still zero
+
+    static void createFile(char* save, quint32 region);
+    static bool createGame(char* save, int index, quint64 saveTime, const QString& playerName = QString());
+
+    static bool setSaveTime(char* save, int index, quint64 saveTime);
+    static bool setPlayerName(char* save, int index, const QString& name);
+
+private:
+    static QByteArray buildEmptyFile(quint32 region);
+    static SlotLayout buildFreshGame();
+    static void patch(char* save, int index, void* field, const void* value, int size);
+};
+
+#endif // SAVETEMPLATE_H
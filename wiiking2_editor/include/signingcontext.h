@@ -0,0 +1,64 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef SIGNINGCONTEXT_H
+#define SIGNINGCONTEXT_H
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+
+// Everything needed to sign a data.bin with one console's keys. The NG
+// certificate, the NG public key and the signed AP certificate only depend
+// on the keys, so they are built once here and every save after that costs
+// one SHA-1 pass and one signature.
+class SigningContext
+{
+public:
+    static const int SIGNATURE_SIZE = 0x40;
+    static const int CERT_SIZE      = 0x180;
+    static const int TAIL_SIZE      = SIGNATURE_SIZE + 2 * CERT_SIZE;   //!< Follows the file data
+
+    SigningContext(quint32 ngId, quint32 ngKeyId, const QByteArray& ngPriv, const QByteArray& ngSig, const QByteArray& macAddr);
+
+    quint32    ngId() const;
+    QByteArray macAddress() const;
+    QByteArray publicKey() const;
+    QByteArray ngCert() const;
+    QByteArray apCert() const;
+
+    // Stamps NG id and MAC address into the Bk header of an encrypted
+    // data.bin, signs the Bk header and files and replaces the tail
+    bool signDataBin(QByteArray& dataBin, QString* error = NULL) const;
+
+    // Shared context for a key set, built on first request. Safe to call
+    // from any thread.
+    static QSharedPointer<const SigningContext> cached(quint32 ngId, quint32 ngKeyId, const QByteArray& ngPriv,
+                                                       const QByteArray& ngSig, const QByteArray& macAddr);
+
+private:
+    static QByteArray makeCert(const QByteArray& signer, const QByteArray& name, const quint8* signature,
+                               const quint8* priv, quint32 keyId);
+
+    quint32    m_ngId;
+    QByteArray m_ngPriv;
+    QByteArray m_macAddr;
+    QByteArray m_publicKey;
+    QByteArray m_ngCert;
+    QByteArray m_apCert;
+    QByteArray m_apPriv;
+};
+
+#endif // SIGNINGCONTEXT_H
@@ -25,6 +25,8 @@
 #include "WiiSave.hpp"
 #include "WiiBanner.hpp"
 #include "checksum.h"
+#include "databinreader.h"
+#include "slotlayout.h"
 
 class QDateTime;
 
@@ -41,30 +43,15 @@ struct PlayTime
     int Seconds;
 };
 
-struct Vector3
-{
-    float X;
-    float Y;
-    float Z;
-
-    Vector3(float x, float y, float z) : X(x), Y(y), Z(z)
-    {}
-};
-
 class SkywardSwordFile : public IGameFile
 {
     Q_OBJECT
 public:
-    // Default coords for new file
-    static const float DEFAULT_POS_X;
-    static const float DEFAULT_POS_Y;
-    static const float DEFAULT_POS_Z;
-
     enum Region
     {
-         NTSCURegion = 0x45554F53,
-         NTSCJRegion = 0x4A554F53,
-         PALRegion   = 0x50554F53
+         NTSCURegion = SaveLayout::NTSCURegion,
+         NTSCJRegion = SaveLayout::NTSCJRegion,
+         PALRegion   = SaveLayout::PALRegion
     };
     enum Bug
     {
@@ -165,6 +152,14 @@ public:
     void exportGame(const QString& filepath, Game game = GameNone, Region region = NTSCURegion);
     void deleteGame(Game game = GameNone);
     void deleteAllGames();
+    // Slots are copied verbatim and keep their checksum, each call emits
+    // modified() once per file it changed
+    bool copyGame(Game from, Game to);
+    bool copyGame(const SkywardSwordFile& source, Game from, Game to);
+    bool moveGame(Game from, Game to);
+    bool moveGame(SkywardSwordFile& source, Game from, Game to);
+    bool swapGames(Game first, Game second);
+    Game duplicateGame(Game from); //!< Into the first new slot, GameNone if there is none
     void updateChecksum();
     bool hasValidChecksum(); // for integrity checks
     bool isModified() const;
@@ -231,6 +226,9 @@ public:
     bool      isNight() const;
     void      setGameData(const QByteArray& data);
     QByteArray gameData();
+    QByteArray fileData() const;
+    SlotLayout slotLayout() const;
+    void      setSlotLayout(const SlotLayout& slot);
     quint8*   skipData() const;
     void      setSkipData(const quint8* data);
 
@@ -240,6 +238,7 @@ public:
     void      setData(char* data);
     bool      loadDataBin(const QString& filepath = "", Game game = Game1);
     bool      saveDataBin();
+    QString   lastError() const; //!< Why the last open() or save() failed, empty if it did not.
     QString   bannerTitle() const;
     QString   bannerSubtitle() const;
     const QPixmap banner() const;
@@ -371,18 +370,26 @@ private:
     quint32 quantity(bool isRight, int offset) const;
     void    setQuantity(bool isRight, int offset, quint32 val);
     uint    gameOffset() const;
+    BEView  slot() const;
+    SlotLayout* layout() const;
     QString readNullTermString(int offset) const;
     void    writeDataFile(const QString& filepath, char* data, quint64 len);
     void    writeNullTermString(const QString& val, int offset);
     bool    flag(quint32 offset, quint32 flag) const;
     void    setFlag(quint32 offset, quint32 flag, bool val);
+    bool    writeSignedDataBin();
+    static QByteArray dataBinTemplate(Region region, QString* error);
+    static QByteArray buildDataBinTemplate(Region region, QString* error);
     char*   m_data;
     QImage  m_bannerImage;
     QString m_filename;
     Game    m_game;
     bool    m_isOpen;
     bool    m_isDirty;
+    QString m_lastError;
     zelda::WiiSave* m_saveGame;
+    QByteArray m_dataBinImage; //!< data.bin as last read or written, still encrypted
+    DataBinReader::Banner m_dataBinBanner; //!< Of a data.bin loaded without libzelda, empty otherwise
     Checksum  m_checksumEngine;
 };
 
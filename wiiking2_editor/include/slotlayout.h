@@ -0,0 +1,176 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef SLOTLAYOUT_H
+#define SLOTLAYOUT_H
+
+#include <QtGlobal>
+#include <stddef.h>
+#include <string.h>
+
+#include "beview.h"
+
+// The layout of one 0x53C0 byte adventure slot. Code outside the save model
+// names offsets through offsetof(SlotLayout, ...) and the sizes through
+// SlotLayout::SIZE and SaveLayout. Every row is one of
+//
+//   FIELD(name, offset, type, label)
+//   ARRAY(name, offset, type, count, label)
+//   GAP(offset, size)                        bytes nobody has named yet
+//
+// in offset order without holes. SlotLayout, its offset checks and the
+// SAVE_FIELDS table in fieldnames.cpp are all generated from it.
+#define SLOT_LAYOUT(FIELD, ARRAY, GAP) \
+    FIELD(playTime,           0x0000, quint64, "Play Time") \
+    FIELD(saveTime,           0x0008, quint64, "Save Time") \
+    FIELD(playerPosition,     0x0010, Vector3, "Player Position") \
+    FIELD(playerRotation,     0x001C, Vector3, "Player Rotation") \
+    FIELD(cameraPosition,     0x0028, Vector3, "Camera Position") \
+    FIELD(cameraRotation,     0x0034, Vector3, "Camera Rotation") \
+    GAP(0x0040, 0x0894) \
+    ARRAY(playerName,         0x08D4, quint16, 8, "Player Name") \
+    GAP(0x08E4, 0x0012) \
+    FIELD(hornetFlags,        0x08F6, quint8,  "Bug Flags (Hornet)") \
+    GAP(0x08F7, 0x0007) \
+    FIELD(heroModeFlags,      0x08FE, quint8,  "Hero Mode") \
+    GAP(0x08FF, 0x0035) \
+    ARRAY(materialFlags,      0x0934, quint8,  4, "Material Flags") \
+    GAP(0x0938, 0x0009) \
+    FIELD(introFlags,         0x0941, quint8,  "Intro Viewed") \
+    GAP(0x0942, 0x00A2) \
+    ARRAY(equipmentFlags,     0x09E4, quint8,  11, "Sword / Equipment Flags") \
+    FIELD(walletFlags,        0x09EF, quint8,  "Wallets") \
+    GAP(0x09F0, 0x0002) \
+    ARRAY(itemFlags,          0x09F2, quint8,  10, "Bug / Item Flags") \
+    GAP(0x09FC, 0x0038) \
+    ARRAY(materialQuantities, 0x0A34, quint16, 8, "Material Quantities") \
+    ARRAY(bugQuantities,      0x0A44, quint16, 6, "Bug Quantities") \
+    FIELD(gratitudeCrystals,  0x0A50, quint16, "Gratitude Crystals") \
+    GAP(0x0A52, 0x000C) \
+    FIELD(rupees,             0x0A5E, quint16, "Rupees") \
+    FIELD(ammo,               0x0A60, quint32, "Ammo") \
+    GAP(0x0A64, 0x489E) \
+    FIELD(totalHP,            0x5302, quint16, "Total HP") \
+    FIELD(unknownHP,          0x5304, quint16, "Unknown HP") \
+    FIELD(currentHP,          0x5306, quint16, "Current HP") \
+    GAP(0x5308, 0x0001) \
+    FIELD(roomID,             0x5309, quint8,  "Room ID") \
+    GAP(0x530A, 0x0012) \
+    ARRAY(currentMap,         0x531C, char,    32, "Current Map") \
+    ARRAY(currentArea,        0x533C, char,    32, "Current Area") \
+    ARRAY(currentRoom,        0x535C, char,    32, "Current Room") \
+    GAP(0x537C, 0x0031) \
+    FIELD(newGame,            0x53AD, quint8,  "New Game") \
+    GAP(0x53AE, 0x0005) \
+    FIELD(night,              0x53B3, quint8,  "Night") \
+    GAP(0x53B4, 0x0008) \
+    FIELD(checksum,           0x53BC, quint32, "Checksum")
+
+#define SLOT_LAYOUT_FIELD(name, offset, type, label)        BEValue<type> name;
+#define SLOT_LAYOUT_ARRAY(name, offset, type, count, label) BEValue<type> name[count];
+#define SLOT_LAYOUT_GAP(offset, size)                       quint8 reserved##offset[size];
+
+// Laid directly over a slot of the save data, every member is made of
+// bytes so there is no padding and no alignment requirement. Copying,
+// comparing or clearing a whole slot is a single memcpy, memcmp or memset.
+struct SlotLayout
+{
+    enum { SIZE = 0x53C0 };
+
+    SLOT_LAYOUT(SLOT_LAYOUT_FIELD, SLOT_LAYOUT_ARRAY, SLOT_LAYOUT_GAP)
+
+    static SlotLayout fromData(const char* data)
+    {
+        SlotLayout slot;
+        memcpy(&slot, data, SIZE);
+        return slot;
+    }
+
+    void toData(char* data) const
+    {
+        memcpy(data, this, SIZE);
+    }
+
+    void clear()
+    {
+        memset(this, 0, SIZE);
+    }
+
+    bool operator==(const SlotLayout& other) const
+    {
+        return memcmp(this, &other, SIZE) == 0;
+    }
+
+    bool operator!=(const SlotLayout& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+#undef SLOT_LAYOUT_FIELD
+#undef SLOT_LAYOUT_ARRAY
+#undef SLOT_LAYOUT_GAP
+
+#define SLOT_LAYOUT_CHECK_FIELD(name, offset, type, label) \
+    static_assert(offsetof(SlotLayout, name) == offset, "SlotLayout::" #name " is not at " #offset);
+#define SLOT_LAYOUT_CHECK_ARRAY(name, offset, type, count, label) \
+    SLOT_LAYOUT_CHECK_FIELD(name, offset, type, label)
+#define SLOT_LAYOUT_CHECK_GAP(offset, size) \
+    static_assert(offsetof(SlotLayout, reserved##offset) == offset, "SLOT_LAYOUT has a hole before " #offset);
+
+SLOT_LAYOUT(SLOT_LAYOUT_CHECK_FIELD, SLOT_LAYOUT_CHECK_ARRAY, SLOT_LAYOUT_CHECK_GAP)
+static_assert(sizeof(SlotLayout) == SlotLayout::SIZE, "SLOT_LAYOUT does not add up to 0x53C0 bytes");
+
+#undef SLOT_LAYOUT_CHECK_FIELD
+#undef SLOT_LAYOUT_CHECK_ARRAY
+#undef SLOT_LAYOUT_CHECK_GAP
+
+// Bit fields inside the slot layout
+typedef BEBits<quint16, offsetof(SlotLayout, gratitudeCrystals), 3, 7> GratitudeCrystalField;
+typedef BEBits<quint32, offsetof(SlotLayout, ammo), 0, 7>  ArrowAmmoField;
+typedef BEBits<quint32, offsetof(SlotLayout, ammo), 7, 7>  BombAmmoField;
+typedef BEBits<quint32, offsetof(SlotLayout, ammo), 23, 7> SeedAmmoField;
+
+// wiiking2.sav: a header holding the region, the three slots, then the
+// data of skip.dat
+struct SaveLayout
+{
+    // The game id at the start of the file ("SOUE", "SOUJ", "SOUP") read as
+    // a little endian quint32
+    enum Region
+    {
+        NTSCURegion = 0x45554F53,
+        NTSCJRegion = 0x4A554F53,
+        PALRegion   = 0x50554F53
+    };
+
+    enum
+    {
+        SIZE        = 0xFBE0,
+        SLOT_OFFSET = 0x20,
+        SLOT_COUNT  = 3,
+        SKIP_OFFSET = SLOT_OFFSET + SLOT_COUNT * SlotLayout::SIZE,
+        SKIP_SIZE   = 0x80
+    };
+
+    static int slotOffset(int slot)
+    {
+        return SLOT_OFFSET + slot * SlotLayout::SIZE;
+    }
+};
+
+static_assert(SaveLayout::SKIP_OFFSET + SaveLayout::SKIP_SIZE == SaveLayout::SIZE, "SaveLayout does not add up to 0xFBE0 bytes");
+
+#endif // SLOTLAYOUT_H
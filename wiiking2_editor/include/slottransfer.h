@@ -0,0 +1,56 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef SLOTTRANSFER_H
+#define SLOTTRANSFER_H
+
+#include <QtGlobal>
+
+#include "slotlayout.h"
+
+// Copies, moves and swaps adventure slots inside or between save buffers,
+// a buffer being the 0xFBE0 bytes of a wiiking2.sav. The checksum of a slot
+// only covers the slot itself, so slots are copied verbatim and keep their
+// checksum, nothing is hashed again. Only a slot emptied by a move gets a
+// new one.
+//
+// Slot indices are 0 to SLOT_COUNT - 1, functions return false for any
+// other index.
+class SlotTransfer
+{
+public:
+    static const int SAVE_SIZE   = SaveLayout::SIZE;
+    static const int SLOT_COUNT  = SaveLayout::SLOT_COUNT;
+    static const int SLOT_OFFSET = SaveLayout::SLOT_OFFSET;
+
+    static SlotLayout*       slot(char* save, int index);
+    static const SlotLayout* slot(const char* save, int index);
+    static bool isNew(const char* save, int index);
+
+    static bool copy(const char* source, int from, char* target, int to);
+    // Copies, then empties the source slot
+    static bool move(char* source, int from, char* target, int to);
+    static bool swap(char* save, int first, int second);
+    // Copies into the first new slot, returns its index or -1 if there is
+    // none
+    static int  duplicate(char* save, int from);
+    // Zeroes the slot, marks it as new and updates its checksum
+    static bool clear(char* save, int index);
+
+private:
+    static bool isValid(int index);
+};
+
+#endif // SLOTTRANSFER_H
@@ -0,0 +1,74 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include "phasetimer.h"
+
+#include <QString>
+#include <QtGlobal>
+
+class QIODevice;
+
+// Records scoped events on the hot paths (opening and saving files,
+// data.bin crypto, checksums, the main window's updates) and writes them
+// as Chrome trace event JSON, which chrome://tracing and Perfetto open.
+//
+// Every thread records into a ring of its own, so a scope takes no lock;
+// a full ring overwrites its oldest events. Recording is off by default
+// and a disabled scope costs one flag test. Building with
+// DEFINES += WIIKING2_NO_TRACE removes the scopes altogether.
+//
+// A scope given a phase also adds its time to PhaseTimer while phase timing
+// is enabled, so a hot path needs a single marker for both.
+class Tracer
+{
+public:
+    enum { RING_SIZE = 1 << 14 };   //!< Events kept per thread
+
+    //! name is stored as a pointer, it must be a string literal
+    explicit Tracer(const char* name);
+    Tracer(const char* name, PhaseTimer::Phase phase);
+    ~Tracer();
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    static void clear();            //!< Drops the recorded events
+    static int  eventCount();       //!< Recorded events still in the rings
+
+    // Safe while other threads are recording, events they overwrite in the
+    // meantime are left out
+    static bool writeChromeTrace(QIODevice* device);
+    static bool save(const QString& filename);
+
+private:
+    const char*       m_name;
+    PhaseTimer::Phase m_phase;      //!< PhaseCount when not timing a phase
+    bool              m_recording;
+    qint64            m_start;      //!< In ns, -1 when neither is done
+};
+
+#define TRACER_CONCAT2(a, b) a##b
+#define TRACER_CONCAT(a, b)  TRACER_CONCAT2(a, b)
+#ifdef WIIKING2_NO_TRACE
+#define TRACE_SCOPE(name)
+#define TRACE_PHASE_SCOPE(name, phase) PHASE_SCOPE(phase)
+#else
+#define TRACE_SCOPE(name) Tracer TRACER_CONCAT(tracer, __LINE__)(name)
+#define TRACE_PHASE_SCOPE(name, phase) Tracer TRACER_CONCAT(tracer, __LINE__)(name, PhaseTimer::phase)
+#endif
+
+#endif // TRACER_H
@@ -0,0 +1,90 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef VALUESCANNER_H
+#define VALUESCANNER_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QList>
+
+// Narrows down the offset of an unknown value over successive snapshots of a
+// save, the way memory scanners do it. Every offset is one bit in a candidate
+// set, each scan clears the bits whose value doesn't match the predicate.
+class ValueScanner
+{
+public:
+    enum ValueType
+    {
+        UInt8Value,
+        UInt16Value,
+        UInt32Value,
+        FloatValue
+    };
+
+    enum Predicate
+    {
+        AnyValue,       //!< Only valid for the first scan, keeps every offset
+        EqualTo,
+        NotEqualTo,
+        GreaterThan,
+        LessThan,
+        Increased,
+        Decreased,
+        Changed,
+        Unchanged
+    };
+
+    ValueScanner();
+
+    void       reset();
+    bool       isStarted() const;
+
+    ValueType  valueType() const;
+    int        valueSize() const;
+    static int valueSize(ValueType type);
+
+    // Starts a new scan over snapshot. Only offsets aligned to the value size
+    // are considered when aligned is set. Both return false when an EqualTo
+    // or NotEqualTo value isn't representable in the type.
+    bool       firstScan(const QByteArray& snapshot, ValueType type, Predicate pred, double value = 0, bool aligned = false);
+    // Narrows the candidates with a later snapshot of the same size
+    bool       nextScan(const QByteArray& snapshot, Predicate pred, double value = 0);
+
+    int        candidateCount() const;
+    QList<int> candidates(int max = -1) const;
+    double     value(int offset) const;          //!< Value at offset in the last snapshot
+    double     previousValue(int offset) const;  //!< Value at offset in the snapshot before
+
+    static double decode(const uchar* data, ValueType type);
+    static QByteArray encode(double value, ValueType type);  //!< value has to be representable
+    // False for values the type would truncate or wrap, e.g. 256 or 1.5 as UInt8Value
+    static bool   isRepresentable(double value, ValueType type);
+
+private:
+    void filterEqual(const QByteArray& snapshot, double value, bool equal);
+    void filterUnchanged(const QByteArray& snapshot, bool unchanged);
+    void filterCompare(const QByteArray& snapshot, Predicate pred, double value);
+    void andBytesMask(QVector<quint64>& mask, const QVector<quint64>& byteMask, int shift) const;
+    void clearTail();
+
+    ValueType        m_type;
+    int              m_size;
+    QVector<quint64> m_candidates;
+    QByteArray       m_current;
+    QByteArray       m_previous;
+};
+
+#endif // VALUESCANNER_H
@@ -0,0 +1,73 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef VALUESCANNERDOCK_H
+#define VALUESCANNERDOCK_H
+
+#include <QDockWidget>
+#include "valuescanner.h"
+
+class SkywardSwordFile;
+class QComboBox;
+class QLineEdit;
+class QCheckBox;
+class QPushButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+class QLabel;
+
+class ValueScannerDock : public QDockWidget
+{
+    Q_OBJECT
+public:
+    static const int MAX_LISTED_RESULTS = 500;
+
+    explicit ValueScannerDock(QWidget *parent = 0);
+
+    void setGameFile(SkywardSwordFile* file);
+
+signals:
+    // game is -1 for offsets outside of the adventure slots
+    void addressActivated(int game, int offset);
+
+private slots:
+    void onFirstScan();
+    void onNextScan();
+    void onScanFiles();
+    void onReset();
+    void onPredicateChanged(int index);
+    void onItemActivated(QTreeWidgetItem* item);
+
+private:
+    bool currentValue(double& value);
+    ValueScanner::Predicate currentPredicate() const;
+    void updateResults();
+    QString formatValue(double value) const;
+
+    ValueScanner      m_scanner;
+    SkywardSwordFile* m_gameFile;
+    QComboBox*        m_typeCombo;
+    QCheckBox*        m_alignedCheck;
+    QComboBox*        m_predicateCombo;
+    QLineEdit*        m_valueEdit;
+    QPushButton*      m_firstScanBtn;
+    QPushButton*      m_nextScanBtn;
+    QPushButton*      m_scanFilesBtn;
+    QPushButton*      m_resetBtn;
+    QTreeWidget*      m_resultTree;
+    QLabel*           m_statusLabel;
+};
+
+#endif // VALUESCANNERDOCK_H
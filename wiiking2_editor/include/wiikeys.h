@@ -42,6 +42,9 @@ public:
 
     static WiiKeys*   instance();
 
+    // Reads a BootMii keys.bin without touching the shared instance
+    static bool readKeysFile(const QString& filepath, quint32* ngId, quint32* ngKeyId, QByteArray* ngPriv, QByteArray* ngSig);
+
 
 private:
     char*   m_ngPriv;
@@ -0,0 +1,30 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#ifndef WIITIME_H
+#define WIITIME_H
+
+#include <QDateTime>
+
+// The Wii counts time in ticks of its bus clock since 2000-01-01, in local
+// time
+const quint64 SECONDS_TO_2000  = 946684800LL;
+const quint64 TICKS_PER_SECOND = 60750000LL;
+
+quint64 getWiiTime();
+quint64 toWiiTime(QDateTime time);
+QDateTime fromWiiTime(quint64 wiiTime);
+
+#endif // WIITIME_H
@@ -0,0 +1,412 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "aes128.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <wmmintrin.h>
+#define AES128_AESNI
+#define AESNI_TARGET __attribute__((target("aes,sse2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <wmmintrin.h>
+#define AES128_AESNI
+#define AESNI_TARGET
+#endif
+
+// S-boxes and round tables, computed once at startup instead of pasting
+// 5 KiB of constants
+struct AesTables
+{
+    quint8  SBox[256];
+    quint8  InvSBox[256];
+    quint32 Te[4][256];
+    quint32 Td[4][256];
+
+    AesTables()
+    {
+        // walk the multiplicative group with generator 3, q is the inverse of p
+        quint8 p = 1, q = 1;
+        do
+        {
+            p = p ^ quint8(p << 1) ^ ((p & 0x80) ? 0x1B : 0);
+            q ^= q << 1;
+            q ^= q << 2;
+            q ^= q << 4;
+            if (q & 0x80)
+                q ^= 0x09;
+            quint8 x = q ^ rotl(q, 1) ^ rotl(q, 2) ^ rotl(q, 3) ^ rotl(q, 4);
+            SBox[p] = x ^ 0x63;
+        } while (p != 1);
+        SBox[0] = 0x63;
+
+        for (int i = 0; i < 256; i++)
+            InvSBox[SBox[i]] = quint8(i);
+
+        for (int i = 0; i < 256; i++)
+        {
+            quint8 s = SBox[i];
+            quint32 te = (quint32(mul(s, 2)) << 24) | (quint32(s) << 16) | (quint32(s) << 8) | mul(s, 3);
+            quint8 is = InvSBox[i];
+            quint32 td = (quint32(mul(is, 14)) << 24) | (quint32(mul(is, 9)) << 16) | (quint32(mul(is, 13)) << 8) | mul(is, 11);
+            for (int t = 0; t < 4; t++)
+            {
+                Te[t][i] = (te >> (8 * t)) | (t ? (te << (32 - 8 * t)) : 0);
+                Td[t][i] = (td >> (8 * t)) | (t ? (td << (32 - 8 * t)) : 0);
+            }
+        }
+    }
+
+    static quint8 rotl(quint8 x, int n)
+    {
+        return quint8((x << n) | (x >> (8 - n)));
+    }
+
+    static quint8 mul(quint8 a, quint8 b)
+    {
+        quint8 r = 0;
+        while (b)
+        {
+            if (b & 1)
+                r ^= a;
+            a = quint8(a << 1) ^ ((a & 0x80) ? 0x1B : 0);
+            b >>= 1;
+        }
+        return r;
+    }
+};
+
+static const AesTables TABLES;
+
+static inline quint32 load32(const quint8* p)
+{
+    return (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | p[3];
+}
+
+static inline void store32(quint8* p, quint32 v)
+{
+    p[0] = quint8(v >> 24);
+    p[1] = quint8(v >> 16);
+    p[2] = quint8(v >> 8);
+    p[3] = quint8(v);
+}
+
+static void encryptBlock(const quint32* rk, const quint8* in, quint8* out)
+{
+    const AesTables& T = TABLES;
+    quint32 s0 = load32(in)      ^ rk[0];
+    quint32 s1 = load32(in + 4)  ^ rk[1];
+    quint32 s2 = load32(in + 8)  ^ rk[2];
+    quint32 s3 = load32(in + 12) ^ rk[3];
+    for (int r = 1; r < 10; r++)
+    {
+        rk += 4;
+        quint32 t0 = T.Te[0][s0 >> 24] ^ T.Te[1][(s1 >> 16) & 0xFF] ^ T.Te[2][(s2 >> 8) & 0xFF] ^ T.Te[3][s3 & 0xFF] ^ rk[0];
+        quint32 t1 = T.Te[0][s1 >> 24] ^ T.Te[1][(s2 >> 16) & 0xFF] ^ T.Te[2][(s3 >> 8) & 0xFF] ^ T.Te[3][s0 & 0xFF] ^ rk[1];
+        quint32 t2 = T.Te[0][s2 >> 24] ^ T.Te[1][(s3 >> 16) & 0xFF] ^ T.Te[2][(s0 >> 8) & 0xFF] ^ T.Te[3][s1 & 0xFF] ^ rk[2];
+        quint32 t3 = T.Te[0][s3 >> 24] ^ T.Te[1][(s0 >> 16) & 0xFF] ^ T.Te[2][(s1 >> 8) & 0xFF] ^ T.Te[3][s2 & 0xFF] ^ rk[3];
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+    rk += 4;
+    const quint8* S = T.SBox;
+    store32(out,      (quint32(S[s0 >> 24]) << 24) ^ (quint32(S[(s1 >> 16) & 0xFF]) << 16) ^ (quint32(S[(s2 >> 8) & 0xFF]) << 8) ^ S[s3 & 0xFF] ^ rk[0]);
+    store32(out + 4,  (quint32(S[s1 >> 24]) << 24) ^ (quint32(S[(s2 >> 16) & 0xFF]) << 16) ^ (quint32(S[(s3 >> 8) & 0xFF]) << 8) ^ S[s0 & 0xFF] ^ rk[1]);
+    store32(out + 8,  (quint32(S[s2 >> 24]) << 24) ^ (quint32(S[(s3 >> 16) & 0xFF]) << 16) ^ (quint32(S[(s0 >> 8) & 0xFF]) << 8) ^ S[s1 & 0xFF] ^ rk[2]);
+    store32(out + 12, (quint32(S[s3 >> 24]) << 24) ^ (quint32(S[(s0 >> 16) & 0xFF]) << 16) ^ (quint32(S[(s1 >> 8) & 0xFF]) << 8) ^ S[s2 & 0xFF] ^ rk[3]);
+}
+
+static void decryptBlock(const quint32* rk, const quint8* in, quint8* out)
+{
+    const AesTables& T = TABLES;
+    quint32 s0 = load32(in)      ^ rk[0];
+    quint32 s1 = load32(in + 4)  ^ rk[1];
+    quint32 s2 = load32(in + 8)  ^ rk[2];
+    quint32 s3 = load32(in + 12) ^ rk[3];
+    for (int r = 1; r < 10; r++)
+    {
+        rk += 4;
+        quint32 t0 = T.Td[0][s0 >> 24] ^ T.Td[1][(s3 >> 16) & 0xFF] ^ T.Td[2][(s2 >> 8) & 0xFF] ^ T.Td[3][s1 & 0xFF] ^ rk[0];
+        quint32 t1 = T.Td[0][s1 >> 24] ^ T.Td[1][(s0 >> 16) & 0xFF] ^ T.Td[2][(s3 >> 8) & 0xFF] ^ T.Td[3][s2 & 0xFF] ^ rk[1];
+        quint32 t2 = T.Td[0][s2 >> 24] ^ T.Td[1][(s1 >> 16) & 0xFF] ^ T.Td[2][(s0 >> 8) & 0xFF] ^ T.Td[3][s3 & 0xFF] ^ rk[2];
+        quint32 t3 = T.Td[0][s3 >> 24] ^ T.Td[1][(s2 >> 16) & 0xFF] ^ T.Td[2][(s1 >> 8) & 0xFF] ^ T.Td[3][s0 & 0xFF] ^ rk[3];
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+    rk += 4;
+    const quint8* S = T.InvSBox;
+    store32(out,      (quint32(S[s0 >> 24]) << 24) ^ (quint32(S[(s3 >> 16) & 0xFF]) << 16) ^ (quint32(S[(s2 >> 8) & 0xFF]) << 8) ^ S[s1 & 0xFF] ^ rk[0]);
+    store32(out + 4,  (quint32(S[s1 >> 24]) << 24) ^ (quint32(S[(s0 >> 16) & 0xFF]) << 16) ^ (quint32(S[(s3 >> 8) & 0xFF]) << 8) ^ S[s2 & 0xFF] ^ rk[1]);
+    store32(out + 8,  (quint32(S[s2 >> 24]) << 24) ^ (quint32(S[(s1 >> 16) & 0xFF]) << 16) ^ (quint32(S[(s0 >> 8) & 0xFF]) << 8) ^ S[s3 & 0xFF] ^ rk[2]);
+    store32(out + 12, (quint32(S[s3 >> 24]) << 24) ^ (quint32(S[(s2 >> 16) & 0xFF]) << 16) ^ (quint32(S[(s1 >> 8) & 0xFF]) << 8) ^ S[s0 & 0xFF] ^ rk[3]);
+}
+
+static void expandKey(const quint8* key, quint32* enc, quint32* dec)
+{
+    static const quint32 RCON[10] =
+    {
+        0x01000000, 0x02000000, 0x04000000, 0x08000000, 0x10000000,
+        0x20000000, 0x40000000, 0x80000000, 0x1B000000, 0x36000000
+    };
+    const quint8* S = TABLES.SBox;
+
+    for (int i = 0; i < 4; i++)
+        enc[i] = load32(key + 4 * i);
+    for (int i = 4; i < 44; i++)
+    {
+        quint32 t = enc[i - 1];
+        if ((i & 3) == 0)
+            t = ((quint32(S[(t >> 16) & 0xFF]) << 24) | (quint32(S[(t >> 8) & 0xFF]) << 16) |
+                 (quint32(S[t & 0xFF]) << 8) | S[t >> 24]) ^ RCON[i / 4 - 1];
+        enc[i] = enc[i - 4] ^ t;
+    }
+
+    // decryption uses the rounds backwards, with InvMixColumns applied to
+    // the inner round keys
+    for (int r = 0; r <= 10; r++)
+        for (int j = 0; j < 4; j++)
+            dec[4 * r + j] = enc[4 * (10 - r) + j];
+    for (int i = 4; i < 40; i++)
+    {
+        quint32 w = dec[i];
+        dec[i] = TABLES.Td[0][S[w >> 24]] ^ TABLES.Td[1][S[(w >> 16) & 0xFF]] ^
+                 TABLES.Td[2][S[(w >> 8) & 0xFF]] ^ TABLES.Td[3][S[w & 0xFF]];
+    }
+}
+
+#ifdef AES128_AESNI
+static bool cpuHasAesNi()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 25)) != 0;
+#else
+    unsigned int a, b, c, d;
+    if (!__get_cpuid(1, &a, &b, &c, &d))
+        return false;
+    return (c & (1 << 25)) != 0;
+#endif
+}
+
+AESNI_TARGET static inline __m128i expandStep(__m128i key, __m128i assist)
+{
+    assist = _mm_shuffle_epi32(assist, 0xFF);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+AESNI_TARGET static void expandKeyNi(const quint8* key, quint8* enc, quint8* dec)
+{
+    __m128i k[11];
+    k[0]  = _mm_loadu_si128((const __m128i*)key);
+    // the round constant has to be an immediate
+    k[1]  = expandStep(k[0], _mm_aeskeygenassist_si128(k[0], 0x01));
+    k[2]  = expandStep(k[1], _mm_aeskeygenassist_si128(k[1], 0x02));
+    k[3]  = expandStep(k[2], _mm_aeskeygenassist_si128(k[2], 0x04));
+    k[4]  = expandStep(k[3], _mm_aeskeygenassist_si128(k[3], 0x08));
+    k[5]  = expandStep(k[4], _mm_aeskeygenassist_si128(k[4], 0x10));
+    k[6]  = expandStep(k[5], _mm_aeskeygenassist_si128(k[5], 0x20));
+    k[7]  = expandStep(k[6], _mm_aeskeygenassist_si128(k[6], 0x40));
+    k[8]  = expandStep(k[7], _mm_aeskeygenassist_si128(k[7], 0x80));
+    k[9]  = expandStep(k[8], _mm_aeskeygenassist_si128(k[8], 0x1B));
+    k[10] = expandStep(k[9], _mm_aeskeygenassist_si128(k[9], 0x36));
+
+    for (int r = 0; r <= 10; r++)
+    {
+        _mm_storeu_si128((__m128i*)(enc + 16 * r), k[r]);
+        __m128i d = (r == 0 || r == 10) ? k[10 - r] : _mm_aesimc_si128(k[10 - r]);
+        _mm_storeu_si128((__m128i*)(dec + 16 * r), d);
+    }
+}
+
+AESNI_TARGET static void encryptCbcNi(const quint8* keys, const quint8* in, quint8* out, quint64 blocks, quint8* iv)
+{
+    __m128i k[11];
+    for (int r = 0; r <= 10; r++)
+        k[r] = _mm_loadu_si128((const __m128i*)(keys + 16 * r));
+
+    // every block depends on the one before, so this runs one at a time
+    __m128i c = _mm_loadu_si128((const __m128i*)iv);
+    for (quint64 i = 0; i < blocks; i++)
+    {
+        __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + 16 * i)), c);
+        x = _mm_xor_si128(x, k[0]);
+        for (int r = 1; r < 10; r++)
+            x = _mm_aesenc_si128(x, k[r]);
+        c = _mm_aesenclast_si128(x, k[10]);
+        _mm_storeu_si128((__m128i*)(out + 16 * i), c);
+    }
+    _mm_storeu_si128((__m128i*)iv, c);
+}
+
+AESNI_TARGET static void decryptCbcNi(const quint8* keys, const quint8* in, quint8* out, quint64 blocks, quint8* iv)
+{
+    __m128i k[11];
+    for (int r = 0; r <= 10; r++)
+        k[r] = _mm_loadu_si128((const __m128i*)(keys + 16 * r));
+
+    // blocks are independent when decrypting, four are kept in flight to
+    // hide the latency of aesdec
+    __m128i prev = _mm_loadu_si128((const __m128i*)iv);
+    quint64 i = 0;
+    for (; i + 4 <= blocks; i += 4)
+    {
+        __m128i c0 = _mm_loadu_si128((const __m128i*)(in + 16 * i));
+        __m128i c1 = _mm_loadu_si128((const __m128i*)(in + 16 * i + 16));
+        __m128i c2 = _mm_loadu_si128((const __m128i*)(in + 16 * i + 32));
+        __m128i c3 = _mm_loadu_si128((const __m128i*)(in + 16 * i + 48));
+        __m128i x0 = _mm_xor_si128(c0, k[0]);
+        __m128i x1 = _mm_xor_si128(c1, k[0]);
+        __m128i x2 = _mm_xor_si128(c2, k[0]);
+        __m128i x3 = _mm_xor_si128(c3, k[0]);
+        for (int r = 1; r < 10; r++)
+        {
+            x0 = _mm_aesdec_si128(x0, k[r]);
+            x1 = _mm_aesdec_si128(x1, k[r]);
+            x2 = _mm_aesdec_si128(x2, k[r]);
+            x3 = _mm_aesdec_si128(x3, k[r]);
+        }
+        x0 = _mm_xor_si128(_mm_aesdeclast_si128(x0, k[10]), prev);
+        x1 = _mm_xor_si128(_mm_aesdeclast_si128(x1, k[10]), c0);
+        x2 = _mm_xor_si128(_mm_aesdeclast_si128(x2, k[10]), c1);
+        x3 = _mm_xor_si128(_mm_aesdeclast_si128(x3, k[10]), c2);
+        // in and out may alias, the ciphertext is already in registers
+        _mm_storeu_si128((__m128i*)(out + 16 * i),      x0);
+        _mm_storeu_si128((__m128i*)(out + 16 * i + 16), x1);
+        _mm_storeu_si128((__m128i*)(out + 16 * i + 32), x2);
+        _mm_storeu_si128((__m128i*)(out + 16 * i + 48), x3);
+        prev = c3;
+    }
+    for (; i < blocks; i++)
+    {
+        __m128i c = _mm_loadu_si128((const __m128i*)(in + 16 * i));
+        __m128i x = _mm_xor_si128(c, k[0]);
+        for (int r = 1; r < 10; r++)
+            x = _mm_aesdec_si128(x, k[r]);
+        _mm_storeu_si128((__m128i*)(out + 16 * i), _mm_xor_si128(_mm_aesdeclast_si128(x, k[10]), prev));
+        prev = c;
+    }
+    _mm_storeu_si128((__m128i*)iv, prev);
+}
+#endif
+
+Aes128::Aes128() :
+    m_backend(bestBackend())
+{
+    quint8 zero[KEY_SIZE];
+    memset(zero, 0, KEY_SIZE);
+    setKey(zero);
+}
+
+Aes128::Aes128(const quint8* key) :
+    m_backend(bestBackend())
+{
+    setKey(key);
+}
+
+void Aes128::setKey(const quint8* key)
+{
+    expandKey(key, m_encKey, m_decKey);
+#ifdef AES128_AESNI
+    if (isSupported(AesNiBackend))
+        expandKeyNi(key, m_niEncKey, m_niDecKey);
+#endif
+}
+
+void Aes128::encryptCbc(const quint8* in, quint8* out, quint64 length, quint8* iv) const
+{
+    quint64 blocks = length / BLOCK_SIZE;
+#ifdef AES128_AESNI
+    if (m_backend == AesNiBackend)
+    {
+        encryptCbcNi(m_niEncKey, in, out, blocks, iv);
+        return;
+    }
+#endif
+
+    quint8 chain[BLOCK_SIZE];
+    memcpy(chain, iv, BLOCK_SIZE);
+    for (quint64 i = 0; i < blocks; i++)
+    {
+        quint8 block[BLOCK_SIZE];
+        for (int j = 0; j < BLOCK_SIZE; j++)
+            block[j] = in[16 * i + j] ^ chain[j];
+        encryptBlock(m_encKey, block, chain);
+        memcpy(out + 16 * i, chain, BLOCK_SIZE);
+    }
+    memcpy(iv, chain, BLOCK_SIZE);
+}
+
+void Aes128::decryptCbc(const quint8* in, quint8* out, quint64 length, quint8* iv) const
+{
+    quint64 blocks = length / BLOCK_SIZE;
+#ifdef AES128_AESNI
+    if (m_backend == AesNiBackend)
+    {
+        decryptCbcNi(m_niDecKey, in, out, blocks, iv);
+        return;
+    }
+#endif
+
+    quint8 chain[BLOCK_SIZE];
+    memcpy(chain, iv, BLOCK_SIZE);
+    for (quint64 i = 0; i < blocks; i++)
+    {
+        quint8 cipher[BLOCK_SIZE];
+        quint8 plain[BLOCK_SIZE];
+        memcpy(cipher, in + 16 * i, BLOCK_SIZE);
+        decryptBlock(m_decKey, cipher, plain);
+        for (int j = 0; j < BLOCK_SIZE; j++)
+            out[16 * i + j] = plain[j] ^ chain[j];
+        memcpy(chain, cipher, BLOCK_SIZE);
+    }
+    memcpy(iv, chain, BLOCK_SIZE);
+}
+
+Aes128::Backend Aes128::backend() const
+{
+    return m_backend;
+}
+
+void Aes128::setBackend(Backend backend)
+{
+    m_backend = isSupported(backend) ? backend : PortableBackend;
+}
+
+Aes128::Backend Aes128::bestBackend()
+{
+    return isSupported(AesNiBackend) ? AesNiBackend : PortableBackend;
+}
+
+bool Aes128::isSupported(Backend backend)
+{
+    if (backend == PortableBackend)
+        return true;
+#ifdef AES128_AESNI
+    static const bool hasAesNi = cpuHasAesNi();
+    return hasAesNi;
+#else
+    return false;
+#endif
+}
+
+const char* Aes128::backendName(Backend backend)
+{
+    return backend == AesNiBackend ? "AES-NI" : "portable";
+}
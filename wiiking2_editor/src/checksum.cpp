@@ -113,6 +113,82 @@ quint32 Checksum::CRC32(const quint8 *data, quint64 pos, quint64 length )
    return CRC ^ 0xFFFFFFFF;
 }
 
+// CRC32 is linear apart from its initial and final xor, which only depend on
+// the length. So the CRCs of two messages of the same length differ by the
+// plain CRC (no initial or final xor) of their xor. That message is zero
+// apart from the changed bytes: the leading zeros leave the register at
+// zero and the trailing ones are skipped with shiftZeros().
+quint32 Checksum::CRC32Patch(quint32 crc, quint64 length, quint64 offset, const quint8* before, const quint8* after, quint64 count)
+{
+    quint32 diff = 0;
+    for (quint64 i = 0; i < count; i++)
+        diff = (diff >> 8) ^ m_crcTable[(diff ^ before[i] ^ after[i]) & 0xFF];
+
+    return crc ^ shiftZeros(diff, length - offset - count);
+}
+
+static const quint32 CRC32_REFLECTED = 0xEDB88320; // CRC32_POLYNOMIAL reflected
+
+// a * b modulo the CRC polynomial, both in the reflected bit order where
+// bit 31 is x^0
+static quint32 multModP(quint32 a, quint32 b)
+{
+    quint32 m = 1u << 31;
+    quint32 p = 0;
+    for (;;)
+    {
+        if (a & m)
+        {
+            p ^= b;
+            if ((a & (m - 1)) == 0)
+                break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ CRC32_REFLECTED : b >> 1;
+    }
+    return p;
+}
+
+// x^(2^n) modulo the polynomial for n = 0..31, built once at startup like
+// zlib's x2n_table. x^(2^32) is x again, so the table wraps around.
+struct X2nTable
+{
+    quint32 Powers[32];
+
+    X2nTable()
+    {
+        quint32 p = 1u << 30; // x^1
+        Powers[0] = p;
+        for (int n = 1; n < 32; n++)
+            Powers[n] = p = multModP(p, p);
+    }
+};
+
+static const X2nTable X2N_TABLE;
+
+// x^(n * 2^k) modulo the polynomial
+static quint32 x2nModP(quint64 n, int k)
+{
+    quint32 p = 1u << 31; // x^0
+    while (n)
+    {
+        if (n & 1)
+            p = multModP(X2N_TABLE.Powers[k & 31], p);
+        n >>= 1;
+        k++;
+    }
+    return p;
+}
+
+// Feeds count zero bytes into a CRC register: that multiplies it by
+// x^(8 * count), which takes one product per set bit of count
+quint32 Checksum::shiftZeros(quint32 crc, quint64 count)
+{
+    if (count == 0)
+        return crc;
+    return multModP(x2nModP(count, 3), crc);
+}
+
 quint16 Checksum::checksum16(const quint8 *data, quint64 pos, quint64 length)
 {
     quint16 sum = 0;
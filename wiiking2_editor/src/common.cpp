@@ -14,7 +14,7 @@
 // along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
 
 #include "common.h"
-#include <time.h>
+#include "tracer.h"
 #include <QtEndian>
 #include <QDebug>
 
@@ -63,6 +63,7 @@ int convertRGB5A3ToBitMap(quint8* tplbuf, quint8** bitmapdata, quint32 width, qu
 
 QImage convertTextureToImage( const QByteArray &ba, quint32 w, quint32 h )
 {
+    TRACE_SCOPE("convertTextureToImage");
     //qDebug() << "SaveBanner::ConvertTextureToImage" << ba.size() << hex << w << h;
     quint8* bitmapdata = NULL;//this will hold the converted image
     int ret = convertRGB5A3ToBitMap( (quint8*)ba.constData(), &bitmapdata, w, h );
@@ -77,55 +78,6 @@ QImage convertTextureToImage( const QByteArray &ba, quint32 w, quint32 h )
     return im2;
 }
 
-quint64 getWiiTime()
-{
-    time_t sysTime, tzDiff, tzDST;
-    struct tm * gmTime;
-
-    time(&sysTime);
-
-    // Account for DST where needed
-    gmTime = localtime(&sysTime);
-    if(gmTime->tm_isdst == 1)
-        tzDST = 3600;
-    else
-        tzDST = 0;
-
-    // Lazy way to get local time in sec
-    gmTime	= gmtime(&sysTime);
-    tzDiff = sysTime - mktime(gmTime);
-
-    return (quint64)(TICKS_PER_SECOND * ((sysTime + tzDiff + tzDST) - SECONDS_TO_2000));
-}
-
-quint64 toWiiTime(QDateTime time)
-{
-    time_t sysTime, tzDiff, tzDST;
-    struct tm * gmTime;
-
-    sysTime = time.toTime_t();
-    // Account for DST where needed
-    gmTime = localtime(&sysTime);
-    if (!gmTime)
-        return 0;
-    if(gmTime->tm_isdst == 1)
-        tzDST = 3600;
-    else
-        tzDST = 0;
-
-    // Lazy way to get local time in sec
-    gmTime	= gmtime(&sysTime);
-    tzDiff = sysTime - mktime(gmTime);
-
-    return (quint64)(TICKS_PER_SECOND * ((sysTime + tzDiff + tzDST) - SECONDS_TO_2000));
-}
-
-QDateTime fromWiiTime(quint64 wiiTime)
-{
-    QDateTime tmp(QDate(2000, 1, 1));
-    tmp = tmp.addSecs(wiiTime / TICKS_PER_SECOND);
-    return tmp;
-}
 
 
 
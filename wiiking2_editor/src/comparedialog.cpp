@@ -0,0 +1,173 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "comparedialog.h"
+#include "skywardswordfile.h"
+#include "fieldnames.h"
+#include "qhexedit2/qhexdiffview.h"
+
+#include <QComboBox>
+#include <QPushButton>
+#include <QLabel>
+#include <QDialogButtonBox>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+
+CompareDialog::CompareDialog(SkywardSwordFile* gameFile, QWidget *parent) :
+    QDialog(parent),
+    m_gameFile(gameFile),
+    m_otherFile(NULL),
+    m_applied(false)
+{
+    setWindowTitle(tr("Compare Adventures"));
+    resize(1100, 600);
+
+    m_leftCombo  = new QComboBox(this);
+    m_rightCombo = new QComboBox(this);
+    for (int i = 0; i < SkywardSwordFile::GameCount; i++)
+        m_leftCombo->addItem(sourceName(i), i);
+    fillRightSources();
+    m_openOtherBtn = new QPushButton(tr("Open Other Save..."), this);
+
+    m_diffView = new QHexDiffView(this);
+    for (int i = 0; i < SAVE_FIELD_COUNT; i++)
+        m_diffView->addField(SAVE_FIELDS[i].Offset, SAVE_FIELDS[i].Length, QString(SAVE_FIELDS[i].Name));
+
+    m_buttonBox = new QDialogButtonBox(QDialogButtonBox::Apply | QDialogButtonBox::Close, Qt::Horizontal, this);
+    m_buttonBox->button(QDialogButtonBox::Apply)->setToolTip(tr("Writes the edited adventures of the open file back"));
+
+    QHBoxLayout* sourceLayout = new QHBoxLayout;
+    sourceLayout->addWidget(new QLabel(tr("Left:"), this));
+    sourceLayout->addWidget(m_leftCombo, 1);
+    sourceLayout->addWidget(new QLabel(tr("Right:"), this));
+    sourceLayout->addWidget(m_rightCombo, 1);
+    sourceLayout->addWidget(m_openOtherBtn);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addLayout(sourceLayout);
+    layout->addWidget(m_diffView, 1);
+    layout->addWidget(m_buttonBox);
+
+    // Start with the current adventure against the next one
+    int game = qMax(0, (int)m_gameFile->game());
+    m_leftCombo->setCurrentIndex(game);
+    m_rightCombo->setCurrentIndex((game + 1) % SkywardSwordFile::GameCount);
+    onSourceChanged();
+
+    connect(m_leftCombo,    SIGNAL(currentIndexChanged(int)),      this, SLOT(onSourceChanged()));
+    connect(m_rightCombo,   SIGNAL(currentIndexChanged(int)),      this, SLOT(onSourceChanged()));
+    connect(m_openOtherBtn, SIGNAL(clicked()),                     this, SLOT(onOpenOther()));
+    connect(m_buttonBox,    SIGNAL(clicked(QAbstractButton*)),     this, SLOT(onButtonClicked(QAbstractButton*)));
+    connect(m_buttonBox,    SIGNAL(rejected()),                    this, SLOT(reject()));
+}
+
+CompareDialog::~CompareDialog()
+{
+    delete m_otherFile;
+}
+
+bool CompareDialog::applied() const
+{
+    return m_applied;
+}
+
+void CompareDialog::onOpenOther()
+{
+    QString filename = QFileDialog::getOpenFileName(this, tr("Open save to compare with"), QString(),
+                                                    tr("Skyward Sword Saves (*.sav *.bin)"));
+    if (filename.isEmpty())
+        return;
+
+    SkywardSwordFile* file = new SkywardSwordFile(filename);
+    if (!file->isOpen())
+    {
+        QMessageBox::warning(this, tr("Error"), tr("Could not open %1").arg(filename));
+        delete file;
+        return;
+    }
+
+    delete m_otherFile;
+    m_otherFile = file;
+
+    m_rightCombo->blockSignals(true);
+    fillRightSources();
+    m_rightCombo->setCurrentIndex(m_leftCombo->currentIndex() + SkywardSwordFile::GameCount);
+    m_rightCombo->blockSignals(false);
+    onSourceChanged();
+}
+
+void CompareDialog::onSourceChanged()
+{
+    int left  = m_leftCombo->itemData(m_leftCombo->currentIndex()).toInt();
+    int right = m_rightCombo->itemData(m_rightCombo->currentIndex()).toInt();
+    m_diffView->setLabels(sourceName(left), sourceName(right));
+    m_diffView->setData(sourceData(left), sourceData(right));
+}
+
+void CompareDialog::onButtonClicked(QAbstractButton* button)
+{
+    if (m_buttonBox->buttonRole(button) != QDialogButtonBox::ApplyRole)
+        return;
+
+    // Only the open file is written, the other save stays untouched
+    int left  = m_leftCombo->itemData(m_leftCombo->currentIndex()).toInt();
+    int right = m_rightCombo->itemData(m_rightCombo->currentIndex()).toInt();
+    writeGame(left, m_diffView->leftData());
+    if (right < SkywardSwordFile::GameCount && right != left)
+        writeGame(right, m_diffView->rightData());
+    m_applied = true;
+}
+
+QByteArray CompareDialog::sourceData(int source)
+{
+    SkywardSwordFile* file = (source < SkywardSwordFile::GameCount) ? m_gameFile : m_otherFile;
+    if (!file)
+        return QByteArray();
+
+    SkywardSwordFile::Game oldGame = file->game();
+    file->setGame((SkywardSwordFile::Game)(source % SkywardSwordFile::GameCount));
+    QByteArray data = file->gameData();
+    file->setGame(oldGame);
+    return data;
+}
+
+QString CompareDialog::sourceName(int source) const
+{
+    if (source < SkywardSwordFile::GameCount)
+        return tr("Adventure %1").arg(source + 1);
+
+    QString name = m_otherFile ? QFileInfo(m_otherFile->filename()).fileName() : QString();
+    return tr("Adventure %1 (%2)").arg(source - SkywardSwordFile::GameCount + 1).arg(name);
+}
+
+void CompareDialog::fillRightSources()
+{
+    m_rightCombo->clear();
+    int count = m_otherFile ? SkywardSwordFile::GameCount * 2 : SkywardSwordFile::GameCount;
+    for (int i = 0; i < count; i++)
+        m_rightCombo->addItem(sourceName(i), i);
+}
+
+void CompareDialog::writeGame(int game, const QByteArray& data)
+{
+    SkywardSwordFile::Game oldGame = m_gameFile->game();
+    m_gameFile->setGame((SkywardSwordFile::Game)game);
+    m_gameFile->setGameData(data);
+    m_gameFile->updateChecksum();
+    m_gameFile->setGame(oldGame);
+}
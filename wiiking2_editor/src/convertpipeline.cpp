@@ -0,0 +1,576 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "convertpipeline.h"
+#include "databincodec.h"
+#include "databinreader.h"
+#include "databinresigner.h"
+#include "slotlayout.h"
+#include "tracer.h"
+
+#include <QAtomicInt>
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtEndian>
+
+static const int SAVE_SIZE   = SaveLayout::SIZE;
+static const int SKIP_OFFSET = SaveLayout::SKIP_OFFSET;
+static const int SKIP_SIZE   = SaveLayout::SKIP_SIZE;
+
+// What load() accepts, checked from the size and the Bk header only
+static bool isInputFile(const QString& path, ConvertPipeline::Direction direction)
+{
+    QFile file(path);
+    if (direction == ConvertPipeline::SavToDataBin)
+        return file.size() == SAVE_SIZE;
+
+    if (!file.open(QFile::ReadOnly) || !file.seek(DataBinCodec::HEADER_SIZE))
+        return false;
+    QByteArray bk = file.read(DataBinCodec::BK_HEADER_SIZE);
+    return bk.size() == int(DataBinCodec::BK_HEADER_SIZE) && DataBinCodec::isBkHeader((const quint8*)bk.constData());
+}
+
+struct ConvertItem
+{
+    int        Index;
+    QString    Input;
+    QString    Output;
+    QByteArray Data;
+    int        DuplicateOf;     //!< Index of the first identical input, -1 if none
+    bool       Skipped;         //!< Not the kind of file the direction reads
+    QString    Error;
+};
+
+// Blocks the producer when full and the consumer when empty, pop() returns
+// false once the queue is closed and drained
+class ConvertQueue
+{
+public:
+    explicit ConvertQueue(int capacity)
+        : m_capacity(qMax(1, capacity)),
+          m_closed(false),
+          m_maxDepth(0),
+          m_depthSum(0),
+          m_pushes(0)
+    {
+    }
+
+    void push(const ConvertItem& item)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_items.size() >= m_capacity)
+            m_notFull.wait(&m_mutex);
+        m_items.enqueue(item);
+        m_maxDepth = qMax(m_maxDepth, m_items.size());
+        m_depthSum += m_items.size();
+        m_pushes++;
+        m_notEmpty.wakeOne();
+    }
+
+    bool pop(ConvertItem* item)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_items.isEmpty() && !m_closed)
+            m_notEmpty.wait(&m_mutex);
+        if (m_items.isEmpty())
+            return false;
+        *item = m_items.dequeue();
+        m_notFull.wakeOne();
+        return true;
+    }
+
+    void close()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_closed = true;
+        m_notEmpty.wakeAll();
+    }
+
+    int maxDepth() const
+    {
+        return m_maxDepth;
+    }
+
+    double averageDepth() const
+    {
+        return m_pushes > 0 ? double(m_depthSum) / m_pushes : 0.0;
+    }
+
+private:
+    QMutex             m_mutex;
+    QWaitCondition     m_notFull;
+    QWaitCondition     m_notEmpty;
+    QQueue<ConvertItem> m_items;
+    int                m_capacity;
+    bool               m_closed;
+    int                m_maxDepth;
+    qint64             m_depthSum;
+    qint64             m_pushes;
+};
+
+// State of one ConvertPipeline::run() shared by all stage threads
+class ConvertRun
+{
+public:
+    enum Stage
+    {
+        ReadStage,
+        WorkStage
+    };
+
+    ConvertRun(ConvertPipeline* pipeline, const QStringList& inputs, const QStringList& outputs,
+               int readers, int workers)
+        : Pipeline(pipeline),
+          Inputs(inputs),
+          Outputs(outputs),
+          WorkQueue(pipeline->m_queueCapacity),
+          WriteQueue(pipeline->m_queueCapacity),
+          NextInput(0),
+          LiveReaders(readers),
+          LiveWorkers(workers)
+    {
+        BusyNs[ReadStage] = BusyNs[WorkStage] = 0;
+        Items[ReadStage] = Items[WorkStage] = 0;
+        EndNs[ReadStage] = EndNs[WorkStage] = 0;
+        Clock.start();
+    }
+
+    void read()
+    {
+        QElapsedTimer timer;
+        qint64 busy = 0;
+        int items = 0;
+        int index;
+        while ((index = NextInput.fetchAndAddOrdered(1)) < Inputs.size())
+        {
+            timer.start();
+            ConvertItem item = load(index);
+            busy += timer.nsecsElapsed();
+            items++;
+            WorkQueue.push(item);
+        }
+        finish(ReadStage, busy, items, &LiveReaders, &WorkQueue);
+    }
+
+    void work()
+    {
+        QElapsedTimer timer;
+        qint64 busy = 0;
+        int items = 0;
+        ConvertItem item;
+        while (WorkQueue.pop(&item))
+        {
+            timer.start();
+            if (!item.Skipped && item.DuplicateOf < 0 && item.Error.isEmpty())
+                convert(item);
+            busy += timer.nsecsElapsed();
+            items++;
+            WriteQueue.push(item);
+        }
+        finish(WorkStage, busy, items, &LiveWorkers, &WriteQueue);
+    }
+
+    ConvertPipeline*  Pipeline;
+    QStringList       Inputs;
+    QStringList       Outputs;
+    ConvertQueue      WorkQueue;
+    ConvertQueue      WriteQueue;
+    QAtomicInt        NextInput;
+    QAtomicInt        LiveReaders;
+    QAtomicInt        LiveWorkers;
+    QElapsedTimer     Clock;
+
+    QMutex            StatsMutex;
+    qint64            BusyNs[2];
+    int               Items[2];
+    qint64            EndNs[2];
+
+private:
+    ConvertItem load(int index)
+    {
+        TRACE_SCOPE("ConvertPipeline::load");
+        ConvertItem item;
+        item.Index = index;
+        item.Input = Inputs[index];
+        item.DuplicateOf = -1;
+        item.Skipped = false;
+        item.Output = Outputs[index];
+
+        bool toDataBin = (Pipeline->m_direction == ConvertPipeline::SavToDataBin);
+
+        QFile file(item.Input);
+        if (!file.open(QFile::ReadOnly))
+        {
+            item.Error = QString("Unable to open %1").arg(item.Input);
+            return item;
+        }
+        item.Data = file.readAll();
+
+        // Decide by content what the file is
+        if (toDataBin)
+            item.Skipped = (item.Data.size() != SAVE_SIZE);
+        else
+            item.Skipped = (item.Data.size() < int(DataBinCodec::HEADER_SIZE + DataBinCodec::BK_HEADER_SIZE) ||
+                            !DataBinCodec::isBkHeader((const quint8*)item.Data.constData() + DataBinCodec::HEADER_SIZE));
+        if (item.Skipped)
+        {
+            item.Data.clear();
+            return item;
+        }
+
+        QByteArray hash = QCryptographicHash::hash(item.Data, QCryptographicHash::Sha1);
+        QMutexLocker locker(&HashMutex);
+        if (Seen.contains(hash))
+        {
+            item.DuplicateOf = Seen.value(hash);
+            item.Data.clear();
+        }
+        else
+            Seen.insert(hash, index);
+        return item;
+    }
+
+    void convert(ConvertItem& item)
+    {
+        TRACE_SCOPE("ConvertPipeline::convert");
+        if (Pipeline->m_direction == ConvertPipeline::DataBinToSav)
+        {
+            QBuffer buffer(&item.Data);
+            buffer.open(QIODevice::ReadOnly);
+            DataBinReader reader(&buffer);
+            QByteArray save;
+            if (!reader.open())
+                item.Error = reader.errorString();
+            else if ((save = reader.readFile("wiiking2.sav")).size() != SAVE_SIZE)
+                item.Error = "No wiiking2.sav in the backup";
+            buffer.close();
+            item.Data = save;
+            return;
+        }
+
+        quint32 region = qFromLittleEndian<quint32>((const quint8*)item.Data.constData());
+        if (!Pipeline->m_templates.contains(region))
+        {
+            item.Error = QString("No template for %1").arg(QString::fromLatin1(item.Data.left(4)));
+            return;
+        }
+
+        ConvertPipeline::Template tmpl = Pipeline->m_templates.value(region);
+        QByteArray image = tmpl.Image;
+        DataBinCodec codec;
+        if (!codec.replaceEncryptedFile(image, tmpl.Save, item.Data))
+        {
+            item.Error = "The template has no wiiking2.sav";
+            return;
+        }
+        if (tmpl.Skip.Size == quint32(SKIP_SIZE))
+            codec.replaceEncryptedFile(image, tmpl.Skip, item.Data.mid(SKIP_OFFSET, SKIP_SIZE));
+        if (Pipeline->m_context->signDataBin(image, &item.Error))
+            item.Data = image;
+    }
+
+    void finish(Stage stage, qint64 busy, int items, QAtomicInt* live, ConvertQueue* output)
+    {
+        {
+            QMutexLocker locker(&StatsMutex);
+            BusyNs[stage] += busy;
+            Items[stage] += items;
+        }
+        // the last thread of a stage closes the queue behind it
+        if (!live->deref())
+        {
+            QMutexLocker locker(&StatsMutex);
+            EndNs[stage] = Clock.nsecsElapsed();
+            output->close();
+        }
+    }
+
+    QMutex                 HashMutex;
+    QHash<QByteArray, int> Seen;
+};
+
+class ConvertTask : public QRunnable
+{
+public:
+    ConvertTask(ConvertRun* run, ConvertRun::Stage stage)
+        : m_run(run),
+          m_stage(stage)
+    {
+    }
+
+    void run()
+    {
+        if (m_stage == ConvertRun::ReadStage)
+            m_run->read();
+        else
+            m_run->work();
+    }
+
+private:
+    ConvertRun*       m_run;
+    ConvertRun::Stage m_stage;
+};
+
+ConvertPipeline::ConvertPipeline(Direction direction)
+    : m_direction(direction),
+      m_readerThreads(2),
+      m_workerThreads(0),
+      m_queueCapacity(32),
+      m_converted(0),
+      m_duplicates(0)
+{
+}
+
+ConvertPipeline::Direction ConvertPipeline::direction() const
+{
+    return m_direction;
+}
+
+void ConvertPipeline::setSigningContext(QSharedPointer<const SigningContext> context)
+{
+    m_context = context;
+}
+
+bool ConvertPipeline::addTemplate(const QString& dataBin, QString* error)
+{
+    DataBinReader reader(dataBin);
+    if (!reader.open())
+    {
+        if (error)
+            *error = reader.errorString();
+        return false;
+    }
+    int index = reader.indexOf("wiiking2.sav");
+    if (index < 0 || reader.files()[index].Size != quint32(SAVE_SIZE))
+    {
+        if (error)
+            *error = QString("%1 is not a Skyward Sword backup").arg(dataBin);
+        return false;
+    }
+    Template tmpl;
+    tmpl.Save = reader.files()[index];
+    tmpl.Skip.Size = 0;
+    int skip = reader.indexOf("skip.dat");
+    if (skip >= 0)
+        tmpl.Skip = reader.files()[skip];
+    QByteArray gameId = reader.gameId().toLatin1();
+    reader.close();
+
+    QFile file(dataBin);
+    if (gameId.size() != 4 || !file.open(QFile::ReadOnly))
+    {
+        if (error)
+            *error = QString("Unable to read %1").arg(dataBin);
+        return false;
+    }
+    tmpl.Image = file.readAll();
+    m_templates.insert(qFromLittleEndian<quint32>((const quint8*)gameId.constData()), tmpl);
+    return true;
+}
+
+void ConvertPipeline::setReaderThreads(int count)
+{
+    m_readerThreads = count;
+}
+
+void ConvertPipeline::setWorkerThreads(int count)
+{
+    m_workerThreads = count;
+}
+
+void ConvertPipeline::setQueueCapacity(int count)
+{
+    m_queueCapacity = count;
+}
+
+bool ConvertPipeline::run(const QString& inputDir, const QString& outputDir)
+{
+    m_converted = 0;
+    m_duplicates = 0;
+    m_errors.clear();
+    m_stats.clear();
+
+    if (m_direction == SavToDataBin && (m_context.isNull() || m_templates.isEmpty()))
+    {
+        m_errors << "Converting to data.bin needs keys and at least one template";
+        return false;
+    }
+
+    QDir input(inputDir);
+    QStringList inputs;
+    foreach (const QString& name, input.entryList(QDir::Files, QDir::Name))
+        inputs << input.filePath(name);
+
+    // a.sav and a.dat would both be written to a.bin, the second one
+    // silently replacing the first
+    bool toDataBin = (m_direction == SavToDataBin);
+    QStringList outputNames;
+    QHash<QString, QString> owners;
+    foreach (const QString& path, inputs)
+    {
+        QString output = QDir(outputDir).filePath(QFileInfo(path).completeBaseName() + (toDataBin ? ".bin" : ".sav"));
+        outputNames << output;
+        if (!isInputFile(path, m_direction))
+            continue;
+        if (owners.contains(output))
+            m_errors << QString("%1 and %2 would both be written to %3").arg(owners.value(output)).arg(path).arg(output);
+        else
+            owners.insert(output, path);
+    }
+    if (!m_errors.isEmpty())
+        return false;
+
+    if (!QDir().mkpath(outputDir))
+    {
+        m_errors << QString("Unable to create %1").arg(outputDir);
+        return false;
+    }
+
+    int readers = qBound(1, m_readerThreads, qMax(1, inputs.size()));
+    int workers = m_workerThreads > 0 ? m_workerThreads : QThread::idealThreadCount();
+
+    ConvertRun state(this, inputs, outputNames, readers, workers);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(readers + workers);
+    for (int i = 0; i < readers; i++)
+        pool.start(new ConvertTask(&state, ConvertRun::ReadStage));
+    for (int i = 0; i < workers; i++)
+        pool.start(new ConvertTask(&state, ConvertRun::WorkStage));
+
+    // Writer, results arrive out of order and are put back in input order
+    QElapsedTimer timer;
+    qint64 writeBusy = 0;
+    int written = 0;
+    int maxPending = 0;
+    qint64 pendingSum = 0;
+    QMap<int, ConvertItem> pending;
+    QVector<QString> outputs(inputs.size());
+    QList<ConvertItem> duplicates;
+    int next = 0;
+    ConvertItem item;
+    while (state.WriteQueue.pop(&item))
+    {
+        pending.insert(item.Index, item);
+        maxPending = qMax(maxPending, pending.size());
+        pendingSum += pending.size();
+        while (pending.contains(next))
+        {
+            ConvertItem current = pending.take(next++);
+            if (current.Skipped)
+                continue;
+            if (!current.Error.isEmpty())
+            {
+                m_errors << QString("%1: %2").arg(current.Input).arg(current.Error);
+                continue;
+            }
+            // the first copy may come later in the order, copy at the end
+            if (current.DuplicateOf >= 0)
+            {
+                duplicates << current;
+                continue;
+            }
+
+            timer.start();
+            QString error;
+            if (DataBinResigner::writeFile(current.Output, current.Data, &error))
+            {
+                outputs[current.Index] = current.Output;
+                m_converted++;
+            }
+            else
+                m_errors << error;
+            writeBusy += timer.nsecsElapsed();
+            written++;
+        }
+    }
+    pool.waitForDone();
+
+    foreach (const ConvertItem& dup, duplicates)
+    {
+        timer.start();
+        QString firstOutput = outputs[dup.DuplicateOf];
+        QString error;
+        QFile source(firstOutput);
+        if (firstOutput.isEmpty() || !source.open(QFile::ReadOnly))
+            m_errors << QString("%1: the identical file %2 failed").arg(dup.Input).arg(inputs[dup.DuplicateOf]);
+        else if (!DataBinResigner::writeFile(dup.Output, source.readAll(), &error))
+            m_errors << error;
+        else
+            m_duplicates++;
+        writeBusy += timer.nsecsElapsed();
+        written++;
+    }
+
+    const char* names[2] = { "read", "convert" };
+    ConvertQueue* queues[2] = { &state.WorkQueue, &state.WriteQueue };
+    int threads[2] = { readers, workers };
+    for (int s = 0; s < 2; s++)
+    {
+        StageStats stats;
+        stats.Name = names[s];
+        stats.Items = state.Items[s];
+        stats.BusyNs = state.BusyNs[s];
+        stats.WallNs = state.EndNs[s];
+        stats.Threads = threads[s];
+        stats.MaxQueueDepth = queues[s]->maxDepth();
+        stats.AverageQueueDepth = queues[s]->averageDepth();
+        m_stats << stats;
+    }
+    StageStats writer;
+    writer.Name = "write";
+    writer.Items = written;
+    writer.BusyNs = writeBusy;
+    writer.WallNs = state.Clock.nsecsElapsed();
+    writer.Threads = 1;
+    writer.MaxQueueDepth = maxPending;
+    writer.AverageQueueDepth = inputs.isEmpty() ? 0.0 : double(pendingSum) / inputs.size();
+    m_stats << writer;
+
+    return m_converted + m_duplicates > 0 || inputs.isEmpty();
+}
+
+int ConvertPipeline::converted() const
+{
+    return m_converted;
+}
+
+int ConvertPipeline::duplicates() const
+{
+    return m_duplicates;
+}
+
+QStringList ConvertPipeline::errors() const
+{
+    return m_errors;
+}
+
+QList<ConvertPipeline::StageStats> ConvertPipeline::stats() const
+{
+    return m_stats;
+}
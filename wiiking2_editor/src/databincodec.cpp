@@ -0,0 +1,230 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "databincodec.h"
+#include "tracer.h"
+
+#include <QtEndian>
+#include <string.h>
+
+static const quint8 SD_KEY[16] =
+{
+    0xAB, 0x01, 0xB9, 0xD8, 0xE1, 0x62, 0x2B, 0x08,
+    0xAF, 0xBA, 0xD8, 0x4D, 0xBF, 0xC2, 0xA5, 0x5D
+};
+
+static const quint8 SD_IV[16] =
+{
+    0x21, 0x67, 0x12, 0xE6, 0xAA, 0x1F, 0x68, 0x9F,
+    0x95, 0xC5, 0xA2, 0x23, 0x24, 0xDC, 0x6A, 0x98
+};
+
+DataBinCodec::DataBinCodec() :
+    m_aes(SD_KEY)
+{
+}
+
+bool DataBinCodec::decrypt(QByteArray& data)
+{
+    return process(data, false);
+}
+
+bool DataBinCodec::encrypt(QByteArray& data)
+{
+    return process(data, true);
+}
+
+void DataBinCodec::decryptHeader(quint8* data) const
+{
+    quint8 iv[Aes128::BLOCK_SIZE];
+    memcpy(iv, SD_IV, sizeof(iv));
+    m_aes.decryptCbc(data, data, HEADER_SIZE, iv);
+}
+
+void DataBinCodec::encryptHeader(quint8* data) const
+{
+    quint8 iv[Aes128::BLOCK_SIZE];
+    memcpy(iv, SD_IV, sizeof(iv));
+    m_aes.encryptCbc(data, data, HEADER_SIZE, iv);
+}
+
+void DataBinCodec::decryptFile(const FileEntry& entry, quint8* data) const
+{
+    quint8 iv[Aes128::BLOCK_SIZE];
+    memcpy(iv, entry.Iv.constData(), sizeof(iv));
+    m_aes.decryptCbc(data, data, storedSize(entry), iv);
+}
+
+void DataBinCodec::encryptFile(const FileEntry& entry, quint8* data) const
+{
+    quint8 iv[Aes128::BLOCK_SIZE];
+    memcpy(iv, entry.Iv.constData(), sizeof(iv));
+    m_aes.encryptCbc(data, data, storedSize(entry), iv);
+}
+
+bool DataBinCodec::replaceEncryptedFile(QByteArray& image, const FileEntry& entry, const QByteArray& contents) const
+{
+    TRACE_SCOPE("DataBinCodec::replaceEncryptedFile");
+    quint32 stored = storedSize(entry);
+    if (entry.Type != 1 || entry.Size != quint32(contents.size()) || entry.Offset + stored > quint32(image.size()))
+        return false;
+
+    quint8* payload = (quint8*)image.data() + entry.Offset;
+    QByteArray plain(stored, 0);
+    quint8* buf = (quint8*)plain.data();
+
+    // In CBC a block only needs the one before it, so the padding is
+    // decrypted on its own
+    quint32 tail = entry.Size & ~quint32(Aes128::BLOCK_SIZE - 1);
+    quint8 iv[Aes128::BLOCK_SIZE];
+    if (tail < stored)
+    {
+        memcpy(iv, tail == 0 ? (const quint8*)entry.Iv.constData() : payload + tail - Aes128::BLOCK_SIZE, sizeof(iv));
+        m_aes.decryptCbc(payload + tail, buf + tail, stored - tail, iv);
+    }
+    memcpy(buf, contents.constData(), contents.size());
+
+    memcpy(iv, entry.Iv.constData(), sizeof(iv));
+    m_aes.encryptCbc(buf, payload, stored, iv);
+    return true;
+}
+
+bool DataBinCodec::replaceFile(QByteArray& data, const QString& name, const QByteArray& contents) const
+{
+    QString bare = name.startsWith('/') ? name.mid(1) : name;
+    foreach (const FileEntry& entry, m_files)
+    {
+        if (entry.Type != 1 || entry.Name != bare)
+            continue;
+        if (entry.Size != quint32(contents.size()) || entry.Offset + entry.Size > quint32(data.size()))
+            return false;
+        memcpy(data.data() + entry.Offset, contents.constData(), contents.size());
+        return true;
+    }
+    return false;
+}
+
+QList<DataBinCodec::FileEntry> DataBinCodec::files() const
+{
+    return m_files;
+}
+
+QString DataBinCodec::errorString() const
+{
+    return m_error;
+}
+
+Aes128::Backend DataBinCodec::backend() const
+{
+    return m_aes.backend();
+}
+
+void DataBinCodec::setBackend(Aes128::Backend backend)
+{
+    m_aes.setBackend(backend);
+}
+
+bool DataBinCodec::isBkHeader(const quint8* header)
+{
+    return qFromBigEndian<quint32>(header) == 0x70 && qFromBigEndian<quint16>(header + 4) == 0x426B;
+}
+
+bool DataBinCodec::parseFileHeader(const quint8* header, quint32 offset, FileEntry* entry)
+{
+    if (qFromBigEndian<quint32>(header) != FILE_MAGIC)
+        return false;
+
+    entry->Size        = qFromBigEndian<quint32>(header + 4);
+    entry->Permissions = header[8];
+    entry->Attributes  = header[9];
+    entry->Type        = header[0x0A];
+    entry->Name        = QString::fromLatin1((const char*)header + 0x0B, qstrnlen((const char*)header + 0x0B, 0x45));
+    entry->Offset      = offset + FILE_HEADER_SIZE;
+    entry->Iv          = QByteArray((const char*)header + 0x50, Aes128::BLOCK_SIZE);
+    return true;
+}
+
+quint32 DataBinCodec::storedSize(const FileEntry& entry)
+{
+    return (entry.Type == 1) ? ((entry.Size + 63) & ~63) : 0;
+}
+
+bool DataBinCodec::process(QByteArray& data, bool encrypt)
+{
+    TRACE_SCOPE(encrypt ? "DataBinCodec::encrypt" : "DataBinCodec::decrypt");
+    m_files.clear();
+    m_error.clear();
+
+    quint32 size = data.size();
+    if (size < HEADER_SIZE + BK_HEADER_SIZE)
+    {
+        m_error = "File is too small to be a data.bin";
+        return false;
+    }
+
+    quint8* buf = (quint8*)data.data();
+    const quint8* bk = buf + HEADER_SIZE;
+    if (!isBkHeader(bk))
+    {
+        m_error = "Invalid Bk header";
+        return false;
+    }
+    quint32 numFiles = qFromBigEndian<quint32>(bk + 0x0C);
+
+    // Check the whole file table before touching anything, a bad file must
+    // not be left half converted
+    QList<FileEntry> files;
+    quint32 pos = HEADER_SIZE + BK_HEADER_SIZE;
+    for (quint32 i = 0; i < numFiles; i++)
+    {
+        if (pos + FILE_HEADER_SIZE > size)
+        {
+            m_error = QString("File header %1 is past the end of the file").arg(i);
+            return false;
+        }
+
+        FileEntry entry;
+        if (!parseFileHeader(buf + pos, pos, &entry))
+        {
+            m_error = QString("Bad magic in file header %1").arg(i);
+            return false;
+        }
+
+        quint32 stored = storedSize(entry);
+        if (stored > size - entry.Offset)
+        {
+            m_error = QString("\"%1\" is past the end of the file").arg(entry.Name);
+            return false;
+        }
+        files.append(entry);
+        pos = entry.Offset + stored;
+    }
+
+    if (encrypt)
+        encryptHeader(buf);
+    else
+        decryptHeader(buf);
+
+    foreach (const FileEntry& entry, files)
+    {
+        if (encrypt)
+            encryptFile(entry, buf + entry.Offset);
+        else
+            decryptFile(entry, buf + entry.Offset);
+    }
+
+    m_files = files;
+    return true;
+}
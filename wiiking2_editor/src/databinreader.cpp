@@ -0,0 +1,231 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "databinreader.h"
+#include "tracer.h"
+
+#include <QtEndian>
+
+// The header starts with the title id, the size of banner.bin, its
+// permissions and an MD5; banner.bin follows at 0x20
+static const int BANNER_OFFSET   = 0x20;
+static const int BANNER_MAGIC    = 0x5749424E;      // "WIBN"
+static const int TITLE_OFFSET    = 0x20;
+static const int SUBTITLE_OFFSET = 0x60;
+static const int TITLE_LENGTH    = 32;              // UTF-16BE characters
+static const int IMAGE_OFFSET    = 0xA0;
+
+static QString bannerString(const quint8* data)
+{
+    QString result;
+    for (int i = 0; i < TITLE_LENGTH; i++)
+    {
+        ushort c = qFromBigEndian<quint16>(data + i * 2);
+        if (c == 0)
+            break;
+        result += QChar(c);
+    }
+    return result;
+}
+
+DataBinReader::DataBinReader(const QString& filepath) :
+    m_file(filepath),
+    m_device(&m_file)
+{
+}
+
+DataBinReader::DataBinReader(QIODevice* device) :
+    m_device(device)
+{
+}
+
+bool DataBinReader::open()
+{
+    TRACE_SCOPE("DataBinReader::open");
+    close();
+    if (m_device == &m_file && !m_file.open(QFile::ReadOnly))
+    {
+        m_error = QString("Unable to open %1").arg(m_file.fileName());
+        return false;
+    }
+
+    qint64 size = m_device->size();
+    if (!m_device->seek(DataBinCodec::HEADER_SIZE))
+    {
+        m_error = "File is too small to be a data.bin";
+        return false;
+    }
+    m_bkHeader = m_device->read(DataBinCodec::BK_HEADER_SIZE);
+    if (m_bkHeader.size() != int(DataBinCodec::BK_HEADER_SIZE) || !DataBinCodec::isBkHeader((const quint8*)m_bkHeader.constData()))
+    {
+        m_error = "Invalid Bk header";
+        m_bkHeader.clear();
+        return false;
+    }
+
+    quint32 numFiles = qFromBigEndian<quint32>((const quint8*)m_bkHeader.constData() + 0x0C);
+    qint64 pos = DataBinCodec::HEADER_SIZE + DataBinCodec::BK_HEADER_SIZE;
+    for (quint32 i = 0; i < numFiles; i++)
+    {
+        QByteArray header;
+        if (m_device->seek(pos))
+            header = m_device->read(DataBinCodec::FILE_HEADER_SIZE);
+        if (header.size() != int(DataBinCodec::FILE_HEADER_SIZE))
+        {
+            m_error = QString("File header %1 is past the end of the file").arg(i);
+            m_files.clear();
+            return false;
+        }
+
+        DataBinCodec::FileEntry entry;
+        if (!DataBinCodec::parseFileHeader((const quint8*)header.constData(), pos, &entry))
+        {
+            m_error = QString("Bad magic in file header %1").arg(i);
+            m_files.clear();
+            return false;
+        }
+
+        pos = qint64(entry.Offset) + DataBinCodec::storedSize(entry);
+        if (pos > size)
+        {
+            m_error = QString("\"%1\" is past the end of the file").arg(entry.Name);
+            m_files.clear();
+            return false;
+        }
+        m_files.append(entry);
+    }
+    return true;
+}
+
+void DataBinReader::close()
+{
+    if (m_device == &m_file)
+        m_file.close();
+    m_error.clear();
+    m_bkHeader.clear();
+    m_files.clear();
+}
+
+QString DataBinReader::errorString() const
+{
+    return m_error;
+}
+
+quint32 DataBinReader::ngId() const
+{
+    if (m_bkHeader.isEmpty())
+        return 0;
+    return qFromBigEndian<quint32>((const quint8*)m_bkHeader.constData() + 0x08);
+}
+
+QByteArray DataBinReader::macAddress() const
+{
+    return m_bkHeader.mid(0x68, 6);
+}
+
+quint64 DataBinReader::titleId() const
+{
+    if (m_bkHeader.isEmpty())
+        return 0;
+    return qFromBigEndian<quint64>((const quint8*)m_bkHeader.constData() + 0x60);
+}
+
+QString DataBinReader::gameId() const
+{
+    return QString::fromLatin1(m_bkHeader.mid(0x64, 4));
+}
+
+QList<DataBinCodec::FileEntry> DataBinReader::files() const
+{
+    return m_files;
+}
+
+int DataBinReader::indexOf(const QString& name) const
+{
+    QString bare = name.startsWith('/') ? name.mid(1) : name;
+    for (int i = 0; i < m_files.size(); i++)
+    {
+        if (m_files[i].Name == bare)
+            return i;
+    }
+    return -1;
+}
+
+QByteArray DataBinReader::readFile(const QString& name)
+{
+    int index = indexOf(name);
+    if (index < 0)
+    {
+        m_error = QString("%1 is not in the backup").arg(name);
+        return QByteArray();
+    }
+    return readFile(index);
+}
+
+QByteArray DataBinReader::readFile(int index)
+{
+    TRACE_SCOPE("DataBinReader::readFile");
+    if (index < 0 || index >= m_files.size())
+        return QByteArray();
+
+    const DataBinCodec::FileEntry& entry = m_files[index];
+    quint32 stored = DataBinCodec::storedSize(entry);
+    QByteArray data;
+    if (m_device->seek(entry.Offset))
+        data = m_device->read(stored);
+    if (data.size() != int(stored))
+    {
+        m_error = QString("Unable to read %1").arg(entry.Name);
+        return QByteArray();
+    }
+
+    m_codec.decryptFile(entry, (quint8*)data.data());
+    data.truncate(entry.Size);
+    return data;
+}
+
+bool DataBinReader::readBanner(Banner* banner)
+{
+    TRACE_SCOPE("DataBinReader::readBanner");
+    QByteArray header;
+    if (m_device->seek(0))
+        header = m_device->read(DataBinCodec::HEADER_SIZE);
+    if (header.size() != int(DataBinCodec::HEADER_SIZE))
+    {
+        m_error = "Unable to read the banner";
+        return false;
+    }
+
+    quint8* data = (quint8*)header.data();
+    m_codec.decryptHeader(data);
+    quint32 size = qFromBigEndian<quint32>(data + 0x08);
+    const int imageSize = BANNER_WIDTH * BANNER_HEIGHT * 2;
+    const int iconSize = ICON_WIDTH * ICON_HEIGHT * 2;
+    if (size < quint32(IMAGE_OFFSET + imageSize) || size > DataBinCodec::HEADER_SIZE - BANNER_OFFSET ||
+            qFromBigEndian<quint32>(data + BANNER_OFFSET) != quint32(BANNER_MAGIC))
+    {
+        m_error = "Invalid banner";
+        return false;
+    }
+
+    const quint8* bin = data + BANNER_OFFSET;
+    banner->Title = bannerString(bin + TITLE_OFFSET);
+    banner->Subtitle = bannerString(bin + SUBTITLE_OFFSET);
+    banner->Image = QByteArray((const char*)bin + IMAGE_OFFSET, imageSize);
+    banner->Icons.clear();
+    for (quint32 pos = IMAGE_OFFSET + imageSize; pos + iconSize <= size; pos += iconSize)
+        banner->Icons << QByteArray((const char*)bin + pos, iconSize);
+    return true;
+}
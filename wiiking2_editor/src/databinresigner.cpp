@@ -0,0 +1,317 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "databinresigner.h"
+#include "databincodec.h"
+#include "databinreader.h"
+#include "ec233.h"
+#include "tracer.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QVector>
+#include <QtEndian>
+#if QT_VERSION >= 0x050000
+#include <QSaveFile>
+#endif
+
+class ResignTask : public QRunnable
+{
+public:
+    ResignTask(const DataBinResigner* resigner, const QString& path, const QString& output, DataBinResigner::Result* result)
+        : m_resigner(resigner),
+          m_path(path),
+          m_output(output),
+          m_result(result)
+    {
+    }
+
+    void run()
+    {
+        // every task owns its slot in the result list, no locking needed
+        *m_result = m_resigner->resignFile(m_path, m_output);
+    }
+
+private:
+    const DataBinResigner*   m_resigner;
+    QString                  m_path;
+    QString                  m_output;
+    DataBinResigner::Result* m_result;
+};
+
+DataBinResigner::DataBinResigner(QSharedPointer<const SigningContext> context)
+    : m_context(context),
+      m_requireValid(false),
+      m_threadCount(0)
+{
+}
+
+void DataBinResigner::setOutputDirectory(const QString& dir)
+{
+    m_outputDir = dir;
+}
+
+QString DataBinResigner::outputDirectory() const
+{
+    return m_outputDir;
+}
+
+void DataBinResigner::setRequireValidSignature(bool require)
+{
+    m_requireValid = require;
+}
+
+bool DataBinResigner::requireValidSignature() const
+{
+    return m_requireValid;
+}
+
+void DataBinResigner::setThreadCount(int count)
+{
+    m_threadCount = count;
+}
+
+int DataBinResigner::threadCount() const
+{
+    return m_threadCount;
+}
+
+// The deepest directory every path is in, empty if there is none, e.g.
+// for files on different drives
+static QString commonDirectory(const QStringList& paths)
+{
+    QStringList common;
+    for (int i = 0; i < paths.size(); i++)
+    {
+        QStringList parts = QFileInfo(paths[i]).absolutePath().split('/');
+        if (i == 0)
+        {
+            common = parts;
+            continue;
+        }
+
+        int length = 0;
+        while (length < common.size() && length < parts.size() && common[length] == parts[length])
+            length++;
+        common = common.mid(0, length);
+    }
+    if (common.size() == 1 && common[0].isEmpty())
+        return "/";
+    return common.join("/");
+}
+
+QStringList DataBinResigner::outputPaths(const QStringList& paths) const
+{
+    if (m_outputDir.isEmpty())
+        return paths;
+
+    QDir outputDir(m_outputDir);
+    QString root = commonDirectory(paths);
+    QStringList outputs;
+    foreach (const QString& path, paths)
+    {
+        QFileInfo info(path);
+        if (root.isEmpty())
+            outputs << outputDir.filePath(info.fileName());
+        else
+            outputs << outputDir.filePath(QDir(root).relativeFilePath(info.absoluteFilePath()));
+    }
+    return outputs;
+}
+
+DataBinResigner::Result DataBinResigner::resignFile(const QString& path) const
+{
+    return resignFile(path, outputPaths(QStringList() << path).first());
+}
+
+DataBinResigner::Result DataBinResigner::resignFile(const QString& path, const QString& output) const
+{
+    TRACE_SCOPE("DataBinResigner::resignFile");
+    Result result;
+    result.Input = path;
+    result.Output = output;
+    result.Ok = false;
+    result.WasVerified = false;
+
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        result.Error = QString("Unable to open %1").arg(path);
+        return result;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+
+    // The signature covers the encrypted data, so nothing is decrypted.
+    // The file headers are in the clear, walking them checks the whole file
+    // table before anything is written.
+    {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        DataBinReader reader(&buffer);
+        if (!reader.open())
+        {
+            result.Error = reader.errorString();
+            return result;
+        }
+    }
+
+    QString verifyError;
+    result.WasVerified = verifySignature(data, &verifyError);
+    if (!result.WasVerified && m_requireValid)
+    {
+        result.Error = verifyError;
+        return result;
+    }
+
+    if (!m_context->signDataBin(data, &result.Error))
+        return result;
+    QString outputDir = QFileInfo(result.Output).absolutePath();
+    if (!QDir().mkpath(outputDir))
+    {
+        result.Error = QString("Unable to create %1").arg(outputDir);
+        return result;
+    }
+    if (!writeFile(result.Output, data, &result.Error))
+        return result;
+
+    result.Ok = true;
+    return result;
+}
+
+QList<DataBinResigner::Result> DataBinResigner::resignFiles(const QStringList& paths) const
+{
+    QVector<Result> results(paths.size());
+    QStringList outputs = outputPaths(paths);
+
+    // The tasks would overwrite each other and all report success, so a
+    // batch with a shared output is refused before anything is written
+    QHash<QString, int> owners;
+    bool collision = false;
+    for (int i = 0; i < outputs.size(); i++)
+    {
+        Result& result = results[i];
+        result.Input = paths[i];
+        result.Output = outputs[i];
+        result.Ok = false;
+        result.WasVerified = false;
+
+        QString key = QDir::cleanPath(QFileInfo(outputs[i]).absoluteFilePath());
+        if (owners.contains(key))
+        {
+            result.Error = QString("Would be written to %1 as well as %2").arg(outputs[i]).arg(paths[owners.value(key)]);
+            collision = true;
+        }
+        else
+            owners.insert(key, i);
+    }
+    if (collision)
+    {
+        for (int i = 0; i < results.size(); i++)
+        {
+            if (results[i].Error.isEmpty())
+                results[i].Error = "Not written, other files in the batch share an output";
+        }
+        return results.toList();
+    }
+
+    QThreadPool pool;
+    if (m_threadCount > 0)
+        pool.setMaxThreadCount(m_threadCount);
+    for (int i = 0; i < paths.size(); i++)
+        pool.start(new ResignTask(this, paths[i], outputs[i], &results[i]));
+    pool.waitForDone();
+
+    return results.toList();
+}
+
+bool DataBinResigner::verifySignature(const QByteArray& dataBin, QString* error)
+{
+    const int bkOffset = DataBinCodec::HEADER_SIZE;
+    if (dataBin.size() < int(bkOffset + DataBinCodec::BK_HEADER_SIZE))
+    {
+        if (error)
+            *error = "File is too small to be a data.bin";
+        return false;
+    }
+
+    const quint8* data = (const quint8*)dataBin.constData();
+    qint64 signedSize = qint64(DataBinCodec::BK_HEADER_SIZE) + qFromBigEndian<quint32>(data + bkOffset + 0x10);
+    if (bkOffset + signedSize + SigningContext::TAIL_SIZE > dataBin.size())
+    {
+        if (error)
+            *error = "The signature is missing";
+        return false;
+    }
+
+    const quint8* signature = data + bkOffset + signedSize;
+    const quint8* ngCert = signature + SigningContext::SIGNATURE_SIZE;
+    const quint8* apCert = ngCert + SigningContext::CERT_SIZE;
+
+    QByteArray hash = QCryptographicHash::hash(QByteArray::fromRawData((const char*)apCert + 0x80, 0x100),
+                                               QCryptographicHash::Sha1);
+    if (!Ec233::verify(ngCert + 0x108, (const quint8*)hash.constData(), apCert + 4))
+    {
+        if (error)
+            *error = "The AP certificate is not signed by the NG key";
+        return false;
+    }
+
+    hash = QCryptographicHash::hash(QByteArray::fromRawData(dataBin.constData() + bkOffset, signedSize),
+                                    QCryptographicHash::Sha1);
+    hash = QCryptographicHash::hash(hash, QCryptographicHash::Sha1);
+    if (!Ec233::verify(apCert + 0x108, (const quint8*)hash.constData(), signature))
+    {
+        if (error)
+            *error = "The data signature does not match";
+        return false;
+    }
+    return true;
+}
+
+bool DataBinResigner::writeFile(const QString& path, const QByteArray& data, QString* error)
+{
+#if QT_VERSION >= 0x050000
+    QSaveFile file(path);
+    if (!file.open(QFile::WriteOnly) || file.write(data) != data.size() || !file.commit())
+    {
+        *error = QString("Unable to write %1: %2").arg(path).arg(file.errorString());
+        return false;
+    }
+    return true;
+#else
+    QString temp = path + ".tmp";
+    QFile file(temp);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(data) != data.size() || !file.flush())
+    {
+        *error = QString("Unable to write %1").arg(temp);
+        file.remove();
+        return false;
+    }
+    file.close();
+    if ((QFile::exists(path) && !QFile::remove(path)) || !QFile::rename(temp, path))
+    {
+        *error = QString("Unable to replace %1").arg(path);
+        return false;
+    }
+    return true;
+#endif
+}
@@ -0,0 +1,193 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "datainspectormodel.h"
+#include "common.h"
+
+#include <QtEndian>
+#include <QDateTime>
+#include <string.h>
+
+static QString decodeInt8(const uchar* data, int)
+{
+    return QString::number((qint8)data[0]);
+}
+
+static QString decodeUInt8(const uchar* data, int)
+{
+    if (data[0] >= 0x20 && data[0] < 0x7F)
+        return QString("%1 '%2'").arg(data[0]).arg(QChar(data[0]));
+    return QString::number(data[0]);
+}
+
+static QString decodeBits(const uchar* data, int)
+{
+    return QString("%1 %2").arg(data[0] >> 4, 4, 2, QChar('0')).arg(data[0] & 0x0F, 4, 2, QChar('0'));
+}
+
+static QString decodeInt16(const uchar* data, int)
+{
+    return QString::number(qFromBigEndian<qint16>(data));
+}
+
+static QString decodeUInt16(const uchar* data, int)
+{
+    return QString::number(qFromBigEndian<quint16>(data));
+}
+
+// Two 7 bit quantities sharing a short, like the material and bug pouches
+static QString decodeQuantityPair(const uchar* data, int)
+{
+    quint16 val = qFromBigEndian<quint16>(data);
+    return QString("%1 / %2").arg((val >> 7) & 127).arg(val & 127);
+}
+
+static QString decodeInt32(const uchar* data, int)
+{
+    return QString::number(qFromBigEndian<qint32>(data));
+}
+
+static QString decodeUInt32(const uchar* data, int)
+{
+    return QString::number(qFromBigEndian<quint32>(data));
+}
+
+static QString decodeInt64(const uchar* data, int)
+{
+    return QString::number(qFromBigEndian<qint64>(data));
+}
+
+static QString decodeUInt64(const uchar* data, int)
+{
+    return QString::number(qFromBigEndian<quint64>(data));
+}
+
+static QString decodeFloat(const uchar* data, int)
+{
+    quint32 bits = qFromBigEndian<quint32>(data);
+    float val;
+    memcpy(&val, &bits, sizeof(val));
+    return QString::number(val);
+}
+
+static QString decodeDouble(const uchar* data, int)
+{
+    quint64 bits = qFromBigEndian<quint64>(data);
+    double val;
+    memcpy(&val, &bits, sizeof(val));
+    return QString::number(val, 'g', 12);
+}
+
+static QString decodeWiiTime(const uchar* data, int)
+{
+    return fromWiiTime(qFromBigEndian<quint64>(data)).toString(Qt::ISODate);
+}
+
+static QString decodeUtf16(const uchar* data, int available)
+{
+    QString ret;
+    for (int i = 0; i + 1 < available; i += 2)
+    {
+        ushort c = qFromBigEndian<quint16>(data + i);
+        if (c == 0)
+            break;
+        ret += QChar(c);
+    }
+    return QString("\"%1\"").arg(ret);
+}
+
+DataInspectorModel::DataInspectorModel(QObject *parent) :
+    QAbstractTableModel(parent),
+    m_available(0),
+    m_address(0)
+{
+    addType("int8",         1, decodeInt8);
+    addType("uint8",        1, decodeUInt8);
+    addType("bits",         1, decodeBits);
+    addType("int16",        2, decodeInt16);
+    addType("uint16",       2, decodeUInt16);
+    addType("7-bit pair",   2, decodeQuantityPair);
+    addType("int32",        4, decodeInt32);
+    addType("uint32",       4, decodeUInt32);
+    addType("float",        4, decodeFloat);
+    addType("int64",        8, decodeInt64);
+    addType("uint64",       8, decodeUInt64);
+    addType("double",       8, decodeDouble);
+    addType("Wii time",     8, decodeWiiTime);
+    addType("UTF-16",       2, decodeUtf16);
+}
+
+void DataInspectorModel::addType(const QString& name, int size, Decoder decoder)
+{
+    Q_ASSERT(size > 0 && size <= WINDOW_SIZE);
+
+    Type type;
+    type.Name   = name;
+    type.Size   = size;
+    type.Decode = decoder;
+
+    beginInsertRows(QModelIndex(), m_types.size(), m_types.size());
+    m_types.append(type);
+    endInsertRows();
+}
+
+void DataInspectorModel::setCursor(const QByteArray& data, int address)
+{
+    // constData() keeps the implicitly shared buffer from detaching
+    m_address   = address;
+    m_available = qBound(0, data.size() - address, (int)WINDOW_SIZE);
+    if (m_available > 0)
+        memcpy(m_window, data.constData() + address, m_available);
+
+    if (!m_types.isEmpty())
+        emit dataChanged(index(0, 1), index(m_types.size() - 1, 1));
+}
+
+int DataInspectorModel::address() const
+{
+    return m_address;
+}
+
+int DataInspectorModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_types.size();
+}
+
+int DataInspectorModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : 2;
+}
+
+QVariant DataInspectorModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_types.size() || role != Qt::DisplayRole)
+        return QVariant();
+
+    const Type& type = m_types[index.row()];
+    if (index.column() == 0)
+        return type.Name;
+
+    if (m_available < type.Size)
+        return QString("-");
+    return type.Decode(m_window, m_available);
+}
+
+QVariant DataInspectorModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+
+    return (section == 0) ? tr("Type") : tr("Value");
+}
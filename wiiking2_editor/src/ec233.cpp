@@ -0,0 +1,475 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "ec233.h"
+
+#include <QCryptographicHash>
+#include <string.h>
+
+// Field elements of GF(2^233) and scalars below the group order both fit in
+// four 64 bit words, least significant word first
+struct Big
+{
+    quint64 w[4];
+};
+
+struct Point
+{
+    Big  x;
+    Big  y;
+    bool infinity;
+};
+
+static const quint8 CURVE_B[30] =
+{
+    0x00, 0x66, 0x64, 0x7E, 0xDE, 0x6C, 0x33, 0x2C, 0x7F, 0x8C,
+    0x09, 0x23, 0xBB, 0x58, 0x21, 0x3B, 0x33, 0x3B, 0x20, 0xE9,
+    0xCE, 0x42, 0x81, 0xFE, 0x11, 0x5F, 0x7D, 0x8F, 0x90, 0xAD
+};
+
+static const quint8 CURVE_GX[30] =
+{
+    0x00, 0xFA, 0xC9, 0xDF, 0xCB, 0xAC, 0x83, 0x13, 0xBB, 0x21,
+    0x39, 0xF1, 0xBB, 0x75, 0x5F, 0xEF, 0x65, 0xBC, 0x39, 0x1F,
+    0x8B, 0x36, 0xF8, 0xF8, 0xEB, 0x73, 0x71, 0xFD, 0x55, 0x8B
+};
+
+static const quint8 CURVE_GY[30] =
+{
+    0x01, 0x00, 0x6A, 0x08, 0xA4, 0x19, 0x03, 0x35, 0x06, 0x78,
+    0xE5, 0x85, 0x28, 0xBE, 0xBF, 0x8A, 0x0B, 0xEF, 0xF8, 0x67,
+    0xA7, 0xCA, 0x36, 0x71, 0x6F, 0x7E, 0x01, 0xF8, 0x10, 0x52
+};
+
+static const quint8 CURVE_N[30] =
+{
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x13, 0xE9, 0x74, 0xE7, 0x2F,
+    0x8A, 0x69, 0x22, 0x03, 0x1D, 0x26, 0x03, 0xCF, 0xE0, 0xD7
+};
+
+static const int BITS = 233;
+
+static Big fromBytes(const quint8* p, int size = Ec233::ELEMENT_SIZE)
+{
+    Big r;
+    memset(&r, 0, sizeof(r));
+    for (int i = 0; i < size; i++)
+        r.w[i / 8] |= quint64(p[size - 1 - i]) << (8 * (i % 8));
+    return r;
+}
+
+static void toBytes(const Big& a, quint8* p)
+{
+    for (int i = 0; i < Ec233::ELEMENT_SIZE; i++)
+        p[Ec233::ELEMENT_SIZE - 1 - i] = quint8(a.w[i / 8] >> (8 * (i % 8)));
+}
+
+static Big word(quint64 v)
+{
+    Big r;
+    memset(&r, 0, sizeof(r));
+    r.w[0] = v;
+    return r;
+}
+
+static bool isZero(const Big& a)
+{
+    return (a.w[0] | a.w[1] | a.w[2] | a.w[3]) == 0;
+}
+
+static bool isOne(const Big& a)
+{
+    return a.w[0] == 1 && (a.w[1] | a.w[2] | a.w[3]) == 0;
+}
+
+static bool equal(const Big& a, const Big& b)
+{
+    return memcmp(&a, &b, sizeof(Big)) == 0;
+}
+
+static bool testBit(const Big& a, int i)
+{
+    return (a.w[i >> 6] >> (i & 63)) & 1;
+}
+
+static int degree(const Big& a)
+{
+    for (int i = 3; i >= 0; i--)
+    {
+        if (a.w[i] == 0)
+            continue;
+        int d = 63;
+        while (!((a.w[i] >> d) & 1))
+            d--;
+        return 64 * i + d;
+    }
+    return -1;
+}
+
+static void shiftRight(Big& a)
+{
+    a.w[0] = (a.w[0] >> 1) | (a.w[1] << 63);
+    a.w[1] = (a.w[1] >> 1) | (a.w[2] << 63);
+    a.w[2] = (a.w[2] >> 1) | (a.w[3] << 63);
+    a.w[3] >>= 1;
+}
+
+static void shiftLeft(Big& a)
+{
+    a.w[3] = (a.w[3] << 1) | (a.w[2] >> 63);
+    a.w[2] = (a.w[2] << 1) | (a.w[1] >> 63);
+    a.w[1] = (a.w[1] << 1) | (a.w[0] >> 63);
+    a.w[0] <<= 1;
+}
+
+// GF(2^233) with the reduction polynomial x^233 + x^74 + 1
+
+static Big fieldAdd(const Big& a, const Big& b)
+{
+    Big r;
+    for (int i = 0; i < 4; i++)
+        r.w[i] = a.w[i] ^ b.w[i];
+    return r;
+}
+
+static Big fieldMul(const Big& a, const Big& b)
+{
+    Big r = word(0);
+    for (int i = BITS - 1; i >= 0; i--)
+    {
+        shiftLeft(r);
+        if (testBit(r, BITS))
+        {
+            r.w[3] ^= Q_UINT64_C(1) << (BITS - 192);
+            r.w[1] ^= Q_UINT64_C(1) << (74 - 64);
+            r.w[0] ^= 1;
+        }
+        if (testBit(b, i))
+            r = fieldAdd(r, a);
+    }
+    return r;
+}
+
+static Big fieldSquare(const Big& a)
+{
+    return fieldMul(a, a);
+}
+
+// Binary extended Euclid on polynomials, a must not be zero
+static Big fieldInverse(const Big& a)
+{
+    Big f = word(1);
+    f.w[1] |= Q_UINT64_C(1) << (74 - 64);
+    f.w[3] |= Q_UINT64_C(1) << (BITS - 192);
+
+    Big u = a;
+    Big v = f;
+    Big g1 = word(1);
+    Big g2 = word(0);
+    while (!isOne(u) && !isOne(v))
+    {
+        while (!(u.w[0] & 1))
+        {
+            shiftRight(u);
+            if (g1.w[0] & 1)
+                g1 = fieldAdd(g1, f);
+            shiftRight(g1);
+        }
+        while (!(v.w[0] & 1))
+        {
+            shiftRight(v);
+            if (g2.w[0] & 1)
+                g2 = fieldAdd(g2, f);
+            shiftRight(g2);
+        }
+        if (degree(u) > degree(v))
+        {
+            u = fieldAdd(u, v);
+            g1 = fieldAdd(g1, g2);
+        }
+        else
+        {
+            v = fieldAdd(v, u);
+            g2 = fieldAdd(g2, g1);
+        }
+    }
+    return isOne(u) ? g1 : g2;
+}
+
+// Integers modulo the group order n
+
+static int compare(const Big& a, const Big& b)
+{
+    for (int i = 3; i >= 0; i--)
+    {
+        if (a.w[i] != b.w[i])
+            return a.w[i] < b.w[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+static Big add(const Big& a, const Big& b)
+{
+    Big r;
+    quint64 carry = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        quint64 s = a.w[i] + carry;
+        carry = (s < carry);
+        r.w[i] = s + b.w[i];
+        carry += (r.w[i] < s);
+    }
+    return r;
+}
+
+static Big sub(const Big& a, const Big& b)
+{
+    Big r;
+    quint64 borrow = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        quint64 d = a.w[i] - b.w[i];
+        quint64 nextBorrow = (a.w[i] < b.w[i]);
+        r.w[i] = d - borrow;
+        nextBorrow |= (d < borrow);
+        borrow = nextBorrow;
+    }
+    return r;
+}
+
+static const Big& order()
+{
+    static const Big n = fromBytes(CURVE_N);
+    return n;
+}
+
+static Big reduce(const Big& a)
+{
+    return compare(a, order()) >= 0 ? sub(a, order()) : a;
+}
+
+static Big addMod(const Big& a, const Big& b)
+{
+    return reduce(add(a, b));
+}
+
+static Big subMod(const Big& a, const Big& b)
+{
+    return compare(a, b) >= 0 ? sub(a, b) : sub(add(a, order()), b);
+}
+
+static Big mulMod(const Big& a, const Big& b)
+{
+    Big r = word(0);
+    for (int i = BITS; i >= 0; i--)
+    {
+        r = addMod(r, r);
+        if (testBit(b, i))
+            r = addMod(r, a);
+    }
+    return r;
+}
+
+static Big halveMod(Big a)
+{
+    if (a.w[0] & 1)
+        a = add(a, order());
+    shiftRight(a);
+    return a;
+}
+
+// n is prime, so binary extended Euclid works for any a != 0
+static Big invMod(const Big& a)
+{
+    Big u = a;
+    Big v = order();
+    Big x1 = word(1);
+    Big x2 = word(0);
+    while (!isOne(u) && !isOne(v))
+    {
+        while (!(u.w[0] & 1))
+        {
+            shiftRight(u);
+            x1 = halveMod(x1);
+        }
+        while (!(v.w[0] & 1))
+        {
+            shiftRight(v);
+            x2 = halveMod(x2);
+        }
+        if (compare(u, v) >= 0)
+        {
+            u = sub(u, v);
+            x1 = subMod(x1, x2);
+        }
+        else
+        {
+            v = sub(v, u);
+            x2 = subMod(x2, x1);
+        }
+    }
+    return isOne(u) ? x1 : x2;
+}
+
+// Points on y^2 + xy = x^3 + x^2 + b, in affine coordinates
+
+static Point infinity()
+{
+    Point p;
+    p.x = word(0);
+    p.y = word(0);
+    p.infinity = true;
+    return p;
+}
+
+static Point pointDouble(const Point& p)
+{
+    if (p.infinity || isZero(p.x))
+        return infinity();
+
+    Big l = fieldAdd(p.x, fieldMul(p.y, fieldInverse(p.x)));
+    Point r;
+    r.x = fieldAdd(fieldAdd(fieldSquare(l), l), word(1));
+    r.y = fieldAdd(fieldAdd(fieldSquare(p.x), fieldMul(l, r.x)), r.x);
+    r.infinity = false;
+    return r;
+}
+
+static Point pointAdd(const Point& p, const Point& q)
+{
+    if (p.infinity)
+        return q;
+    if (q.infinity)
+        return p;
+    if (equal(p.x, q.x))
+        return equal(p.y, q.y) ? pointDouble(p) : infinity();
+
+    Big dx = fieldAdd(p.x, q.x);
+    Big l = fieldMul(fieldAdd(p.y, q.y), fieldInverse(dx));
+    Point r;
+    r.x = fieldAdd(fieldAdd(fieldAdd(fieldSquare(l), l), dx), word(1));
+    r.y = fieldAdd(fieldAdd(fieldMul(l, fieldAdd(p.x, r.x)), r.x), p.y);
+    r.infinity = false;
+    return r;
+}
+
+static Point pointMul(const Big& k, Point p)
+{
+    Point r = infinity();
+    for (int i = 0; i < BITS + 7; i++)
+    {
+        if (testBit(k, i))
+            r = pointAdd(r, p);
+        p = pointDouble(p);
+    }
+    return r;
+}
+
+struct GeneratorTable
+{
+    Point Powers[BITS + 7];                 //!< G * 2^i
+
+    GeneratorTable()
+    {
+        Point p;
+        p.x = fromBytes(CURVE_GX);
+        p.y = fromBytes(CURVE_GY);
+        p.infinity = false;
+        for (int i = 0; i < BITS + 7; i++)
+        {
+            Powers[i] = p;
+            p = pointDouble(p);
+        }
+    }
+};
+
+static Point generatorMul(const Big& k)
+{
+    static const GeneratorTable table;
+    Point r = infinity();
+    for (int i = 0; i < BITS + 7; i++)
+    {
+        if (testBit(k, i))
+            r = pointAdd(r, table.Powers[i]);
+    }
+    return r;
+}
+
+static Big hashToScalar(const quint8* hash)
+{
+    return fromBytes(hash, Ec233::HASH_SIZE);
+}
+
+void Ec233::publicKey(const quint8* priv, quint8* pub)
+{
+    Point p = generatorMul(fromBytes(priv));
+    toBytes(p.x, pub);
+    toBytes(p.y, pub + ELEMENT_SIZE);
+}
+
+void Ec233::sign(const quint8* priv, const quint8* hash, quint8* signature)
+{
+    Big k = reduce(fromBytes(priv));
+    Big e = hashToScalar(hash);
+
+    // Deterministic nonce, SHA-1 of key, hash and a counter stretched to
+    // 30 bytes. The top byte stays clear so m is below n.
+    QByteArray seed((const char*)priv, ELEMENT_SIZE);
+    seed.append((const char*)hash, HASH_SIZE);
+    for (quint8 counter = 0; ; counter++)
+    {
+        quint8 nonce[ELEMENT_SIZE];
+        QByteArray a = QCryptographicHash::hash(seed + char(counter) + char(0), QCryptographicHash::Sha1);
+        QByteArray b = QCryptographicHash::hash(seed + char(counter) + char(1), QCryptographicHash::Sha1);
+        memcpy(nonce, a.constData(), 20);
+        memcpy(nonce + 20, b.constData(), 10);
+        nonce[0] = 0;
+
+        Big m = fromBytes(nonce);
+        if (isZero(m))
+            continue;
+
+        Big r = reduce(generatorMul(m).x);
+        if (isZero(r))
+            continue;
+        Big s = mulMod(invMod(m), addMod(e, mulMod(r, k)));
+        if (isZero(s))
+            continue;
+
+        toBytes(r, signature);
+        toBytes(s, signature + ELEMENT_SIZE);
+        return;
+    }
+}
+
+bool Ec233::verify(const quint8* pub, const quint8* hash, const quint8* signature)
+{
+    Big r = fromBytes(signature);
+    Big s = fromBytes(signature + ELEMENT_SIZE);
+    if (isZero(r) || isZero(s) || compare(r, order()) >= 0 || compare(s, order()) >= 0)
+        return false;
+
+    Point q;
+    q.x = fromBytes(pub);
+    q.y = fromBytes(pub + ELEMENT_SIZE);
+    q.infinity = false;
+
+    Big w = invMod(s);
+    Big u1 = mulMod(hashToScalar(hash), w);
+    Big u2 = mulMod(r, w);
+    Point p = pointAdd(generatorMul(u1), pointMul(u2, q));
+    return !p.infinity && equal(reduce(p.x), r);
+}
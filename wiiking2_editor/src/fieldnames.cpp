@@ -0,0 +1,49 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "fieldnames.h"
+#include "slotlayout.h"
+
+#include <cstddef>
+
+#define SAVE_FIELD_FIELD(name, offset, type, label)        {offset, sizeof(type), label},
+#define SAVE_FIELD_ARRAY(name, offset, type, count, label) {offset, sizeof(type) * count, label},
+#define SAVE_FIELD_GAP(offset, size)
+
+// Sorted by offset, generated from the slot layout
+const SaveField SAVE_FIELDS[] =
+{
+    SLOT_LAYOUT(SAVE_FIELD_FIELD, SAVE_FIELD_ARRAY, SAVE_FIELD_GAP)
+};
+
+const int SAVE_FIELD_COUNT = sizeof(SAVE_FIELDS) / sizeof(SAVE_FIELDS[0]);
+
+const SaveField* findSaveField(quint32 offset)
+{
+    int lo = 0;
+    int hi = SAVE_FIELD_COUNT;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (SAVE_FIELDS[mid].Offset + SAVE_FIELDS[mid].Length <= offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < SAVE_FIELD_COUNT && SAVE_FIELDS[lo].Offset <= offset)
+        return &SAVE_FIELDS[lo];
+    return NULL;
+}
@@ -0,0 +1,151 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "filejob.h"
+#include <QCoreApplication>
+
+static bool isDataBin(const QString& filename)
+{
+    return filename.lastIndexOf(".bin") == filename.size() - 4;
+}
+
+FileJob::FileJob(const QString& filepath, QObject* parent) :
+    QThread(parent),
+    m_type(OpenJob),
+    m_filename(filepath),
+    m_file(NULL),
+    m_succeeded(false),
+    m_validChecksum(false),
+    m_cancelled(0)
+{
+}
+
+FileJob::FileJob(SkywardSwordFile* file, QObject* parent) :
+    QThread(parent),
+    m_type(SaveJob),
+    m_filename(file->filename()),
+    m_file(file),
+    m_succeeded(false),
+    m_validChecksum(false),
+    m_cancelled(0)
+{
+}
+
+FileJob::~FileJob()
+{
+    wait();
+    // an opened file nobody took is ours
+    if (m_type == OpenJob)
+        delete m_file;
+}
+
+FileJob::Type FileJob::type() const
+{
+    return m_type;
+}
+
+QString FileJob::filename() const
+{
+    return m_filename;
+}
+
+void FileJob::cancel()
+{
+    m_cancelled.fetchAndStoreOrdered(1);
+}
+
+bool FileJob::isCancelled() const
+{
+    return m_cancelled.fetchAndAddOrdered(0) != 0;
+}
+
+bool FileJob::succeeded() const
+{
+    return m_succeeded;
+}
+
+QString FileJob::errorString() const
+{
+    return m_error;
+}
+
+bool FileJob::hasValidChecksum() const
+{
+    return m_validChecksum;
+}
+
+SkywardSwordFile* FileJob::takeFile()
+{
+    SkywardSwordFile* file = m_file;
+    if (m_type == OpenJob)
+        m_file = NULL;
+    return file;
+}
+
+void FileJob::run()
+{
+    if (m_type == OpenJob)
+        runOpen();
+    else
+        runSave();
+}
+
+void FileJob::runOpen()
+{
+    emit progress(0, isDataBin(m_filename) ? tr("Decrypting %1...").arg(m_filename) : tr("Reading %1...").arg(m_filename));
+    SkywardSwordFile* file = new SkywardSwordFile;
+    bool opened;
+    if (isDataBin(m_filename))
+        opened = file->loadDataBin(m_filename, file->game());
+    else
+        opened = file->open(file->game(), m_filename);
+
+    if (!opened)
+    {
+        m_error = file->lastError().isEmpty() ? tr("Unable to open \"%1\"").arg(m_filename) : file->lastError();
+        delete file;
+        return;
+    }
+
+    if (isCancelled())
+    {
+        delete file;
+        return;
+    }
+
+    emit progress(80, tr("Verifying checksums..."));
+    file->setGame(SkywardSwordFile::Game1);
+    m_validChecksum = file->hasValidChecksum();
+
+    // the GUI thread owns the file from now on
+    file->moveToThread(QCoreApplication::instance()->thread());
+    m_file = file;
+    m_succeeded = !isCancelled();
+    emit progress(100, tr("Done"));
+}
+
+void FileJob::runSave()
+{
+    emit progress(0, tr("Preparing %1...").arg(m_filename));
+    if (isCancelled())
+        return;
+
+    // past this point the save runs to the end
+    emit progress(20, isDataBin(m_filename) ? tr("Encrypting and signing %1...").arg(m_filename) : tr("Writing %1...").arg(m_filename));
+    m_succeeded = m_file->save();
+    if (!m_succeeded)
+        m_error = m_file->lastError().isEmpty() ? tr("Unable to save file") : m_file->lastError();
+    emit progress(100, tr("Done"));
+}
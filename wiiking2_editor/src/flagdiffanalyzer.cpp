@@ -0,0 +1,368 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "flagdiffanalyzer.h"
+#include "bitops.h"
+#include "slotlayout.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QMap>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QRunnable>
+#include <algorithm>
+#include <string.h>
+
+const int FILE_SIZE  = SaveLayout::SIZE;
+const int SLOT_START = SaveLayout::SLOT_OFFSET;
+const int SLOT_SIZE  = SlotLayout::SIZE;
+const int SLOT_COUNT = SaveLayout::SLOT_COUNT;
+
+class PairLoader : public QRunnable
+{
+public:
+    PairLoader(FlagDiffAnalyzer* analyzer, const FlagDiffAnalyzer::PairFile& pair, QStringList* errors, QMutex* errorMutex, QAtomicInt* added)
+        : m_analyzer(analyzer),
+          m_pair(pair),
+          m_errors(errors),
+          m_errorMutex(errorMutex),
+          m_added(added)
+    {
+    }
+
+    void run()
+    {
+        QFile before(m_pair.Before);
+        QFile after(m_pair.After);
+        QString error;
+        if (!before.open(QIODevice::ReadOnly))
+            error = QString("Unable to open %1").arg(m_pair.Before);
+        else if (!after.open(QIODevice::ReadOnly))
+            error = QString("Unable to open %1").arg(m_pair.After);
+        else if (!m_analyzer->addPair(m_pair.Label, before.readAll(), after.readAll()))
+            error = QString("%1 and %2 don't have the expected size").arg(m_pair.Before).arg(m_pair.After);
+        else
+            m_added->fetchAndAddOrdered(1);
+
+        if (!error.isEmpty() && m_errors)
+        {
+            QMutexLocker locker(m_errorMutex);
+            m_errors->append(error);
+        }
+    }
+
+private:
+    FlagDiffAnalyzer*          m_analyzer;
+    FlagDiffAnalyzer::PairFile m_pair;
+    QStringList*               m_errors;
+    QMutex*                    m_errorMutex;
+    QAtomicInt*                m_added;
+};
+
+static bool candidateLessThan(const FlagDiffAnalyzer::Candidate& a, const FlagDiffAnalyzer::Candidate& b)
+{
+    if (a.Score != b.Score)
+        return a.Score > b.Score;
+    if (a.Hits != b.Hits)
+        return a.Hits > b.Hits;
+    if (a.Offset != b.Offset)
+        return a.Offset < b.Offset;
+    return a.Mask < b.Mask;
+}
+
+FlagDiffAnalyzer::FlagDiffAnalyzer()
+    : m_slotRelative(false),
+      m_size(0),
+      m_changedBits(0)
+{
+}
+
+void FlagDiffAnalyzer::setSlotRelative(bool slotRelative)
+{
+    clear();
+    m_slotRelative = slotRelative;
+}
+
+bool FlagDiffAnalyzer::isSlotRelative() const
+{
+    return m_slotRelative;
+}
+
+void FlagDiffAnalyzer::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_size = 0;
+    m_labels.clear();
+    m_diffs.clear();
+    m_changedBits = 0;
+}
+
+bool FlagDiffAnalyzer::addPair(const QString& label, const QByteArray& before, const QByteArray& after)
+{
+    if (before.size() != after.size() || before.isEmpty())
+        return false;
+    if (m_slotRelative && before.size() != FILE_SIZE)
+        return false;
+
+    // The diff is the expensive part and doesn't need the lock
+    Diff d = diff(before, after);
+    quint64 changed = 0;
+    for (int i = 0; i < d.Bits.size(); i++)
+        changed += popCount64(d.Bits[i]);
+
+    QMutexLocker locker(&m_mutex);
+    if (m_size == 0)
+        m_size = before.size();
+    else if (m_size != before.size())
+        return false;
+
+    d.Label = m_labels.indexOf(label);
+    if (d.Label < 0)
+    {
+        d.Label = m_labels.size();
+        m_labels << label;
+    }
+    m_diffs.append(d);
+    m_changedBits += changed;
+    return true;
+}
+
+int FlagDiffAnalyzer::addPairFiles(const QList<PairFile>& files, QStringList* errors)
+{
+    QThreadPool pool;
+    QMutex errorMutex;
+    QAtomicInt added(0);
+
+    foreach (const PairFile& pair, files)
+        pool.start(new PairLoader(this, pair, errors, &errorMutex, &added));
+    pool.waitForDone();
+
+    return added.fetchAndAddOrdered(0);
+}
+
+QList<FlagDiffAnalyzer::PairFile> FlagDiffAnalyzer::readPairList(const QString& filename, QString* error)
+{
+    QList<PairFile> ret;
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        if (error)
+            *error = QString("Unable to open %1").arg(filename);
+        return ret;
+    }
+
+    QDir base = QFileInfo(filename).absoluteDir();
+    QTextStream in(&file);
+    int lineNo = 0;
+    while (!in.atEnd())
+    {
+        QString line = in.readLine().trimmed();
+        lineNo++;
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        QStringList parts = line.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+        if (parts.size() != 3)
+        {
+            if (error)
+                *error = QString("%1:%2: expected \"label before after\"").arg(filename).arg(lineNo);
+            return QList<PairFile>();
+        }
+
+        PairFile pair;
+        pair.Label  = parts[0];
+        pair.Before = base.absoluteFilePath(parts[1]);
+        pair.After  = base.absoluteFilePath(parts[2]);
+        ret << pair;
+    }
+    return ret;
+}
+
+QStringList FlagDiffAnalyzer::labels() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_labels;
+}
+
+int FlagDiffAnalyzer::pairCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_diffs.size();
+}
+
+int FlagDiffAnalyzer::pairCount(const QString& label) const
+{
+    QMutexLocker locker(&m_mutex);
+    int idx = m_labels.indexOf(label);
+    int count = 0;
+    foreach (const Diff& d, m_diffs)
+        if (d.Label == idx)
+            count++;
+    return count;
+}
+
+double FlagDiffAnalyzer::averageChangedBits() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_diffs.isEmpty())
+        return 0;
+    return double(m_changedBits) / m_diffs.size();
+}
+
+QList<FlagDiffAnalyzer::Candidate> FlagDiffAnalyzer::ranking(const QString& label, int max) const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<Candidate> ret;
+    const int idx = m_labels.indexOf(label);
+    if (idx < 0)
+        return ret;
+
+    QVector<quint32> labelCounts(bitCount(), 0);
+    QVector<quint32> allCounts(bitCount(), 0);
+    quint32 labelPairs = 0;
+    foreach (const Diff& d, m_diffs)
+    {
+        countBits(d, allCounts);
+        if (d.Label == idx)
+        {
+            countBits(d, labelCounts);
+            labelPairs++;
+        }
+    }
+    const quint32 otherPairs = m_diffs.size() - labelPairs;
+
+    for (int i = 0; i < labelCounts.size(); i++)
+    {
+        if (labelCounts[i] == 0)
+            continue;
+
+        Candidate c;
+        c.Offset    = i / 8;
+        c.Mask      = quint8(1 << (i % 8));
+        c.Hits      = labelCounts[i];
+        c.Pairs     = labelPairs;
+        c.OtherHits = allCounts[i] - labelCounts[i];
+        // How much more often the bit flips for this label than for the others
+        c.Score     = double(c.Hits) / labelPairs - (otherPairs ? double(c.OtherHits) / otherPairs : 0.0);
+        ret << c;
+    }
+
+    std::sort(ret.begin(), ret.end(), candidateLessThan);
+    if (max >= 0 && ret.size() > max)
+        ret = ret.mid(0, max);
+    return ret;
+}
+
+// XORs the files 16 bytes at a time and keeps only the 64 bit words which
+// differ. Saves only differ in a handful of bytes, so the result is tiny.
+FlagDiffAnalyzer::Diff FlagDiffAnalyzer::diff(const QByteArray& before, const QByteArray& after) const
+{
+    Diff d;
+    d.Label = -1;
+    const uchar* a = (const uchar*)before.constData();
+    const uchar* b = (const uchar*)after.constData();
+    const int size = before.size();
+    int i = 0;
+
+#ifdef BITOPS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        int same = _mm_movemask_epi8(_mm_cmpeq_epi8(x, zero));
+        if (same == 0xFFFF)
+            continue;
+
+        quint64 words[2];
+        _mm_storeu_si128((__m128i*)words, x);
+        if ((same & 0x00FF) != 0x00FF)
+        {
+            d.Words << quint32(i / 8);
+            d.Bits << words[0];
+        }
+        if ((same & 0xFF00) != 0xFF00)
+        {
+            d.Words << quint32(i / 8 + 1);
+            d.Bits << words[1];
+        }
+    }
+#endif
+
+    for (; i < size; i += 8)
+    {
+        quint64 wa = 0, wb = 0;
+        int len = qMin(8, size - i);
+        memcpy(&wa, a + i, len);
+        memcpy(&wb, b + i, len);
+        if (wa != wb)
+        {
+            d.Words << quint32(i / 8);
+            d.Bits << (wa ^ wb);
+        }
+    }
+
+    if (m_slotRelative)
+    {
+        // Slot boundaries are 8 byte aligned, so whole words can be moved.
+        // A bit that flipped in several slots still counts once for the pair.
+        QMap<quint32, quint64> words;
+        for (int w = 0; w < d.Words.size(); w++)
+        {
+            int offset = d.Words[w] * 8 - SLOT_START;
+            if (offset < 0 || offset >= SLOT_SIZE * SLOT_COUNT)
+                continue;
+            words[quint32((offset % SLOT_SIZE) / 8)] |= d.Bits[w];
+        }
+
+        Diff folded;
+        folded.Label = -1;
+        for (QMap<quint32, quint64>::const_iterator it = words.constBegin(); it != words.constEnd(); ++it)
+        {
+            folded.Words << it.key();
+            folded.Bits << it.value();
+        }
+        return folded;
+    }
+    return d;
+}
+
+void FlagDiffAnalyzer::countBits(const Diff& d, QVector<quint32>& counts) const
+{
+    for (int w = 0; w < d.Words.size(); w++)
+    {
+        quint64 bits = d.Bits[w];
+        while (bits)
+        {
+            int bit = countTrailingZeros64(bits);
+            // Words were loaded in host order, turn the bit back into byte + mask
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+            int byte = 7 - bit / 8;
+#else
+            int byte = bit / 8;
+#endif
+            counts[(d.Words[w] * 8 + byte) * 8 + (bit % 8)]++;
+            bits &= bits - 1;
+        }
+    }
+}
+
+int FlagDiffAnalyzer::bitCount() const
+{
+    int size = (m_slotRelative ? SLOT_SIZE : m_size);
+    // The last word may have been padded
+    return ((size + 7) & ~7) * 8;
+}
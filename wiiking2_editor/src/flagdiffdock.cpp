@@ -0,0 +1,226 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "flagdiffdock.h"
+#include "flagdiffjob.h"
+#include "skywardswordfile.h"
+#include "slotlayout.h"
+
+#include <QComboBox>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QLabel>
+#include <QProgressBar>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+
+FlagDiffDock::FlagDiffDock(QWidget *parent) :
+    QDockWidget(tr("Flag Discovery"), parent),
+    m_job(NULL)
+{
+    setObjectName("flagDiffDock");
+
+    QWidget* contents = new QWidget(this);
+
+    m_loadBtn = new QPushButton(tr("Load Pair List..."), contents);
+    m_loadBtn->setToolTip(tr("A text file with one \"label before.sav after.sav\" line per pair"));
+    m_clearBtn = new QPushButton(tr("Clear"), contents);
+    m_cancelBtn = new QPushButton(tr("Cancel"), contents);
+    m_cancelBtn->hide();
+    m_slotRelativeCheck = new QCheckBox(tr("Fold adventure slots"), contents);
+    m_slotRelativeCheck->setToolTip(tr("Counts changes in all three adventures towards the same slot offset"));
+    m_slotRelativeCheck->setChecked(true);
+    m_analyzer.setSlotRelative(true);
+    m_labelCombo = new QComboBox(contents);
+
+    m_resultTree = new QTreeWidget(contents);
+    m_resultTree->setRootIsDecorated(false);
+    m_resultTree->setHeaderLabels(QStringList() << tr("Offset") << tr("Mask") << tr("Hits") << tr("Other") << tr("Score"));
+    m_statusLabel = new QLabel(contents);
+    m_progress = new QProgressBar(contents);
+    m_progress->setRange(0, 100);
+    m_progress->hide();
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout;
+    buttonLayout->addWidget(m_loadBtn);
+    buttonLayout->addWidget(m_clearBtn);
+    buttonLayout->addWidget(m_cancelBtn);
+
+    QVBoxLayout* layout = new QVBoxLayout(contents);
+    layout->addLayout(buttonLayout);
+    layout->addWidget(m_slotRelativeCheck);
+    layout->addWidget(m_labelCombo);
+    layout->addWidget(m_resultTree);
+    layout->addWidget(m_progress);
+    layout->addWidget(m_statusLabel);
+    setWidget(contents);
+
+    connect(m_loadBtn,           SIGNAL(clicked()),                             this, SLOT(onLoadPairList()));
+    connect(m_clearBtn,          SIGNAL(clicked()),                             this, SLOT(onClear()));
+    connect(m_cancelBtn,         SIGNAL(clicked()),                             this, SLOT(onCancelLoad()));
+    connect(m_slotRelativeCheck, SIGNAL(toggled(bool)),                         this, SLOT(onSlotRelativeToggled(bool)));
+    connect(m_labelCombo,        SIGNAL(currentIndexChanged(int)),              this, SLOT(onLabelChanged(int)));
+    connect(m_resultTree,        SIGNAL(itemDoubleClicked(QTreeWidgetItem*,int)), this, SLOT(onItemActivated(QTreeWidgetItem*)));
+}
+
+// The job works on m_analyzer, so it has to stop before the member goes away
+FlagDiffDock::~FlagDiffDock()
+{
+    delete m_job;
+}
+
+void FlagDiffDock::onLoadPairList()
+{
+    QString filename = QFileDialog::getOpenFileName(this, tr("Open Pair List"), QString(), tr("Pair Lists (*.txt);;All Files (*)"));
+    if (filename.isEmpty())
+        return;
+
+    QString error;
+    QList<FlagDiffAnalyzer::PairFile> files = FlagDiffAnalyzer::readPairList(filename, &error);
+    if (!error.isEmpty())
+    {
+        m_statusLabel->setText(error);
+        return;
+    }
+
+    m_job = new FlagDiffJob(&m_analyzer, files, this);
+    connect(m_job, SIGNAL(progress(int,QString)), this, SLOT(onLoadProgress(int,QString)));
+    connect(m_job, SIGNAL(finished()),            this, SLOT(onLoadFinished()));
+    setLoading(true);
+    m_job->start();
+}
+
+void FlagDiffDock::onCancelLoad()
+{
+    if (!m_job)
+        return;
+
+    m_job->cancel();
+    m_cancelBtn->setEnabled(false);
+    m_statusLabel->setText(tr("Cancelling..."));
+}
+
+void FlagDiffDock::onLoadProgress(int percent, const QString& stage)
+{
+    m_progress->setValue(percent);
+    m_statusLabel->setText(stage);
+}
+
+void FlagDiffDock::onLoadFinished()
+{
+    if (!m_job)
+        return;
+
+    FlagDiffJob* job = m_job;
+    m_job = NULL;
+    setLoading(false);
+    updateLabels();
+
+    QString status = tr("Loaded %1 of %2 pairs in %3 ms").arg(job->added()).arg(job->pairCount()).arg(job->elapsed());
+    if (job->isCancelled())
+        status += tr(", cancelled");
+    QStringList errors = job->errors();
+    if (!errors.isEmpty())
+    {
+        status += tr(", %1 failed").arg(errors.size());
+        m_statusLabel->setToolTip(errors.join("\n"));
+    }
+    m_statusLabel->setText(status);
+    job->deleteLater();
+}
+
+// The analyzer belongs to the job until it is done
+void FlagDiffDock::setLoading(bool loading)
+{
+    m_loadBtn->setEnabled(!loading);
+    m_clearBtn->setEnabled(!loading);
+    m_slotRelativeCheck->setEnabled(!loading);
+    m_labelCombo->setEnabled(!loading);
+    m_cancelBtn->setEnabled(loading);
+    m_cancelBtn->setVisible(loading);
+    m_progress->setValue(0);
+    m_progress->setVisible(loading);
+    if (loading)
+        m_statusLabel->setToolTip(QString());
+}
+
+void FlagDiffDock::onClear()
+{
+    m_analyzer.clear();
+    m_statusLabel->clear();
+    m_statusLabel->setToolTip(QString());
+    updateLabels();
+}
+
+void FlagDiffDock::onSlotRelativeToggled(bool checked)
+{
+    // Folding changes the offsets, so the pairs have to be loaded again
+    m_analyzer.setSlotRelative(checked);
+    m_statusLabel->clear();
+    updateLabels();
+}
+
+void FlagDiffDock::onLabelChanged(int index)
+{
+    m_resultTree->clear();
+    if (index < 0)
+        return;
+
+    QString label = m_labelCombo->itemData(index).toString();
+    QList<FlagDiffAnalyzer::Candidate> ranking = m_analyzer.ranking(label, 100);
+    foreach (const FlagDiffAnalyzer::Candidate& c, ranking)
+    {
+        QTreeWidgetItem* item = new QTreeWidgetItem(m_resultTree);
+        item->setText(0, QString("0x%1").arg(c.Offset, 4, 16, QChar('0')));
+        item->setData(0, Qt::UserRole, c.Offset);
+        item->setText(1, QString("0x%1").arg(c.Mask, 2, 16, QChar('0')));
+        item->setText(2, QString("%1/%2").arg(c.Hits).arg(c.Pairs));
+        item->setText(3, QString::number(c.OtherHits));
+        item->setText(4, QString::number(c.Score, 'f', 3));
+    }
+}
+
+void FlagDiffDock::onItemActivated(QTreeWidgetItem* item)
+{
+    if (!item)
+        return;
+
+    int offset = item->data(0, Qt::UserRole).toInt();
+    if (m_analyzer.isSlotRelative())
+    {
+        emit addressActivated(SkywardSwordFile::GameNone, offset);
+        return;
+    }
+
+    int slotOffset = offset - SaveLayout::SLOT_OFFSET;
+    int game = slotOffset / SlotLayout::SIZE;
+    if (slotOffset < 0 || game >= SkywardSwordFile::GameCount)
+        m_statusLabel->setText(tr("The hex view only shows the adventure slots"));
+    else
+        emit addressActivated(game, slotOffset % SlotLayout::SIZE);
+}
+
+void FlagDiffDock::updateLabels()
+{
+    m_labelCombo->blockSignals(true);
+    m_labelCombo->clear();
+    foreach (const QString& label, m_analyzer.labels())
+        m_labelCombo->addItem(QString("%1 (%2)").arg(label).arg(m_analyzer.pairCount(label)), label);
+    m_labelCombo->blockSignals(false);
+
+    onLabelChanged(m_labelCombo->currentIndex());
+}
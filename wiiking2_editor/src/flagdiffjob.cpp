@@ -0,0 +1,80 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "flagdiffjob.h"
+#include <QElapsedTimer>
+
+FlagDiffJob::FlagDiffJob(FlagDiffAnalyzer* analyzer, const QList<FlagDiffAnalyzer::PairFile>& files, QObject* parent) :
+    QThread(parent),
+    m_analyzer(analyzer),
+    m_files(files),
+    m_added(0),
+    m_elapsed(0),
+    m_cancelled(0)
+{
+}
+
+FlagDiffJob::~FlagDiffJob()
+{
+    cancel();
+    wait();
+}
+
+void FlagDiffJob::cancel()
+{
+    m_cancelled.fetchAndStoreOrdered(1);
+}
+
+bool FlagDiffJob::isCancelled() const
+{
+    return m_cancelled.fetchAndAddOrdered(0) != 0;
+}
+
+int FlagDiffJob::pairCount() const
+{
+    return m_files.size();
+}
+
+int FlagDiffJob::added() const
+{
+    return m_added;
+}
+
+QStringList FlagDiffJob::errors() const
+{
+    return m_errors;
+}
+
+qint64 FlagDiffJob::elapsed() const
+{
+    return m_elapsed;
+}
+
+void FlagDiffJob::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Big enough to keep every core busy, small enough to cancel quickly
+    const int batchSize = qMax(1, QThread::idealThreadCount()) * 8;
+    for (int i = 0; i < m_files.size() && !isCancelled(); i += batchSize)
+    {
+        emit progress(i * 100 / m_files.size(), tr("Loading pair %1 of %2...").arg(i + 1).arg(m_files.size()));
+        m_added += m_analyzer->addPairFiles(m_files.mid(i, batchSize), &m_errors);
+    }
+
+    m_elapsed = timer.elapsed();
+    emit progress(100, tr("Done"));
+}
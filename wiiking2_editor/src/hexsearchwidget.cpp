@@ -0,0 +1,168 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "hexsearchwidget.h"
+#include "qhexedit2/qhexedit.h"
+
+#include <QComboBox>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QListWidget>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+
+// The list only shows the first hits, the hex view still highlights all of them
+const int MAX_LISTED_HITS = 1000;
+
+HexSearchWidget::HexSearchWidget(QHexEdit* hexEdit, QWidget *parent) :
+    QWidget(parent),
+    m_hexEdit(hexEdit)
+{
+    m_typeCombo   = new QComboBox(this);
+    m_typeCombo->addItem(tr("Hex"),     SearchPattern::HexBytes);
+    m_typeCombo->addItem(tr("Int16"),   SearchPattern::Int16Value);
+    m_typeCombo->addItem(tr("Int32"),   SearchPattern::Int32Value);
+    m_typeCombo->addItem(tr("Int64"),   SearchPattern::Int64Value);
+    m_typeCombo->addItem(tr("Float"),   SearchPattern::FloatValue);
+    m_typeCombo->addItem(tr("UTF-16"),  SearchPattern::Utf16String);
+
+    m_searchEdit  = new QLineEdit(this);
+    m_searchEdit->setToolTip(tr("Bytes in hex (use ? as wildcard nibble), a number or text depending on the type"));
+    m_nextBtn     = new QPushButton(tr("Next"), this);
+    m_prevBtn     = new QPushButton(tr("Previous"), this);
+    m_allBtn      = new QPushButton(tr("Find All"), this);
+    m_resultList  = new QListWidget(this);
+    m_statusLabel = new QLabel(this);
+
+    QHBoxLayout* inputLayout = new QHBoxLayout;
+    inputLayout->addWidget(m_typeCombo);
+    inputLayout->addWidget(m_searchEdit);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout;
+    buttonLayout->addWidget(m_prevBtn);
+    buttonLayout->addWidget(m_nextBtn);
+    buttonLayout->addWidget(m_allBtn);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setMargin(0);
+    layout->addLayout(inputLayout);
+    layout->addLayout(buttonLayout);
+    layout->addWidget(m_resultList);
+    layout->addWidget(m_statusLabel);
+    setMaximumWidth(260);
+
+    connect(m_searchEdit,   SIGNAL(returnPressed()),                 this, SLOT(findNext()));
+    connect(m_nextBtn,      SIGNAL(clicked()),                       this, SLOT(findNext()));
+    connect(m_prevBtn,      SIGNAL(clicked()),                       this, SLOT(findPrevious()));
+    connect(m_allBtn,       SIGNAL(clicked()),                       this, SLOT(findAll()));
+    connect(m_resultList,   SIGNAL(itemClicked(QListWidgetItem*)),   this, SLOT(onResultActivated(QListWidgetItem*)));
+    connect(m_hexEdit,      SIGNAL(searchHitsFound(QList<int>)),     this, SLOT(onHitsFound(QList<int>)));
+    connect(m_hexEdit,      SIGNAL(searchFinished(int)),             this, SLOT(onSearchFinished(int)));
+    connect(m_hexEdit,      SIGNAL(searchCleared()),                 this, SLOT(onSearchCleared()));
+}
+
+void HexSearchWidget::findNext()
+{
+    SearchPattern pattern;
+    if (!currentPattern(pattern))
+        return;
+
+    int idx = m_hexEdit->indexOf(pattern, m_hexEdit->cursorPosition());
+    if (idx < 0)
+        m_statusLabel->setText(tr("Not found"));
+    else
+        m_statusLabel->setText(tr("Found at 0x%1").arg(idx, 0, 16));
+}
+
+void HexSearchWidget::findPrevious()
+{
+    SearchPattern pattern;
+    if (!currentPattern(pattern))
+        return;
+
+    int idx = m_hexEdit->lastIndexOf(pattern, m_hexEdit->cursorPosition());
+    if (idx < 0)
+        m_statusLabel->setText(tr("Not found"));
+    else
+        m_statusLabel->setText(tr("Found at 0x%1").arg(idx, 0, 16));
+}
+
+void HexSearchWidget::findAll()
+{
+    SearchPattern pattern;
+    if (!currentPattern(pattern))
+        return;
+
+    m_lastPattern = pattern;
+    m_resultList->clear();
+    m_statusLabel->setText(tr("Searching..."));
+    m_hexEdit->findAll(pattern);
+}
+
+void HexSearchWidget::clear()
+{
+    // the list follows through searchCleared()
+    m_hexEdit->clearSearchHits();
+}
+
+void HexSearchWidget::onSearchCleared()
+{
+    m_resultList->clear();
+    m_statusLabel->clear();
+}
+
+void HexSearchWidget::onHitsFound(const QList<int>& hits)
+{
+    foreach (int hit, hits)
+    {
+        if (m_resultList->count() >= MAX_LISTED_HITS)
+            break;
+
+        QListWidgetItem* item = new QListWidgetItem(QString("0x%1").arg(QString::number(hit, 16).toUpper().rightJustified(4, '0')));
+        item->setData(Qt::UserRole, hit);
+        m_resultList->addItem(item);
+    }
+}
+
+void HexSearchWidget::onSearchFinished(int count)
+{
+    if (count > m_resultList->count())
+        m_statusLabel->setText(tr("%1 matches (first %2 listed)").arg(count).arg(m_resultList->count()));
+    else
+        m_statusLabel->setText(tr("%1 matches").arg(count));
+}
+
+void HexSearchWidget::onResultActivated(QListWidgetItem* item)
+{
+    if (!item || !m_lastPattern.isValid())
+        return;
+
+    m_hexEdit->indexOf(m_lastPattern, item->data(Qt::UserRole).toInt());
+}
+
+bool HexSearchWidget::currentPattern(SearchPattern& pattern)
+{
+    bool ok = false;
+    SearchPattern::ValueType type = (SearchPattern::ValueType)m_typeCombo->itemData(m_typeCombo->currentIndex()).toInt();
+    pattern = SearchPattern::fromValue(type, m_searchEdit->text(), &ok);
+    if (!ok)
+    {
+        m_statusLabel->setText(tr("Invalid search value"));
+        return false;
+    }
+
+    return true;
+}
@@ -26,13 +26,16 @@
 #include <QFileSystemWatcher>
 #include <QUrl>
 #include "qhexedit2/qhexedit.h"
+#include "qhexedit2/undoengine.h"
 #include <QDebug>
 #include <QtEndian>
 #include <QScrollArea>
-#include <QUndoStack>
+#include <QProgressBar>
+#include <QPushButton>
 
 #include "igamefile.h"
 #include "skywardswordfile.h"
+#include "tracer.h"
 #include "newgamedialog.h"
 #include "aboutdialog.h"
 #include "fileinfodialog.h"
@@ -42,6 +45,13 @@
 #include "settingsmanager.h"
 #include "playtimewidget.h"
 #include "importexportquestdialog.h"
+#include "hexsearchwidget.h"
+#include "valuescannerdock.h"
+#include "flagdiffdock.h"
+#include "comparedialog.h"
+#include "datainspectormodel.h"
+#include "fieldnames.h"
+#include "filejob.h"
 
 #ifdef DEBUG
 QString dir("D:/Projects/dolphin-emu/Binary/x64/User/Wii/title/00010000/534f5545/data");
@@ -59,7 +69,8 @@ MainWindow::MainWindow(QWidget *parent) :
     m_newFileDialog(NULL),
     m_fileInfoDialog(NULL),
     m_preferencesDialog(NULL),
-    m_settingsManager(SettingsManager::instance())
+    m_settingsManager(SettingsManager::instance()),
+    m_fileJob(NULL)
 {
     QSettings settings("WiiKing2", "WiiKing2 Editor");
 #ifdef Q_OS_WIN
@@ -99,6 +110,8 @@ MainWindow::MainWindow(QWidget *parent) :
     }
     setupActions();
     setupHexEdit();
+    setupTools();
+    setupFileJobs();
     setupConnections();
 
     m_playTime = new PlayTimeWidget(m_ui->playInfoGroup);
@@ -109,7 +122,7 @@ MainWindow::MainWindow(QWidget *parent) :
     if (qApp->arguments().count() > 1)
         // Attempt to open the file
     {
-        m_gameFile = new SkywardSwordFile(qApp->arguments()[1]);
+        openFile(qApp->arguments()[1]);
     }
     updateInfo();
     updateTitle();
@@ -118,6 +131,11 @@ MainWindow::MainWindow(QWidget *parent) :
 
 MainWindow::~MainWindow()
 {
+    if (m_fileJob)
+    {
+        m_fileJob->cancel();
+        m_fileJob->wait();
+    }
     delete m_ui;
     delete WiiKeys::instance();
     delete m_settingsManager;
@@ -168,22 +186,9 @@ void MainWindow::dropEvent(QDropEvent* event)
     const QMimeData* mimeData = event->mimeData();
 
     // check for our needed mime type, here a file or a list of files
-    if (mimeData->hasUrls())
-    {
-        if (!m_gameFile)
-            m_gameFile = new SkywardSwordFile();
-
-        if (m_curGame == SkywardSwordFile::GameNone)
-            m_curGame = SkywardSwordFile::Game1;
-
-        if (m_gameFile->open(m_curGame, mimeData->urls()[0].toLocalFile()))
-        {
-            m_hexEdit->setData(m_gameFile->gameData());
-            updateInfo();
-            updateTitle();
-        }
-    }
     statusBar()->clearMessage();
+    if (mimeData->hasUrls())
+        openFile(mimeData->urls()[0].toLocalFile());
 }
 
 void MainWindow::setupActions()
@@ -223,18 +228,34 @@ void MainWindow::setupHexEdit()
     m_hexEdit->setOverwriteMode(true);
     m_hexEdit->setInsertAllowed(false);
     m_ui->hexEditLayout->addWidget(m_hexEdit);
+    m_hexSearch = new HexSearchWidget(m_hexEdit, this);
+    m_ui->hexEditLayout->addWidget(m_hexSearch);
+
+    // Overlay the known fields, the colors repeat so neighbours differ
+    static const QRgb FIELD_COLORS[] = {0x60A0C8FF, 0x60A0E0A0, 0x60F0C080, 0x60D0A0E0, 0x6080D0D0, 0x60E0E080};
+    const int colorCount = sizeof(FIELD_COLORS) / sizeof(FIELD_COLORS[0]);
+    StructTemplate fields;
+    for (int i = 0; i < SAVE_FIELD_COUNT; i++)
+        fields.addField(SAVE_FIELDS[i].Offset, SAVE_FIELDS[i].Length, SAVE_FIELDS[i].Name,
+                        QColor::fromRgba(FIELD_COLORS[i % colorCount]));
+    m_hexEdit->setStructTemplate(fields);
 
     // Setup the inspector
-    QStandardItemModel* model = new QStandardItemModel(0, 2, this);
-    model->setHorizontalHeaderItem(0, new QStandardItem("Type"));
-    model->setHorizontalHeaderItem(1, new QStandardItem("Value"));
-    model->appendRow(new QStandardItem("char"));
-    model->appendRow(new QStandardItem("uchar"));
-    model->appendRow(new QStandardItem("int32"));
-    model->appendRow(new QStandardItem("uint32"));
-    model->appendRow(new QStandardItem("int64"));
-    model->appendRow(new QStandardItem("uint64"));
-    m_ui->inspectorView->setModel(model);
+    m_inspectorModel = new DataInspectorModel(this);
+    m_ui->inspectorView->setModel(m_inspectorModel);
+}
+
+void MainWindow::setupTools()
+{
+    m_valueScanner = new ValueScannerDock(this);
+    addDockWidget(Qt::RightDockWidgetArea, m_valueScanner);
+    m_valueScanner->hide();
+    m_ui->menu_Tools->addAction(m_valueScanner->toggleViewAction());
+
+    m_flagDiff = new FlagDiffDock(this);
+    addDockWidget(Qt::RightDockWidgetArea, m_flagDiff);
+    m_flagDiff->hide();
+    m_ui->menu_Tools->addAction(m_flagDiff->toggleViewAction());
 }
 
 void MainWindow::setupConnections()
@@ -257,9 +278,16 @@ void MainWindow::setupConnections()
     connect(m_ui->actionAbout,          SIGNAL(triggered()),          this, SLOT(onAbout()));
     connect(m_ui->actionAboutQt,        SIGNAL(triggered()),          this, SLOT(onAboutQt()));
     connect(m_ui->actionFileInfo,       SIGNAL(triggered()),          this, SLOT(onFileInfo()));
+    connect(m_ui->actionCompare,        SIGNAL(triggered()),          this, SLOT(onCompare()));
+    connect(m_ui->actionRecordTrace,    SIGNAL(toggled(bool)),        this, SLOT(onRecordTrace(bool)));
+    connect(m_ui->actionSaveTrace,      SIGNAL(triggered()),          this, SLOT(onSaveTrace()));
+    connect(m_ui->actionNextChange,     SIGNAL(triggered()),          m_hexEdit, SLOT(nextChange()));
+    connect(m_ui->actionPreviousChange, SIGNAL(triggered()),          m_hexEdit, SLOT(previousChange()));
     connect(m_ui->actionPreferences,    SIGNAL(triggered()),          this, SLOT(onPreferences()));
     connect(m_ui->actionExport,         SIGNAL(triggered()),          this, SLOT(onExport()));
     connect(m_ui->actionImport,         SIGNAL(triggered()),          this, SLOT(onImport()));
+    connect(m_valueScanner,             SIGNAL(addressActivated(int,int)), this, SLOT(onScannerAddressActivated(int,int)));
+    connect(m_flagDiff,                 SIGNAL(addressActivated(int,int)), this, SLOT(onFlagDiffAddressActivated(int,int)));
 
 }
 
@@ -448,53 +476,7 @@ void MainWindow::onTextChanged(QString text)
 
 void MainWindow::onCurrentAdressChanged(int address)
 {
-   qint8   charVal;
-   quint8  ucharVal;
-   qint32  int32Val;
-   quint32 uint32Val;
-   qint32  int64Val;
-   quint64 uint64Val;
-
-   if ((address + 1) <= m_hexEdit->data().size())
-   {
-       charVal = *(qint8*)(m_hexEdit->data().data() + address);
-       ucharVal = *(quint8*)(m_hexEdit->data().data() + address);
-   }
-   else
-   {
-       charVal = 0;
-       ucharVal = 0;
-   }
-
-   if ((address + 4) <= m_hexEdit->data().size())
-   {
-       int32Val = qFromBigEndian(*(qint32*)(m_hexEdit->data().data() + address));
-       uint32Val = qFromBigEndian(*(qint32*)(m_hexEdit->data().data() + address));
-   }
-   else
-   {
-       int32Val = 0;
-       uint32Val = 0;
-   }
-
-   if ((address + 8) <= m_hexEdit->data().size())
-   {
-       int64Val = qFromBigEndian(*(qint64*)(m_hexEdit->data().data() + address));
-       uint64Val = qFromBigEndian(*(qint64*)(m_hexEdit->data().data() + address));
-   }
-   else
-   {
-       int64Val = 0;
-       uint64Val = 0;
-   }
-
-   ((QStandardItemModel*)m_ui->inspectorView->model())->setItem(0, 1, new QStandardItem(QString("%1").arg((qint32)charVal)));
-   ((QStandardItemModel*)m_ui->inspectorView->model())->setItem(1, 1, new QStandardItem(QString("%1 '%2'").arg((quint32)ucharVal).arg(charVal)));
-   ((QStandardItemModel*)m_ui->inspectorView->model())->setItem(2, 1, new QStandardItem(QString("%1").arg(int32Val)));
-   ((QStandardItemModel*)m_ui->inspectorView->model())->setItem(3, 1, new QStandardItem(QString("%1").arg(uint32Val)));
-   ((QStandardItemModel*)m_ui->inspectorView->model())->setItem(4, 1, new QStandardItem(QString("%1").arg(int64Val)));
-   ((QStandardItemModel*)m_ui->inspectorView->model())->setItem(5, 1, new QStandardItem(QString("%1").arg(uint64Val)));
-
+   m_inspectorModel->setCursor(m_hexEdit->data(), address);
    m_ui->hexOffsetLbl->setText(QString("Offset " + QString("%1").arg(address, 4, 16, QLatin1Char('0')).toUpper()));
 }
 
@@ -503,8 +485,11 @@ void MainWindow::onHexDataChanged()
     if (!m_gameFile)
         return;
 
-    m_ui->hexRedoBtn->setEnabled(m_hexEdit->undoStack()->canRedo());
-    m_ui->hexUndoBtn->setEnabled(m_hexEdit->undoStack()->canUndo());
+    UndoEngine* undo = m_hexEdit->undoEngine();
+    m_ui->hexRedoBtn->setEnabled(undo->canRedo());
+    m_ui->hexUndoBtn->setEnabled(undo->canUndo());
+    m_ui->hexUndoBtn->setToolTip(tr("Undo (%1 steps, %2 KiB of history)").arg(undo->index()).arg(undo->memoryUsage() / 1024));
+    m_inspectorModel->setCursor(m_hexEdit->data(), m_inspectorModel->address());
     m_gameFile->setGameData(m_hexEdit->data());
     m_gameFile->updateChecksum();
     updateInfo();
@@ -532,8 +517,40 @@ void MainWindow::onHexGotoAddress()
     }
 }
 
+void MainWindow::onScannerAddressActivated(int game, int offset)
+{
+    // The hex view only shows the adventure slots
+    if (game < 0)
+    {
+        statusBar()->showMessage(tr("Offset 0x%1 is outside of the adventure slots").arg(offset, 0, 16));
+        return;
+    }
+
+    QAction* act = findChild<QAction*>(QString("actionGame%1").arg(game + 1));
+    if (act && !act->isChecked())
+        act->trigger();
+
+    m_ui->tabWidget->setCurrentWidget(m_ui->hexEditorTab);
+    m_hexEdit->setCursorPosition(offset);
+}
+
+void MainWindow::onFlagDiffAddressActivated(int game, int offset)
+{
+    // GameNone keeps the current adventure, for slot relative offsets
+    if (game != SkywardSwordFile::GameNone)
+    {
+        QAction* act = findChild<QAction*>(QString("actionGame%1").arg(game + 1));
+        if (act && !act->isChecked())
+            act->trigger();
+    }
+
+    m_ui->tabWidget->setCurrentWidget(m_ui->hexEditorTab);
+    m_hexEdit->setCursorPosition(offset);
+}
+
 void MainWindow::updateInfo()
 {
+    TRACE_PHASE_SCOPE("MainWindow::updateInfo", UpdateInfoPhase);
     if (!m_gameFile || !m_gameFile->isOpen() ||
         m_isUpdating || m_gameFile->game() == SkywardSwordFile::GameNone)
         return;
@@ -732,41 +749,58 @@ void MainWindow::onOpen()
 {
     QString filename = QFileDialog::getOpenFileName(this, tr("Open Skyward Sword Save..."), dir, tr("All Supported Formats (*.sav *.bin);;Skyward Sword Save Files (*.sav);;SaveData (*.bin)"));
     if (!filename.isEmpty())
-    {
-        if (m_gameFile)
-            delete m_gameFile;
-
-        m_gameFile = new SkywardSwordFile;
+        openFile(filename);
+}
 
-        if (filename.lastIndexOf(".bin") == filename.size() - 4)
-        {
-            if (!m_gameFile->loadDataBin(filename, m_gameFile->game()))
-                return;
-        }
-        else if (!m_gameFile->open(m_gameFile->game(), filename))
-            return;
+void MainWindow::openFile(const QString& filename)
+{
+    if (m_fileJob)
+        return;
 
-        m_gameFile->setGame(SkywardSwordFile::Game1);
-        m_ui->actionGame1->setChecked(true);
+    startFileJob(new FileJob(filename, this));
+}
 
-        if (!m_gameFile->hasValidChecksum())
+void MainWindow::finishOpen(FileJob* job)
+{
+    if (!job->succeeded())
+    {
+        if (job->isCancelled())
+            m_ui->statusBar->showMessage(tr("Open cancelled"));
+        else
         {
-            QMessageBox msg(QMessageBox::Warning, tr("CRC32 Mismatch"), tr("The checksum generated does not match the one provided by the file"));
+            m_ui->statusBar->clearMessage();
+            QMessageBox msg(QMessageBox::Warning, tr("Error loading file"), job->errorString(), QMessageBox::Ok, this);
             msg.exec();
         }
+        return;
+    }
 
-        m_ui->menuRecent->addAction(m_gameFile->filename());
+    // the old file stays until the new one is ready
+    if (m_gameFile)
+        delete m_gameFile;
+    m_gameFile = job->takeFile();
+    m_ui->actionGame1->setChecked(true);
 
-        foreach(QString file, m_fileWatcher->files())
-            m_fileWatcher->removePath(file);
+    m_ui->menuRecent->addAction(m_gameFile->filename());
 
+    foreach(QString file, m_fileWatcher->files())
+        m_fileWatcher->removePath(file);
 
-        m_fileWatcher->addPath(filename);
-        m_hexEdit->setData(m_gameFile->gameData());
-        updateInfo();
-        updateTitle();
-        updateMRU();
-        setupFileConnections();
+
+    m_fileWatcher->addPath(job->filename());
+    m_hexEdit->setData(m_gameFile->gameData());
+    m_hexEdit->undoEngine()->clear();
+    updateInfo();
+    updateTitle();
+    updateMRU();
+    setupFileConnections();
+    toggleWidgetStates();
+    m_ui->statusBar->clearMessage();
+
+    if (!job->hasValidChecksum())
+    {
+        QMessageBox msg(QMessageBox::Warning, tr("CRC32 Mismatch"), tr("The checksum generated does not match the one provided by the file"));
+        msg.exec();
     }
 }
 
@@ -859,10 +893,10 @@ void MainWindow::onDeleteGame()
 
 void MainWindow::onSave()
 {
-    if (!m_gameFile)
+    if (!m_gameFile || m_fileJob)
         return;
 
-    QString oldFilename = m_gameFile->filename();
+    m_filenameBeforeSave = m_gameFile->filename();
     m_fileWatcher->disconnect(this);
     foreach(QString file, m_fileWatcher->files())
         m_fileWatcher->removePath(file);
@@ -877,7 +911,12 @@ void MainWindow::onSave()
         m_gameFile->setFilename(file);
     }
 
-    if(m_gameFile->save())
+    startFileJob(new FileJob(m_gameFile, this));
+}
+
+void MainWindow::finishSave(FileJob* job)
+{
+    if (job->succeeded())
     {
         m_ui->statusBar->showMessage(tr("Save successful!"));
     }
@@ -888,21 +927,122 @@ void MainWindow::onSave()
             m_gameFile->setFilename(m_oldFilename);
             m_oldFilename = "";
         }
-        m_ui->statusBar->showMessage(tr("Unable to save file"));
+        if (job->isCancelled())
+            m_ui->statusBar->showMessage(tr("Save cancelled"));
+        else
+        {
+            m_ui->statusBar->showMessage(tr("Unable to save file"));
+            QMessageBox msg(QMessageBox::Warning, tr("Error saving file"), job->errorString(), QMessageBox::Ok, this);
+            msg.exec();
+        }
     }
 
     m_gameFile->updateChecksum();
     updateInfo();
     updateTitle();
     m_hexEdit->setData(m_gameFile->gameData());
-    if (oldFilename != m_gameFile->filename())
+    if (m_filenameBeforeSave != m_gameFile->filename())
     {
-        m_hexEdit->undoStack()->clear();
+        m_hexEdit->undoEngine()->clear();
         m_hexEdit->setCursorPosition(0);
         m_hexEdit->update();
     }
 }
 
+void MainWindow::setupFileJobs()
+{
+    m_jobProgress = new QProgressBar(this);
+    m_jobProgress->setRange(0, 100);
+    m_jobProgress->setMaximumWidth(160);
+    m_jobProgress->hide();
+    m_jobCancelBtn = new QPushButton(tr("Cancel"), this);
+    m_jobCancelBtn->hide();
+    m_ui->statusBar->addPermanentWidget(m_jobProgress);
+    m_ui->statusBar->addPermanentWidget(m_jobCancelBtn);
+    connect(m_jobCancelBtn, SIGNAL(clicked()), this, SLOT(onCancelFileJob()));
+}
+
+void MainWindow::startFileJob(FileJob* job)
+{
+    m_fileJob = job;
+    connect(job, SIGNAL(progress(int,QString)), this, SLOT(onFileJobProgress(int,QString)));
+    connect(job, SIGNAL(finished()),            this, SLOT(onFileJobFinished()));
+    setFileJobRunning(true);
+    job->start();
+}
+
+void MainWindow::finishFileJob(FileJob* job)
+{
+    m_fileJob = NULL;
+    if (job->type() == FileJob::OpenJob)
+        finishOpen(job);
+    else
+        finishSave(job);
+    setFileJobRunning(false);
+    job->deleteLater();
+}
+
+// Used where the result is needed right away, e.g. saving before closing
+void MainWindow::waitForFileJob()
+{
+    if (!m_fileJob)
+        return;
+
+    m_fileJob->wait();
+    finishFileJob(m_fileJob);
+}
+
+void MainWindow::setFileJobRunning(bool running)
+{
+    // Nothing may touch the file while a job works on it, so everything
+    // that could edit, replace or close it is disabled until it is done
+    QList<QAction*> actions;
+    actions << m_ui->actionOpen << m_ui->actionNew << m_ui->actionSave << m_ui->actionSaveAs
+            << m_ui->actionClose << m_ui->actionReload << m_ui->actionFileInfo << m_ui->actionCompare
+            << m_ui->actionExport << m_ui->actionImport << m_ui->actionNextChange << m_ui->actionPreviousChange;
+    foreach (QAction* action, actions)
+        action->setEnabled(!running);
+
+    m_gameGroup->setEnabled(!running);
+    m_ui->menuRecent->setEnabled(!running);
+    m_ui->centralWidget->setEnabled(!running);
+    m_valueScanner->setEnabled(!running);
+    m_flagDiff->setEnabled(!running);
+    m_fileWatcher->blockSignals(running);
+    setAcceptDrops(!running);
+
+    m_jobProgress->setValue(0);
+    m_jobProgress->setVisible(running);
+    m_jobCancelBtn->setEnabled(running);
+    m_jobCancelBtn->setVisible(running);
+
+    if (!running)
+        toggleWidgetStates();
+}
+
+void MainWindow::onFileJobProgress(int percent, const QString& stage)
+{
+    m_jobProgress->setValue(percent);
+    m_ui->statusBar->showMessage(stage);
+}
+
+void MainWindow::onFileJobFinished()
+{
+    // waitForFileJob() may have handled the job already
+    if (m_fileJob && m_fileJob->isFinished())
+        finishFileJob(m_fileJob);
+}
+
+void MainWindow::onCancelFileJob()
+{
+    if (!m_fileJob)
+        return;
+
+    m_fileJob->cancel();
+    m_jobCancelBtn->setEnabled(false);
+    m_ui->statusBar->showMessage(tr("Cancelling..."));
+}
+
 void MainWindow::onSaveAs()
 {
     if (!m_gameFile)
@@ -937,6 +1077,43 @@ void MainWindow::onFileInfo()
     m_hexEdit->setData(m_gameFile->gameData());
 }
 
+void MainWindow::onCompare()
+{
+    if (!m_gameFile || !m_gameFile->isOpen())
+        return;
+
+    CompareDialog dlg(m_gameFile, this);
+    dlg.exec();
+    if (!dlg.applied())
+        return;
+
+    updateInfo();
+    updateTitle();
+    m_hexEdit->setData(m_gameFile->gameData());
+}
+
+void MainWindow::onRecordTrace(bool record)
+{
+    if (record)
+        Tracer::clear();
+    Tracer::setEnabled(record);
+    m_ui->statusBar->showMessage(record ? tr("Recording trace...") : tr("Trace recording stopped"));
+}
+
+void MainWindow::onSaveTrace()
+{
+    QString file = QFileDialog::getSaveFileName(this, tr("Save Trace..."), QString(), tr("Chrome trace files (*.json)"));
+    if (file.isEmpty())
+        return;
+
+    if (!Tracer::save(file))
+    {
+        QMessageBox::warning(this, tr("Error"), tr("Could not write %1").arg(file));
+        return;
+    }
+    m_ui->statusBar->showMessage(tr("Saved %1 trace events").arg(Tracer::eventCount()));
+}
+
 void MainWindow::onPreferences()
 {
     if (!m_preferencesDialog)
@@ -1036,7 +1213,10 @@ void MainWindow::onClose()
                         QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
         int result = msg.exec();
         if (result == QMessageBox::Yes)
+        {
            onSave();
+           waitForFileJob();
+        }
 
         if(result == QMessageBox::Cancel)
            return;
@@ -1063,11 +1243,15 @@ void MainWindow::onClose()
 void MainWindow::toggleWidgetStates()
 {
     m_ui->actionFileInfo->setEnabled((m_gameFile != NULL && m_gameFile->isOpen()));
+    m_ui->actionCompare->setEnabled (m_gameFile != NULL && m_gameFile->isOpen());
+    m_ui->actionNextChange->setEnabled(m_gameFile != NULL && m_gameFile->isOpen());
+    m_ui->actionPreviousChange->setEnabled(m_gameFile != NULL && m_gameFile->isOpen());
     m_ui->tabWidget->setVisible   (m_gameFile != NULL && m_gameFile->isOpen());
     m_ui->actionSave->setEnabled  (m_gameFile != NULL && m_gameFile->isOpen());
     m_ui->actionSaveAs->setEnabled(m_gameFile != NULL && m_gameFile->isOpen());
     m_ui->actionClose->setEnabled (m_gameFile != NULL && m_gameFile->isOpen());
     m_ui->actionReload->setEnabled(m_gameFile != NULL && m_gameFile->isOpen());
+    m_valueScanner->setGameFile((m_gameFile != NULL && m_gameFile->isOpen()) ? m_gameFile : NULL);
     for (int i = 0; i < SkywardSwordFile::GameCount; i++)
     {
         QAction* act = this->findChild<QAction*>(QString("actionGame%1").arg(i+1));
@@ -1157,6 +1341,11 @@ void MainWindow::onCameraPositionChanged()
 
 void MainWindow::closeEvent(QCloseEvent* e)
 {
+    // an open is dropped, a running save has to finish first
+    if (m_fileJob && m_fileJob->type() == FileJob::OpenJob)
+        m_fileJob->cancel();
+    waitForFileJob();
+
     if (m_gameFile && m_gameFile->isModified())
     {
         QString filename = (m_gameFile->filename().isEmpty() ? "Untitled" : QFileInfo(m_gameFile->filename()).fileName());
@@ -1167,6 +1356,7 @@ void MainWindow::closeEvent(QCloseEvent* e)
         {
         case QMessageBox::Yes:
             onSave();
+            waitForFileJob();
             e->accept();
             break;
         case QMessageBox::No:
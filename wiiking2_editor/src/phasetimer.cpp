@@ -0,0 +1,78 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "phasetimer.h"
+
+#include <QThreadStorage>
+#include <string.h>
+
+struct PhaseTotals
+{
+    qint64 Ns[PhaseTimer::PhaseCount];
+};
+
+// Switched before the threads doing the work are started
+static bool enabledFlag = false;
+static QThreadStorage<PhaseTotals*> totals;
+
+static PhaseTotals* threadTotals()
+{
+    if (!totals.hasLocalData())
+    {
+        PhaseTotals* local = new PhaseTotals;
+        memset(local, 0, sizeof(PhaseTotals));
+        totals.setLocalData(local);
+    }
+    return totals.localData();
+}
+
+PhaseTimer::PhaseTimer(Phase phase) :
+    m_phase(phase),
+    m_running(isEnabled())
+{
+    if (m_running)
+        m_timer.start();
+}
+
+PhaseTimer::~PhaseTimer()
+{
+    if (m_running)
+        add(m_phase, m_timer.nsecsElapsed());
+}
+
+void PhaseTimer::setEnabled(bool enabled)
+{
+    enabledFlag = enabled;
+}
+
+bool PhaseTimer::isEnabled()
+{
+    return enabledFlag;
+}
+
+void PhaseTimer::reset()
+{
+    memset(threadTotals(), 0, sizeof(PhaseTotals));
+}
+
+qint64 PhaseTimer::elapsed(Phase phase)
+{
+    return threadTotals()->Ns[phase];
+}
+
+void PhaseTimer::add(Phase phase, qint64 ns)
+{
+    threadTotals()->Ns[phase] += ns;
+}
@@ -0,0 +1,263 @@
+#include <string.h>
+
+#include "qhexedit2/changebitmap.h"
+
+static const quint64 ALL_BITS = ~Q_UINT64_C(0);
+
+static int wordCount(int size)
+{
+    return (size + 63) >> 6;
+}
+
+// mask of count bits starting at bit shift, count may be 64
+static quint64 bitMask(int shift, int count)
+{
+    quint64 mask = (count >= 64) ? ALL_BITS : ((Q_UINT64_C(1) << count) - 1);
+    return mask << shift;
+}
+
+static int lowestBit(quint64 v)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(v);
+#else
+    int n = 0;
+    while (!(v & 1))
+    {
+        v >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static int highestBit(quint64 v)
+{
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(v);
+#else
+    int n = 63;
+    while (!(v & (Q_UINT64_C(1) << 63)))
+    {
+        v <<= 1;
+        n--;
+    }
+    return n;
+#endif
+}
+
+ChangeBitmap::ChangeBitmap()
+{
+    _size = 0;
+}
+
+void ChangeBitmap::reset(int size)
+{
+    _size = qMax(0, size);
+    _words.fill(0, wordCount(_size));
+}
+
+int ChangeBitmap::size() const
+{
+    return _size;
+}
+
+bool ChangeBitmap::testBit(int i) const
+{
+    return (_words[i >> 6] >> (i & 63)) & 1;
+}
+
+void ChangeBitmap::setRange(int from, int length, bool state)
+{
+    int to = qMin(from + length, _size);
+    from = qMax(from, 0);
+    while (from < to)
+    {
+        int shift = from & 63;
+        int count = qMin(64 - shift, to - from);
+        quint64 mask = bitMask(shift, count);
+        if (state)
+            _words[from >> 6] |= mask;
+        else
+            _words[from >> 6] &= ~mask;
+        from += count;
+    }
+}
+
+void ChangeBitmap::insert(int pos, int length, bool state)
+{
+    if (length <= 0)
+        return;
+    int oldSize = _size;
+    _size += length;
+    _words.resize(wordCount(_size));
+    moveBits(pos + length, pos, oldSize - pos);
+    setRange(pos, length, state);
+}
+
+void ChangeBitmap::remove(int pos, int length)
+{
+    length = qMin(length, _size - pos);
+    if (length <= 0)
+        return;
+    moveBits(pos, pos + length, _size - pos - length);
+    _size -= length;
+    _words.resize(wordCount(_size));
+    clearTail();
+}
+
+int ChangeBitmap::nextSet(int from) const
+{
+    if (from < 0)
+        from = 0;
+    if (from >= _size)
+        return -1;
+
+    int w = from >> 6;
+    quint64 v = _words[w] & (ALL_BITS << (from & 63));
+    while (v == 0)
+    {
+        if (++w >= _words.size())
+            return -1;
+        v = _words[w];
+    }
+    return (w << 6) + lowestBit(v);
+}
+
+int ChangeBitmap::nextClear(int from) const
+{
+    if (from < 0)
+        from = 0;
+    if (from >= _size)
+        return _size;
+
+    int w = from >> 6;
+    quint64 v = ~_words[w] & (ALL_BITS << (from & 63));
+    while (v == 0)
+    {
+        if (++w >= _words.size())
+            return _size;
+        v = ~_words[w];
+    }
+    return qMin((w << 6) + lowestBit(v), _size);
+}
+
+int ChangeBitmap::previousSet(int from) const
+{
+    if (from >= _size)
+        from = _size - 1;
+    if (from < 0)
+        return -1;
+
+    int w = from >> 6;
+    quint64 v = _words[w] & (ALL_BITS >> (63 - (from & 63)));
+    while (v == 0)
+    {
+        if (--w < 0)
+            return -1;
+        v = _words[w];
+    }
+    return (w << 6) + highestBit(v);
+}
+
+int ChangeBitmap::previousClear(int from) const
+{
+    if (from >= _size)
+        from = _size - 1;
+    if (from < 0)
+        return -1;
+
+    int w = from >> 6;
+    quint64 v = ~_words[w] & (ALL_BITS >> (63 - (from & 63)));
+    while (v == 0)
+    {
+        if (--w < 0)
+            return -1;
+        v = ~_words[w];
+    }
+    return (w << 6) + highestBit(v);
+}
+
+QByteArray ChangeBitmap::toBytes(int from, int length) const
+{
+    length = qMax(0, qMin(length, _size - from));
+    QByteArray result(length, char(0));
+    int end = from + length;
+    int i = nextSet(from);
+    while ((i >= 0) && (i < end))
+    {
+        int runEnd = qMin(nextClear(i), end);
+        memset(result.data() + (i - from), 1, runEnd - i);
+        i = nextSet(runEnd);
+    }
+    return result;
+}
+
+void ChangeBitmap::setBytes(int from, const QByteArray & states)
+{
+    int length = qMin(states.length(), _size - from);
+    for (int i = 0; i < length; i += 64)
+    {
+        int count = qMin(64, length - i);
+        quint64 value = 0;
+        for (int j = 0; j < count; j++)
+            if (states[i + j])
+                value |= Q_UINT64_C(1) << j;
+        setBits(from + i, count, value);
+    }
+}
+
+// count (<= 64) bits starting at pos, in the low bits of the result
+quint64 ChangeBitmap::bits(int pos, int count) const
+{
+    int w = pos >> 6;
+    int shift = pos & 63;
+    quint64 v = _words[w] >> shift;
+    if ((shift != 0) && (shift + count > 64))
+        v |= _words[w + 1] << (64 - shift);
+    return (count >= 64) ? v : (v & ((Q_UINT64_C(1) << count) - 1));
+}
+
+void ChangeBitmap::setBits(int pos, int count, quint64 value)
+{
+    int w = pos >> 6;
+    int shift = pos & 63;
+    int low = qMin(count, 64 - shift);
+    quint64 mask = bitMask(shift, low);
+    _words[w] = (_words[w] & ~mask) | ((value << shift) & mask);
+    if (low < count)
+    {
+        mask = bitMask(0, count - low);
+        _words[w + 1] = (_words[w + 1] & ~mask) | ((value >> low) & mask);
+    }
+}
+
+// Copies count bits from from to to, the ranges may overlap
+void ChangeBitmap::moveBits(int to, int from, int count)
+{
+    if ((count <= 0) || (to == from))
+        return;
+
+    if (to < from)
+    {
+        for (int i = 0; i < count; i += 64)
+        {
+            int n = qMin(64, count - i);
+            setBits(to + i, n, bits(from + i, n));
+        }
+    }
+    else
+    {
+        for (int i = count; i > 0; i -= 64)
+        {
+            int n = qMin(64, i);
+            setBits(to + i - n, n, bits(from + i - n, n));
+        }
+    }
+}
+
+void ChangeBitmap::clearTail()
+{
+    if (_size & 63)
+        _words[_size >> 6] &= bitMask(0, _size & 63);
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+
+#include "qhexedit2/diffengine.h"
+#include "bitops.h"
+
+static void appendRun(QVector<DiffRange> & out, int start, int length)
+{
+    if (!out.isEmpty() && out.last().end() == start)
+    {
+        out.last().length += length;
+        return;
+    }
+    DiffRange range;
+    range.start = start;
+    range.length = length;
+    out.append(range);
+}
+
+static bool rangeEndsBefore(const DiffRange & range, int pos)
+{
+    return range.end() < pos;
+}
+
+static bool rangeStartsAfter(int pos, const DiffRange & range)
+{
+    return pos < range.start;
+}
+
+DiffEngine::DiffEngine()
+{
+    _leftSize = 0;
+    _rightSize = 0;
+}
+
+void DiffEngine::compute(const QByteArray & left, const QByteArray & right)
+{
+    _ranges.clear();
+    _leftSize = left.size();
+    _rightSize = right.size();
+    scan((const uchar*)left.constData(), (const uchar*)right.constData(), 0, qMin(_leftSize, _rightSize), _ranges);
+    if (_leftSize != _rightSize)
+        appendRun(_ranges, qMin(_leftSize, _rightSize), qAbs(_leftSize - _rightSize));
+}
+
+void DiffEngine::update(const QByteArray & left, const QByteArray & right, int index, int length)
+{
+    // Inserts and removes shift everything, there is nothing to reuse
+    if (left.size() != _leftSize || right.size() != _rightSize)
+    {
+        compute(left, right);
+        return;
+    }
+
+    const int common = qMin(_leftSize, _rightSize);
+    int from = qMax(0, index);
+    int to = qMin(common, index + length);
+    if (from >= to)
+        return;
+
+    // Runs touching the edited area are dropped and compared again, so the
+    // new runs merge with their neighbours
+    QVector<DiffRange>::iterator first = std::lower_bound(_ranges.begin(), _ranges.end(), from, rangeEndsBefore);
+    QVector<DiffRange>::iterator last = std::upper_bound(first, _ranges.end(), to, rangeStartsAfter);
+    if (first != last)
+    {
+        from = qMin(from, first->start);
+        to = qMax(to, qMin(common, (last - 1)->end()));
+    }
+
+    QVector<DiffRange> fresh;
+    scan((const uchar*)left.constData(), (const uchar*)right.constData(), from, to, fresh);
+    // A size difference tail behind the common part is kept as it is
+    if (first != last && (last - 1)->end() > common)
+        appendRun(fresh, common, (last - 1)->end() - common);
+
+    int pos = first - _ranges.begin();
+    _ranges.remove(pos, last - first);
+    for (int i = 0; i < fresh.size(); i++)
+        _ranges.insert(pos + i, fresh[i]);
+}
+
+void DiffEngine::clear()
+{
+    _ranges.clear();
+    _leftSize = 0;
+    _rightSize = 0;
+}
+
+const QVector<DiffRange> & DiffEngine::ranges() const
+{
+    return _ranges;
+}
+
+int DiffEngine::differentBytes() const
+{
+    int count = 0;
+    for (int i = 0; i < _ranges.size(); i++)
+        count += _ranges[i].length;
+    return count;
+}
+
+int DiffEngine::rangeAt(int pos) const
+{
+    QVector<DiffRange>::const_iterator it = std::upper_bound(_ranges.constBegin(), _ranges.constEnd(), pos, rangeStartsAfter);
+    if (it == _ranges.constBegin())
+        return -1;
+    --it;
+    return (pos < it->end()) ? int(it - _ranges.constBegin()) : -1;
+}
+
+int DiffEngine::nextRange(int pos) const
+{
+    QVector<DiffRange>::const_iterator it = std::upper_bound(_ranges.constBegin(), _ranges.constEnd(), pos, rangeStartsAfter);
+    return (it == _ranges.constEnd()) ? -1 : int(it - _ranges.constBegin());
+}
+
+int DiffEngine::previousRange(int pos) const
+{
+    // Last range starting before pos, from the middle of a range that is
+    // the range itself
+    QVector<DiffRange>::const_iterator it = std::upper_bound(_ranges.constBegin(), _ranges.constEnd(), pos - 1, rangeStartsAfter);
+    return int(it - _ranges.constBegin()) - 1;
+}
+
+// Appends the differing runs of [from, to) to out
+void DiffEngine::scan(const uchar *left, const uchar *right, int from, int to, QVector<DiffRange> & out)
+{
+    int i = from;
+    int runStart = -1;
+
+#ifdef BITOPS_SSE2
+    // Align the block loop, the head is handled byte wise
+    for (; i < to && (i & 15) != 0; i++)
+    {
+        if (left[i] != right[i])
+        {
+            if (runStart < 0)
+                runStart = i;
+        }
+        else if (runStart >= 0)
+        {
+            appendRun(out, runStart, i - runStart);
+            runStart = -1;
+        }
+    }
+
+    for (; i + 16 <= to; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(left + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(right + i));
+        int equal = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+        if (equal == 0xFFFF)
+        {
+            if (runStart >= 0)
+            {
+                appendRun(out, runStart, i - runStart);
+                runStart = -1;
+            }
+            continue;
+        }
+        if (equal == 0 && runStart >= 0)
+            continue;                       // the run goes on through the whole block
+
+        for (int j = 0; j < 16; j++)
+        {
+            if (!(equal & (1 << j)))
+            {
+                if (runStart < 0)
+                    runStart = i + j;
+            }
+            else if (runStart >= 0)
+            {
+                appendRun(out, runStart, i + j - runStart);
+                runStart = -1;
+            }
+        }
+    }
+#endif
+
+    for (; i < to; i++)
+    {
+        if (left[i] != right[i])
+        {
+            if (runStart < 0)
+                runStart = i;
+        }
+        else if (runStart >= 0)
+        {
+            appendRun(out, runStart, i - runStart);
+            runStart = -1;
+        }
+    }
+
+    if (runStart >= 0)
+        appendRun(out, runStart, to - runStart);
+}
@@ -0,0 +1,271 @@
+#include <string.h>
+
+#include "qhexedit2/hexdumpformatter.h"
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+static const char BASE64_DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const int BASE64_LINE_BYTES = 57;    // 76 output characters
+
+// Lookup tables shared by all formatters, built once at startup
+struct DumpTables
+{
+    char hexPair[256][2];
+    char ascii[256];
+
+    DumpTables()
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            hexPair[i][0] = HEX_DIGITS[i >> 4];
+            hexPair[i][1] = HEX_DIGITS[i & 0x0F];
+            ascii[i] = ((i < 0x20) || (i > 0x7e)) ? '.' : char(i);
+        }
+    }
+};
+
+static const DumpTables TABLES;
+
+static int addressDigits(quint64 address)
+{
+    int digits = 1;
+    while (address >>= 4)
+        digits++;
+    return digits;
+}
+
+static char *writeAddress(char *out, quint64 address, int width)
+{
+    for (int i = width - 1; i >= 0; i--)
+    {
+        out[i] = HEX_DIGITS[address & 0x0F];
+        address >>= 4;
+    }
+    return out + width;
+}
+
+HexDumpFormatter::HexDumpFormatter(Style style)
+{
+    _style = style;
+    _addressOffset = 0;
+    _addressWidth = 4;
+}
+
+void HexDumpFormatter::setStyle(Style style)
+{
+    _style = style;
+}
+
+HexDumpFormatter::Style HexDumpFormatter::style() const
+{
+    return _style;
+}
+
+void HexDumpFormatter::setAddressOffset(int offset)
+{
+    _addressOffset = offset;
+}
+
+void HexDumpFormatter::setAddressWidth(int width)
+{
+    _addressWidth = width;
+}
+
+QByteArray HexDumpFormatter::format(const char *data, int size, int index) const
+{
+    QByteArray result(maxOutputSize(size), Qt::Uninitialized);
+    char *out = result.data();
+    int len = header(out, size);
+    len += body(out + len, (const uchar*)data, size, index);
+    len += footer(out + len, size);
+    result.resize(len);
+    return result;
+}
+
+bool HexDumpFormatter::write(QIODevice *device, const char *data, int size, int index) const
+{
+    const int chunk = chunkSize();
+    QByteArray buffer(maxOutputSize(qMin(size, chunk)), Qt::Uninitialized);
+    char *out = buffer.data();
+
+    int len = header(out, size);
+    for (int pos = 0; pos < size; pos += chunk)
+    {
+        len += body(out + len, (const uchar*)data + pos, qMin(chunk, size - pos), index + pos);
+        if (device->write(out, len) != len)
+            return false;
+        len = 0;
+    }
+    len += footer(out + len, size);
+    return device->write(out, len) == len;
+}
+
+int HexDumpFormatter::maxOutputSize(int size) const
+{
+    int lines = (size + BYTES_PER_LINE - 1) / BYTES_PER_LINE;
+    switch (_style)
+    {
+        case HexDump:
+            // 16 address digits at most, a blank, 48 hex, two blanks, 17 ascii, newline
+            return lines * (16 + 1 + 3 * BYTES_PER_LINE + 2 + BYTES_PER_LINE + 1 + 1);
+        case HexBytes:
+            return size * 3 + lines;
+        case CArray:
+            return 64 + size * 6 + lines * 5;
+        case PythonBytes:
+            return 32 + size * 4 + lines * 8;
+        case Base64:
+            return ((size + 2) / 3) * 4 + (size + BASE64_LINE_BYTES - 1) / BASE64_LINE_BYTES;
+    }
+    return 0;
+}
+
+int HexDumpFormatter::header(char *out, int size) const
+{
+    switch (_style)
+    {
+        case CArray:
+            return qsnprintf(out, 64, "const unsigned char data[%d] = {\n", size);
+        case PythonBytes:
+            if (size == 0)
+            {
+                memcpy(out, "data = b\"\"\n", 11);
+                return 11;
+            }
+            memcpy(out, "data = (\n", 9);
+            return 9;
+        default:
+            return 0;
+    }
+}
+
+int HexDumpFormatter::footer(char *out, int size) const
+{
+    switch (_style)
+    {
+        case CArray:
+            memcpy(out, "};\n", 3);
+            return 3;
+        case PythonBytes:
+            // the header already closed an empty literal
+            if (size == 0)
+                return 0;
+            memcpy(out, ")\n", 2);
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+int HexDumpFormatter::chunkSize() const
+{
+    // chunks have to end on a line, base64 also on a group of three bytes
+    if (_style == Base64)
+        return (CHUNK_SIZE / BASE64_LINE_BYTES) * BASE64_LINE_BYTES;
+    return CHUNK_SIZE;
+}
+
+int HexDumpFormatter::body(char *out, const uchar *data, int size, int index) const
+{
+    char *p = out;
+    switch (_style)
+    {
+        case HexDump:
+        {
+            quint64 first = quint64(_addressOffset) + index;
+            int width = qMax(_addressWidth, addressDigits(first + (size > 0 ? size - 1 : 0)));
+            for (int i = 0; i < size; i += BYTES_PER_LINE)
+            {
+                int n = qMin(int(BYTES_PER_LINE), size - i);
+                p = writeAddress(p, first + i, width);
+                *p++ = ' ';
+                for (int j = 0; j < n; j++)
+                {
+                    *p++ = ' ';
+                    *p++ = TABLES.hexPair[data[i + j]][0];
+                    *p++ = TABLES.hexPair[data[i + j]][1];
+                }
+                memset(p, ' ', (BYTES_PER_LINE - n) * 3 + 2);
+                p += (BYTES_PER_LINE - n) * 3 + 2;
+                for (int j = 0; j < n; j++)
+                    *p++ = TABLES.ascii[data[i + j]];
+                memset(p, ' ', BYTES_PER_LINE + 1 - n);
+                p += BYTES_PER_LINE + 1 - n;
+                *p++ = '\n';
+            }
+            break;
+        }
+        case HexBytes:
+            for (int i = 0; i < size; i++)
+            {
+                *p++ = TABLES.hexPair[data[i]][0];
+                *p++ = TABLES.hexPair[data[i]][1];
+                *p++ = ' ';
+                if (((index + i) % BYTES_PER_LINE) == (BYTES_PER_LINE - 1))
+                    *p++ = '\n';
+            }
+            break;
+        case CArray:
+            for (int i = 0; i < size; i += BYTES_PER_LINE)
+            {
+                int n = qMin(int(BYTES_PER_LINE), size - i);
+                memcpy(p, "    ", 4);
+                p += 4;
+                for (int j = 0; j < n; j++)
+                {
+                    *p++ = '0';
+                    *p++ = 'x';
+                    *p++ = TABLES.hexPair[data[i + j]][0];
+                    *p++ = TABLES.hexPair[data[i + j]][1];
+                    *p++ = ',';
+                    if (j + 1 < n)
+                        *p++ = ' ';
+                }
+                *p++ = '\n';
+            }
+            break;
+        case PythonBytes:
+            for (int i = 0; i < size; i += BYTES_PER_LINE)
+            {
+                int n = qMin(int(BYTES_PER_LINE), size - i);
+                memcpy(p, "    b\"", 6);
+                p += 6;
+                for (int j = 0; j < n; j++)
+                {
+                    *p++ = '\\';
+                    *p++ = 'x';
+                    *p++ = TABLES.hexPair[data[i + j]][0];
+                    *p++ = TABLES.hexPair[data[i + j]][1];
+                }
+                *p++ = '"';
+                *p++ = '\n';
+            }
+            break;
+        case Base64:
+            for (int i = 0; i < size; i += BASE64_LINE_BYTES)
+            {
+                int end = qMin(i + BASE64_LINE_BYTES, size);
+                int j = i;
+                for (; j + 3 <= end; j += 3)
+                {
+                    quint32 v = (quint32(data[j]) << 16) | (quint32(data[j + 1]) << 8) | data[j + 2];
+                    *p++ = BASE64_DIGITS[(v >> 18) & 0x3F];
+                    *p++ = BASE64_DIGITS[(v >> 12) & 0x3F];
+                    *p++ = BASE64_DIGITS[(v >> 6) & 0x3F];
+                    *p++ = BASE64_DIGITS[v & 0x3F];
+                }
+                if (j < end)
+                {
+                    quint32 v = quint32(data[j]) << 16;
+                    if (j + 1 < end)
+                        v |= quint32(data[j + 1]) << 8;
+                    *p++ = BASE64_DIGITS[(v >> 18) & 0x3F];
+                    *p++ = BASE64_DIGITS[(v >> 12) & 0x3F];
+                    *p++ = (j + 1 < end) ? BASE64_DIGITS[(v >> 6) & 0x3F] : '=';
+                    *p++ = '=';
+                }
+                *p++ = '\n';
+            }
+            break;
+    }
+    return int(p - out);
+}
@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <climits>
+
+#include "qhexedit2/intervaltree.h"
+
+IntervalTree::IntervalTree()
+{
+}
+
+void IntervalTree::build(const QVector<int> & starts, const QVector<int> & ends)
+{
+    _nodes.resize(starts.size());
+    for (int i = 0; i < starts.size(); i++)
+    {
+        _nodes[i].start = starts[i];
+        _nodes[i].end = ends[i];
+        _nodes[i].id = i;
+    }
+    std::stable_sort(_nodes.begin(), _nodes.end());
+    buildMaxEnd(0, _nodes.size());
+}
+
+void IntervalTree::clear()
+{
+    _nodes.clear();
+}
+
+bool IntervalTree::isEmpty() const
+{
+    return _nodes.isEmpty();
+}
+
+void IntervalTree::overlapping(int from, int to, QVector<int> & ids) const
+{
+    ids.clear();
+    if (from < to)
+        query(0, _nodes.size(), from, to, ids);
+}
+
+void IntervalTree::containing(int pos, QVector<int> & ids) const
+{
+    overlapping(pos, pos + 1, ids);
+}
+
+int IntervalTree::buildMaxEnd(int lo, int hi)
+{
+    if (lo >= hi)
+        return INT_MIN;
+
+    int mid = (lo + hi) / 2;
+    int maxEnd = _nodes[mid].end;
+    maxEnd = qMax(maxEnd, buildMaxEnd(lo, mid));
+    maxEnd = qMax(maxEnd, buildMaxEnd(mid + 1, hi));
+    _nodes[mid].maxEnd = maxEnd;
+    return maxEnd;
+}
+
+void IntervalTree::query(int lo, int hi, int from, int to, QVector<int> & ids) const
+{
+    if (lo >= hi)
+        return;
+
+    int mid = (lo + hi) / 2;
+    const Node & node = _nodes[mid];
+    if (node.maxEnd <= from)
+        return;                             // everything below ends too early
+
+    query(lo, mid, from, to, ids);
+    if (node.start >= to)
+        return;                             // this one and all to the right start too late
+    if (node.end > from)
+        ids.append(node.id);
+    query(mid + 1, hi, from, to, ids);
+}
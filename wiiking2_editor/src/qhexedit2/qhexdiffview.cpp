@@ -0,0 +1,178 @@
+#include <QtGui>
+#include <QLabel>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include "qhexedit2/qhexdiffview.h"
+
+
+QHexDiffView::QHexDiffView(QWidget *parent) : QWidget(parent)
+{
+    _leftLabel = new QLabel(this);
+    _rightLabel = new QLabel(this);
+    _left = new QHexEdit(this);
+    _right = new QHexEdit(this);
+    _left->setInsertAllowed(false);
+    _right->setInsertAllowed(false);
+
+    _prevButton = new QPushButton(tr("Previous Difference"), this);
+    _nextButton = new QPushButton(tr("Next Difference"), this);
+    _statusLabel = new QLabel(this);
+
+    QGridLayout *editLayout = new QGridLayout;
+    editLayout->addWidget(_leftLabel, 0, 0);
+    editLayout->addWidget(_rightLabel, 0, 1);
+    editLayout->addWidget(_left, 1, 0);
+    editLayout->addWidget(_right, 1, 1);
+
+    QHBoxLayout *navLayout = new QHBoxLayout;
+    navLayout->addWidget(_prevButton);
+    navLayout->addWidget(_nextButton);
+    navLayout->addWidget(_statusLabel, 1);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(editLayout);
+    layout->addLayout(navLayout);
+
+    // setValue() doesn't signal an unchanged value, so the pairs don't loop
+    connect(_left->verticalScrollBar(), SIGNAL(valueChanged(int)), _right->verticalScrollBar(), SLOT(setValue(int)));
+    connect(_right->verticalScrollBar(), SIGNAL(valueChanged(int)), _left->verticalScrollBar(), SLOT(setValue(int)));
+    connect(_left->horizontalScrollBar(), SIGNAL(valueChanged(int)), _right->horizontalScrollBar(), SLOT(setValue(int)));
+    connect(_right->horizontalScrollBar(), SIGNAL(valueChanged(int)), _left->horizontalScrollBar(), SLOT(setValue(int)));
+
+    connect(_left, SIGNAL(bytesChanged(int,int)), this, SLOT(onBytesChanged(int,int)));
+    connect(_right, SIGNAL(bytesChanged(int,int)), this, SLOT(onBytesChanged(int,int)));
+    connect(_left, SIGNAL(currentAddressChanged(int)), this, SLOT(onCurrentAddressChanged(int)));
+    connect(_right, SIGNAL(currentAddressChanged(int)), this, SLOT(onCurrentAddressChanged(int)));
+    connect(_prevButton, SIGNAL(clicked()), this, SLOT(previousDifference()));
+    connect(_nextButton, SIGNAL(clicked()), this, SLOT(nextDifference()));
+}
+
+void QHexDiffView::setData(const QByteArray & left, const QByteArray & right)
+{
+    _left->setData(left);
+    _right->setData(right);
+    _diff.compute(left, right);
+    refresh();
+}
+
+void QHexDiffView::setLabels(const QString & left, const QString & right)
+{
+    _leftLabel->setText(left);
+    _rightLabel->setText(right);
+}
+
+void QHexDiffView::addField(int offset, int length, const QString & name)
+{
+    Field field;
+    field.length = length;
+    field.name = name;
+    _fields.insert(offset, field);
+}
+
+void QHexDiffView::clearFields()
+{
+    _fields.clear();
+}
+
+QString QHexDiffView::fieldAt(int offset) const
+{
+    QMap<int, Field>::const_iterator it = _fields.upperBound(offset);
+    if (it == _fields.constBegin())
+        return QString();
+    --it;
+    return (offset < it.key() + it.value().length) ? it.value().name : QString();
+}
+
+QHexEdit *QHexDiffView::leftEdit() const
+{
+    return _left;
+}
+
+QHexEdit *QHexDiffView::rightEdit() const
+{
+    return _right;
+}
+
+QByteArray QHexDiffView::leftData() const
+{
+    return _left->data();
+}
+
+QByteArray QHexDiffView::rightData() const
+{
+    return _right->data();
+}
+
+const DiffEngine & QHexDiffView::diff() const
+{
+    return _diff;
+}
+
+void QHexDiffView::nextDifference()
+{
+    int rangeIdx = _diff.nextRange(_left->cursorPosition());
+    if (rangeIdx < 0)
+        _statusLabel->setText(tr("No more differences"));
+    else
+        showDifference(rangeIdx);
+}
+
+void QHexDiffView::previousDifference()
+{
+    int rangeIdx = _diff.previousRange(_left->cursorPosition());
+    if (rangeIdx < 0)
+        _statusLabel->setText(tr("No more differences"));
+    else
+        showDifference(rangeIdx);
+}
+
+void QHexDiffView::onBytesChanged(int index, int length)
+{
+    _diff.update(_left->data(), _right->data(), index, length);
+    refresh();
+}
+
+void QHexDiffView::onCurrentAddressChanged(int address)
+{
+    // keep both cursors on the same byte, the check stops the ping-pong
+    if (_left->cursorPosition() != address)
+        _left->setCursorPosition(address);
+    if (_right->cursorPosition() != address)
+        _right->setCursorPosition(address);
+    updateStatus(address);
+}
+
+void QHexDiffView::showDifference(int rangeIdx)
+{
+    _left->setCursorPosition(_diff.ranges()[rangeIdx].start);
+}
+
+void QHexDiffView::refresh()
+{
+    _left->setDiffRanges(_diff.ranges());
+    _right->setDiffRanges(_diff.ranges());
+    _prevButton->setEnabled(!_diff.ranges().isEmpty());
+    _nextButton->setEnabled(!_diff.ranges().isEmpty());
+    updateStatus(_left->cursorPosition());
+    emit differencesChanged(_diff.ranges().size(), _diff.differentBytes());
+}
+
+void QHexDiffView::updateStatus(int address)
+{
+    QString text = tr("%1 differences, %2 bytes").arg(_diff.ranges().size()).arg(_diff.differentBytes());
+
+    int rangeIdx = _diff.rangeAt(address);
+    if (rangeIdx >= 0)
+    {
+        const DiffRange & range = _diff.ranges()[rangeIdx];
+        text += tr(" - 0x%1..0x%2").arg(range.start, 4, 16, QChar('0')).arg(range.end() - 1, 4, 16, QChar('0'));
+    }
+
+    QString field = fieldAt(address);
+    if (!field.isEmpty())
+        text += tr(" - %1").arg(field);
+    _statusLabel->setText(text);
+}
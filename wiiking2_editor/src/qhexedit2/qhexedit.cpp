@@ -1,6 +1,7 @@
 #include <QtGui>
 #include <QHBoxLayout>
 #include "qhexedit2/qhexedit.h"
+#include "qhexedit2/undoengine.h"
 
 
 QHexEdit::QHexEdit(QWidget *parent) : QScrollArea(parent)
@@ -11,8 +12,12 @@ QHexEdit::QHexEdit(QWidget *parent) : QScrollArea(parent)
 
     connect(qHexEdit_p, SIGNAL(currentAddressChanged(int)), this, SIGNAL(currentAddressChanged(int)));
     connect(qHexEdit_p, SIGNAL(currentSizeChanged(int)), this, SIGNAL(currentSizeChanged(int)));
+    connect(qHexEdit_p, SIGNAL(bytesChanged(int,int)), this, SIGNAL(bytesChanged(int,int)));
     connect(qHexEdit_p, SIGNAL(dataChanged()), this, SIGNAL(dataChanged()));
     connect(qHexEdit_p, SIGNAL(overwriteModeChanged(bool)), this, SIGNAL(overwriteModeChanged(bool)));
+    connect(qHexEdit_p, SIGNAL(searchHitsFound(QList<int>)), this, SIGNAL(searchHitsFound(QList<int>)));
+    connect(qHexEdit_p, SIGNAL(searchFinished(int)), this, SIGNAL(searchFinished(int)));
+    connect(qHexEdit_p, SIGNAL(searchCleared()), this, SIGNAL(searchCleared()));
     setFocusPolicy(Qt::NoFocus);
 }
 
@@ -21,6 +26,11 @@ int QHexEdit::indexOf(const QByteArray & ba, int from) const
     return qHexEdit_p->indexOf(ba, from);
 }
 
+int QHexEdit::indexOf(const SearchPattern & pattern, int from) const
+{
+    return qHexEdit_p->indexOf(pattern, from);
+}
+
 void QHexEdit::insert(int i, const QByteArray & ba)
 {
     qHexEdit_p->insert(i, ba);
@@ -36,6 +46,46 @@ int QHexEdit::lastIndexOf(const QByteArray & ba, int from) const
     return qHexEdit_p->lastIndexOf(ba, from);
 }
 
+int QHexEdit::lastIndexOf(const SearchPattern & pattern, int from) const
+{
+    return qHexEdit_p->lastIndexOf(pattern, from);
+}
+
+void QHexEdit::findAll(const SearchPattern & pattern)
+{
+    qHexEdit_p->findAll(pattern);
+}
+
+void QHexEdit::cancelFindAll()
+{
+    qHexEdit_p->cancelFindAll();
+}
+
+void QHexEdit::clearSearchHits()
+{
+    qHexEdit_p->clearSearchHits();
+}
+
+QList<int> QHexEdit::searchHits()
+{
+    return qHexEdit_p->searchHits();
+}
+
+void QHexEdit::setDiffRanges(const QVector<DiffRange> & ranges)
+{
+    qHexEdit_p->setDiffRanges(ranges);
+}
+
+void QHexEdit::setStructTemplate(const StructTemplate & structTemplate)
+{
+    qHexEdit_p->setStructTemplate(structTemplate);
+}
+
+const StructTemplate & QHexEdit::structTemplate() const
+{
+    return qHexEdit_p->structTemplate();
+}
+
 void QHexEdit::remove(int pos, int len)
 {
     qHexEdit_p->remove(pos, len);
@@ -61,6 +111,16 @@ void QHexEdit::setAddressArea(bool addressArea)
     qHexEdit_p->setAddressArea(addressArea);
 }
 
+bool QHexEdit::nextChange()
+{
+    return qHexEdit_p->nextChange();
+}
+
+bool QHexEdit::previousChange()
+{
+    return qHexEdit_p->previousChange();
+}
+
 void QHexEdit::redo()
 {
     qHexEdit_p->redo();
@@ -71,9 +131,9 @@ void QHexEdit::undo()
     qHexEdit_p->undo();
 }
 
-QUndoStack* QHexEdit::undoStack() const
+UndoEngine* QHexEdit::undoEngine() const
 {
-    return qHexEdit_p->undoStack();
+    return qHexEdit_p->undoEngine();
 }
 
 void QHexEdit::setAddressWidth(int addressWidth)
@@ -154,6 +214,26 @@ QColor QHexEdit::selectionColor()
     return qHexEdit_p->selectionColor();
 }
 
+void QHexEdit::setSearchHitColor(const QColor &color)
+{
+    qHexEdit_p->setSearchHitColor(color);
+}
+
+QColor QHexEdit::searchHitColor()
+{
+    return qHexEdit_p->searchHitColor();
+}
+
+void QHexEdit::setDiffColor(const QColor &color)
+{
+    qHexEdit_p->setDiffColor(color);
+}
+
+QColor QHexEdit::diffColor()
+{
+    return qHexEdit_p->diffColor();
+}
+
 void QHexEdit::setOverwriteMode(bool overwriteMode)
 {
     qHexEdit_p->setOverwriteMode(overwriteMode);
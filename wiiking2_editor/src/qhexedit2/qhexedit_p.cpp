@@ -1,19 +1,29 @@
 #include <QtGui>
-#include <QUndoStack>
 #include <QScrollArea>
 #include <QApplication>
+#include <QMenu>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <algorithm>
+#include <climits>
 
 #include "qhexedit2/qhexedit_p.h"
-#include "qhexedit2/commands.h"
+#include "qhexedit2/undoengine.h"
+#include "tracer.h"
 
 const int HEXCHARS_IN_LINE = 47;
 const int GAP_ADR_HEX = 10;
 const int GAP_HEX_ASCII = 16;
 const int BYTES_PER_LINE = 16;
 
+static bool diffRangeEndsBefore(const DiffRange & range, int pos)
+{
+    return range.end() <= pos;
+}
+
 QHexEditPrivate::QHexEditPrivate(QScrollArea *parent) : QWidget(parent)
 {
-    _undoStack = new QUndoStack(this);
+    _undoEngine = new UndoEngine(&_xData, this);
 
     _scrollArea = parent;
     setAddressWidth(4);
@@ -27,9 +37,13 @@ QHexEditPrivate::QHexEditPrivate(QScrollArea *parent) : QWidget(parent)
     setAddressAreaColor(QColor(0xd4, 0xd4, 0xd4, 0xff));
     setHighlightingColor(QColor(0xff, 0xff, 0x99, 0xff));
     setSelectionColor(QColor(0x6d, 0x9e, 0xff, 0xff));
+    setSearchHitColor(QColor(0xff, 0xb8, 0x6c, 0xff));
+    setDiffColor(QColor(0xff, 0x8a, 0x8a, 0xff));
     setFont(QFont("Courier New", 10));
 
     _size = 0;
+    _searchThread = NULL;
+    _searchHitLength = 0;
     resetSelection(0);
 
     setFocusPolicy(Qt::StrongFocus);
@@ -39,6 +53,11 @@ QHexEditPrivate::QHexEditPrivate(QScrollArea *parent) : QWidget(parent)
     _cursorTimer.start();
 }
 
+QHexEditPrivate::~QHexEditPrivate()
+{
+    cancelFindAll();
+}
+
 void QHexEditPrivate::setAddressOffset(int offset)
 {
     _xData.setAddressOffset(offset);
@@ -52,8 +71,10 @@ int QHexEditPrivate::addressOffset()
 
 void QHexEditPrivate::setData(const QByteArray &data)
 {
+    // hits of a previous search point into the old bytes
+    clearSearchHits();
     _xData.setData(data);
-    //_undoStack->clear();
+    //_undoEngine->clear();
     adjust();
     //setCursorPos(0);
 }
@@ -96,6 +117,45 @@ QColor QHexEditPrivate::selectionColor()
     return _selectionColor;
 }
 
+void QHexEditPrivate::setDiffColor(const QColor &color)
+{
+    _diffColor = color;
+    update();
+}
+
+QColor QHexEditPrivate::diffColor()
+{
+    return _diffColor;
+}
+
+void QHexEditPrivate::setDiffRanges(const QVector<DiffRange> &ranges)
+{
+    _diffRanges = ranges;
+    update();
+}
+
+void QHexEditPrivate::setStructTemplate(const StructTemplate &structTemplate)
+{
+    _structTemplate = structTemplate;
+    update();
+}
+
+const StructTemplate & QHexEditPrivate::structTemplate() const
+{
+    return _structTemplate;
+}
+
+void QHexEditPrivate::setSearchHitColor(const QColor &color)
+{
+    _searchHitColor = color;
+    update();
+}
+
+QColor QHexEditPrivate::searchHitColor()
+{
+    return _searchHitColor;
+}
+
 void QHexEditPrivate::setReadOnly(bool readOnly)
 {
     _readOnly = readOnly;
@@ -122,18 +182,18 @@ XByteArray & QHexEditPrivate::xData()
 }
 
 int QHexEditPrivate::indexOf(const QByteArray & ba, int from)
+{
+    return indexOf(SearchPattern::fromBytes(ba), from);
+}
+
+int QHexEditPrivate::indexOf(const SearchPattern & pattern, int from)
 {
     if (from > (_xData.data().length() - 1))
         from = _xData.data().length() - 1;
-    int idx = _xData.data().indexOf(ba, from);
+    SearchEngine engine(pattern);
+    int idx = engine.indexIn(_xData.data().constData(), _xData.size(), from);
     if (idx > -1)
-    {
-        int curPos = idx*2;
-        setCursorPos(curPos + ba.length()*2);
-        resetSelection(curPos);
-        setSelection(curPos + ba.length()*2);
-        ensureVisible();
-    }
+        select(idx, pattern.length(), true);
     return idx;
 }
 
@@ -146,15 +206,13 @@ void QHexEditPrivate::insert(int index, const QByteArray & ba)
     {
         if (_overwriteMode)
         {
-            QUndoCommand *arrayCommand= new ArrayCommand(&_xData, ArrayCommand::replace, index, ba, ba.length());
-            _undoStack->push(arrayCommand);
-            emit dataChanged();
+            _undoEngine->push(UndoEngine::replace, index, ba, ba.length());
+            emitDataChanged();
         }
         else
         {
-            QUndoCommand *arrayCommand= new ArrayCommand(&_xData, ArrayCommand::insert, index, ba, ba.length());
-            _undoStack->push(arrayCommand);
-            emit dataChanged();
+            _undoEngine->push(UndoEngine::insert, index, ba, ba.length());
+            emitDataChanged();
         }
     }
 }
@@ -164,25 +222,24 @@ void QHexEditPrivate::insert(int index, char ch)
     if (!_insertAllowed)
         return;
 
-    QUndoCommand *charCommand = new CharCommand(&_xData, CharCommand::insert, index, ch);
-    _undoStack->push(charCommand);
-    emit dataChanged();
+    _undoEngine->push(UndoEngine::insert, index, QByteArray(1, ch), 1, true);
+    emitDataChanged();
 }
 
 int QHexEditPrivate::lastIndexOf(const QByteArray & ba, int from)
 {
-    from -= ba.length();
+    return lastIndexOf(SearchPattern::fromBytes(ba), from);
+}
+
+int QHexEditPrivate::lastIndexOf(const SearchPattern & pattern, int from)
+{
+    from -= pattern.length();
     if (from < 0)
         from = 0;
-    int idx = _xData.data().lastIndexOf(ba, from);
+    SearchEngine engine(pattern);
+    int idx = engine.lastIndexIn(_xData.data().constData(), _xData.size(), from);
     if (idx > -1)
-    {
-        int curPos = idx*2;
-        setCursorPos(curPos);
-        resetSelection(curPos);
-        setSelection(curPos + ba.length()*2);
-        ensureVisible();
-    }
+        select(idx, pattern.length(), false);
     return idx;
 }
 
@@ -194,15 +251,13 @@ void QHexEditPrivate::remove(int index, int len)
         {
             if (_overwriteMode)
             {
-                QUndoCommand *charCommand = new CharCommand(&_xData, CharCommand::replace, index, char(0));
-                _undoStack->push(charCommand);
-                emit dataChanged();
+                _undoEngine->push(UndoEngine::replace, index, QByteArray(1, char(0)), 1, true);
+                emitDataChanged();
             }
             else
             {
-                QUndoCommand *charCommand = new CharCommand(&_xData, CharCommand::remove, index, char(0));
-                _undoStack->push(charCommand);
-                emit dataChanged();
+                _undoEngine->push(UndoEngine::remove, index, QByteArray(), 1, true);
+                emitDataChanged();
             }
         }
         else
@@ -210,15 +265,13 @@ void QHexEditPrivate::remove(int index, int len)
             QByteArray ba = QByteArray(len, char(0));
             if (_overwriteMode)
             {
-                QUndoCommand *arrayCommand = new ArrayCommand(&_xData, ArrayCommand::replace, index, ba, ba.length());
-                _undoStack->push(arrayCommand);
-                emit dataChanged();
+                _undoEngine->push(UndoEngine::replace, index, ba, ba.length());
+                emitDataChanged();
             }
             else
             {
-                QUndoCommand *arrayCommand= new ArrayCommand(&_xData, ArrayCommand::remove, index, ba, len);
-                _undoStack->push(arrayCommand);
-                emit dataChanged();
+                _undoEngine->push(UndoEngine::remove, index, QByteArray(), len);
+                emitDataChanged();
             }
         }
     }
@@ -226,26 +279,23 @@ void QHexEditPrivate::remove(int index, int len)
 
 void QHexEditPrivate::replace(int index, char ch)
 {
-    QUndoCommand *charCommand = new CharCommand(&_xData, CharCommand::replace, index, ch);
-    _undoStack->push(charCommand);
+    _undoEngine->push(UndoEngine::replace, index, QByteArray(1, ch), 1, true);
     resetSelection();
-    emit dataChanged();
+    emitDataChanged();
 }
 
 void QHexEditPrivate::replace(int index, const QByteArray & ba)
 {
-    QUndoCommand *arrayCommand= new ArrayCommand(&_xData, ArrayCommand::replace, index, ba, ba.length());
-    _undoStack->push(arrayCommand);
+    _undoEngine->push(UndoEngine::replace, index, ba, ba.length());
     resetSelection();
-    emit dataChanged();
+    emitDataChanged();
 }
 
 void QHexEditPrivate::replace(int pos, int len, const QByteArray &after)
 {
-    QUndoCommand *arrayCommand= new ArrayCommand(&_xData, ArrayCommand::replace, pos, after, len);
-    _undoStack->push(arrayCommand);
+    _undoEngine->push(UndoEngine::replace, pos, after.left(len), len);
     resetSelection();
-    emit dataChanged();
+    emitDataChanged();
 }
 
 void QHexEditPrivate::setAddressArea(bool addressArea)
@@ -293,23 +343,115 @@ bool QHexEditPrivate::overwriteMode()
 
 void QHexEditPrivate::redo()
 {
-    _undoStack->redo();
-    emit dataChanged();
+    _undoEngine->redo();
+    emitDataChanged();
     setCursorPos(_cursorPosition);
     update();
 }
 
 void QHexEditPrivate::undo()
 {
-    _undoStack->undo();
-    emit dataChanged();
+    _undoEngine->undo();
+    emitDataChanged();
     setCursorPos(_cursorPosition);
     update();
 }
 
-QUndoStack* QHexEditPrivate::undoStack() const
+UndoEngine* QHexEditPrivate::undoEngine() const
 {
-    return _undoStack;
+    return _undoEngine;
+}
+
+void QHexEditPrivate::findAll(const SearchPattern & pattern)
+{
+    cancelFindAll();
+    _searchHits.clear();
+    _searchHitLength = pattern.length();
+    update();
+
+    if (!pattern.isValid())
+    {
+        emit searchFinished(0);
+        return;
+    }
+
+    _searchThread = new SearchThread(_xData.data(), pattern, this);
+    connect(_searchThread, SIGNAL(hitsFound(QList<int>)), this, SLOT(onSearchHitsFound(QList<int>)));
+    connect(_searchThread, SIGNAL(finished()), this, SLOT(onSearchThreadFinished()));
+    _searchThread->start(QThread::LowPriority);
+}
+
+void QHexEditPrivate::cancelFindAll()
+{
+    if (!_searchThread)
+        return;
+
+    disconnect(_searchThread, 0, this, 0);
+    _searchThread->cancel();
+    _searchThread->wait();
+    delete _searchThread;
+    _searchThread = NULL;
+}
+
+void QHexEditPrivate::clearSearchHits()
+{
+    cancelFindAll();
+    _searchHits.clear();
+    _searchHitLength = 0;
+    update();
+    emit searchCleared();
+}
+
+QList<int> QHexEditPrivate::searchHits()
+{
+    return _searchHits.toList();
+}
+
+void QHexEditPrivate::onSearchHitsFound(const QList<int> &hits)
+{
+    // Batches queued by a cancelled search may still arrive
+    if (sender() != _searchThread)
+        return;
+
+    foreach (int hit, hits)
+        _searchHits.append(hit);
+    update();
+    emit searchHitsFound(hits);
+}
+
+void QHexEditPrivate::onSearchThreadFinished()
+{
+    if (sender() != _searchThread)
+        return;
+
+    int count = _searchThread->hitCount();
+    _searchThread->deleteLater();
+    _searchThread = NULL;
+    emit searchFinished(count);
+}
+
+bool QHexEditPrivate::nextChange()
+{
+    int pos = _cursorPosition / 2;
+    // skip the run the cursor is in
+    int from = ((pos < _xData.size()) && _xData.dataChanged(pos)) ? _xData.changedRunEnd(pos) : pos + 1;
+    int start = _xData.nextChanged(from);
+    if (start < 0)
+        return false;
+    select(start, _xData.changedRunEnd(start) - start, false);
+    return true;
+}
+
+bool QHexEditPrivate::previousChange()
+{
+    int pos = _cursorPosition / 2;
+    int from = ((pos < _xData.size()) && _xData.dataChanged(pos)) ? _xData.changedRunStart(pos) - 1 : pos - 1;
+    int last = _xData.previousChanged(from);
+    if (last < 0)
+        return false;
+    int start = _xData.changedRunStart(last);
+    select(start, last + 1 - start, false);
+    return true;
 }
 
 QString QHexEditPrivate::toRedableString()
@@ -323,6 +465,95 @@ QString QHexEditPrivate::selectionToReadableString()
     return _xData.toRedableString(getSelectionBegin(), getSelectionEnd());
 }
 
+QString QHexEditPrivate::selectionToText(HexDumpFormatter::Style style)
+{
+    return QString::fromLatin1(_xData.toText(style, getSelectionBegin(), getSelectionEnd()));
+}
+
+bool QHexEditPrivate::exportSelection(const QString &fileName, HexDumpFormatter::Style style)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    // large selections are streamed in chunks, the text is never built as a whole
+    bool ok = _xData.writeText(&file, style, getSelectionBegin(), getSelectionEnd());
+    file.close();
+    return ok && (file.error() == QFile::NoError);
+}
+
+void QHexEditPrivate::contextMenuEvent(QContextMenuEvent *event)
+{
+    bool hasSelection = getSelectionEnd() > getSelectionBegin();
+
+    QMenu menu(this);
+    QMenu *copyMenu = menu.addMenu(tr("Copy As"));
+    copyMenu->setEnabled(hasSelection);
+    copyMenu->addAction(tr("Hex Dump"))->setData(HexDumpFormatter::HexDump);
+    copyMenu->addAction(tr("Hex Bytes"))->setData(HexDumpFormatter::HexBytes);
+    copyMenu->addAction(tr("C Array"))->setData(HexDumpFormatter::CArray);
+    copyMenu->addAction(tr("Python Bytes"))->setData(HexDumpFormatter::PythonBytes);
+    copyMenu->addAction(tr("Base64"))->setData(HexDumpFormatter::Base64);
+    QAction *exportAction = menu.addAction(tr("Export Selection..."));
+    exportAction->setEnabled(hasSelection);
+
+    QAction *action = menu.exec(event->globalPos());
+    if (action == NULL)
+        return;
+
+    if (action == exportAction)
+    {
+        QString selectedFilter;
+        QString fileName = QFileDialog::getSaveFileName(this, tr("Export Selection"), QString(),
+                                                        tr("Hex Dump (*.txt);;C Array (*.h *.c);;Python Bytes (*.py);;Base64 (*.b64)"),
+                                                        &selectedFilter);
+        if (fileName.isEmpty())
+            return;
+
+        HexDumpFormatter::Style style = HexDumpFormatter::HexDump;
+        if (selectedFilter.startsWith("C Array"))
+            style = HexDumpFormatter::CArray;
+        else if (selectedFilter.startsWith("Python"))
+            style = HexDumpFormatter::PythonBytes;
+        else if (selectedFilter.startsWith("Base64"))
+            style = HexDumpFormatter::Base64;
+
+        if (!exportSelection(fileName, style))
+            QMessageBox::warning(this, tr("Export Selection"), tr("Could not write %1").arg(fileName));
+        return;
+    }
+
+    QClipboard *clipboard = QApplication::clipboard();
+    clipboard->setText(selectionToText(HexDumpFormatter::Style(action->data().toInt())));
+}
+
+bool QHexEditPrivate::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip)
+    {
+        // name the template field under the mouse
+        QHelpEvent *helpEvent = static_cast<QHelpEvent *>(event);
+        int pos = cursorPos(helpEvent->pos());
+        int fieldIdx = ((pos < 0) || (pos / 2 >= _xData.size())) ? -1 : _structTemplate.fieldAt(pos / 2);
+        if (fieldIdx >= 0)
+        {
+            const StructField & field = _structTemplate.fields()[fieldIdx];
+            QToolTip::showText(helpEvent->globalPos(),
+                               QString("%1\n0x%2 - 0x%3 (%4 bytes)")
+                               .arg(field.name)
+                               .arg(field.offset + _xData.addressOffset(), 4, 16, QChar('0'))
+                               .arg(field.offset + field.length - 1 + _xData.addressOffset(), 4, 16, QChar('0'))
+                               .arg(field.length));
+        }
+        else
+        {
+            QToolTip::hideText();
+            event->ignore();
+        }
+        return true;
+    }
+    return QWidget::event(event);
+}
+
 void QHexEditPrivate::keyPressEvent(QKeyEvent *event)
 {
     int charX = (_cursorX - _xPosHex) / _charWidth;
@@ -499,13 +730,7 @@ if (!_readOnly)
         /* Cut & Paste */
         if (event->matches(QKeySequence::Cut))
         {
-            QString result = QString();
-            for (int idx = getSelectionBegin(); idx < getSelectionEnd(); idx++)
-            {
-                result += _xData.data().mid(idx, 1).toHex() + " ";
-                if ((idx % 16) == 15)
-                    result.append("\n");
-            }
+            QString result = selectionToText(HexDumpFormatter::HexBytes);
             remove(getSelectionBegin(), getSelectionEnd() - getSelectionBegin());
             QClipboard *clipboard = QApplication::clipboard();
             clipboard->setText(result);
@@ -581,15 +806,8 @@ if (!_readOnly)
 
     if (event->matches(QKeySequence::Copy))
     {
-        QString result = QString();
-        for (int idx = getSelectionBegin(); idx < getSelectionEnd(); idx++)
-        {
-            result += _xData.data().mid(idx, 1).toHex() + " ";
-            if ((idx % 16) == 15)
-                result.append('\n');
-        }
         QClipboard *clipboard = QApplication::clipboard();
-        clipboard->setText(result);
+        clipboard->setText(selectionToText(HexDumpFormatter::HexBytes));
     }
 
     // Switch between insert/overwrite mode
@@ -618,12 +836,16 @@ void QHexEditPrivate::mousePressEvent(QMouseEvent * event)
     _blink = false;
     update();
     int cPos = cursorPos(event->pos());
+    // a right click into the selection keeps it for the context menu
+    if ((event->button() == Qt::RightButton) && (cPos / 2 >= getSelectionBegin()) && (cPos / 2 < getSelectionEnd()))
+        return;
     resetSelection(cPos);
     setCursorPos(cPos);
 }
 
 void QHexEditPrivate::paintEvent(QPaintEvent *event)
 {
+    TRACE_PHASE_SCOPE("QHexEditPrivate::paintEvent", HexPaintPhase);
     QPainter painter(this);
 
     // draw some patterns if needed
@@ -667,8 +889,36 @@ void QHexEditPrivate::paintEvent(QPaintEvent *event)
     QPen colSelected = QPen(Qt::white);
     QPen colStandard = QPen(this->palette().color(QPalette::WindowText));
 
+    QBrush searchHit = QBrush(_searchHitColor);
+    QBrush diff = QBrush(_diffColor);
+
     painter.setBackgroundMode(Qt::TransparentMode);
 
+    // first search hit and diff range which can still reach into the visible area
+    int hitIdx = std::lower_bound(_searchHits.constBegin(), _searchHits.constEnd(),
+                                  firstLineIdx - _searchHitLength + 1) - _searchHits.constBegin();
+    int diffIdx = std::lower_bound(_diffRanges.constBegin(), _diffRanges.constEnd(),
+                                   firstLineIdx, diffRangeEndsBefore) - _diffRanges.constBegin();
+
+    // template field of every visible byte, the shortest field wins
+    const QVector<StructField> & fields = _structTemplate.fields();
+    QVector<int> fieldIds;
+    QVector<int> overlay(qMax(0, lastLineIdx - firstLineIdx), -1);
+    _structTemplate.fieldsIn(firstLineIdx, lastLineIdx, fieldIds);
+    for (int i = 0; i < fieldIds.size(); i++)
+    {
+        const StructField & field = fields[fieldIds[i]];
+        int from = qMax(field.offset, firstLineIdx) - firstLineIdx;
+        int to = qMin(field.offset + field.length, lastLineIdx) - firstLineIdx;
+        for (int j = from; j < to; j++)
+            if ((overlay[j] < 0) || (field.length < fields[overlay[j]].length))
+                overlay[j] = fieldIds[i];
+    }
+
+    // current run of changed bytes, looked up a bitmap word at a time
+    int changedFrom = -1;
+    int changedTo = _highlighting ? -1 : INT_MAX;
+
     for (int lineIdx = firstLineIdx, yPos = yPosStart; lineIdx < lastLineIdx; lineIdx += BYTES_PER_LINE, yPos +=_charHeight)
     {
         QString hex;
@@ -676,29 +926,54 @@ void QHexEditPrivate::paintEvent(QPaintEvent *event)
         for (int colIdx = 0; ((lineIdx + colIdx) < _xData.size() && (colIdx < BYTES_PER_LINE)); colIdx++)
         {
             int posBa = lineIdx + colIdx;
+            while ((hitIdx < _searchHits.size()) && (_searchHits[hitIdx] + _searchHitLength <= posBa))
+                hitIdx++;
+            bool isHit = (hitIdx < _searchHits.size()) && (_searchHits[hitIdx] <= posBa);
+            while ((diffIdx < _diffRanges.size()) && (_diffRanges[diffIdx].end() <= posBa))
+                diffIdx++;
+            bool isDiff = (diffIdx < _diffRanges.size()) && (_diffRanges[diffIdx].start <= posBa);
+            if (posBa >= changedTo)
+            {
+                changedFrom = _xData.nextChanged(posBa);
+                changedTo = (changedFrom < 0) ? INT_MAX : _xData.changedRunEnd(changedFrom);
+            }
+            bool isChanged = (changedFrom >= 0) && (changedFrom <= posBa);
+
             if ((getSelectionBegin() <= posBa) && (getSelectionEnd() > posBa))
             {
                 painter.setBackground(selected);
                 painter.setBackgroundMode(Qt::OpaqueMode);
                 painter.setPen(colSelected);
             }
+            else if (isHit)
+            {
+                painter.setBackground(searchHit);
+                painter.setBackgroundMode(Qt::OpaqueMode);
+                painter.setPen(colStandard);
+            }
+            else if (isDiff)
+            {
+                painter.setBackground(diff);
+                painter.setBackgroundMode(Qt::OpaqueMode);
+                painter.setPen(colStandard);
+            }
+            else if (isChanged)
+            {
+                // hilight diff bytes
+                painter.setBackground(highLighted);
+                painter.setBackgroundMode(Qt::OpaqueMode);
+                painter.setPen(colHighlighted);
+            }
+            else if (overlay[posBa - firstLineIdx] >= 0)
+            {
+                painter.setBackground(QBrush(fields[overlay[posBa - firstLineIdx]].color));
+                painter.setBackgroundMode(Qt::OpaqueMode);
+                painter.setPen(colStandard);
+            }
             else
             {
-                if (_highlighting)
-                {
-                    // hilight diff bytes
-                    painter.setBackground(highLighted);
-                    if (_xData.dataChanged(posBa))
-                    {
-                        painter.setPen(colHighlighted);
-                        painter.setBackgroundMode(Qt::OpaqueMode);
-                    }
-                    else
-                    {
-                        painter.setPen(colStandard);
-                        painter.setBackgroundMode(Qt::TransparentMode);
-                    }
-                }
+                painter.setPen(colStandard);
+                painter.setBackgroundMode(Qt::TransparentMode);
             }
 
             // render hex value
@@ -877,6 +1152,23 @@ void QHexEditPrivate::adjust()
     update();
 }
 
+void QHexEditPrivate::emitDataChanged()
+{
+    int index, length;
+    if (_xData.takeDirtyRange(index, length))
+        emit bytesChanged(index, length);
+    emit dataChanged();
+}
+
+void QHexEditPrivate::select(int index, int length, bool cursorAtEnd)
+{
+    int curPos = index*2;
+    setCursorPos(cursorAtEnd ? curPos + length*2 : curPos);
+    resetSelection(curPos);
+    setSelection(curPos + length*2);
+    ensureVisible();
+}
+
 void QHexEditPrivate::ensureVisible()
 {
     // scrolls to cursorx, cusory (which are set by setCursorPos)
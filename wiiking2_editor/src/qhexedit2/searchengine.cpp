@@ -0,0 +1,415 @@
+#include <QtEndian>
+#include <string.h>
+
+#include "qhexedit2/searchengine.h"
+#include "bitops.h"
+
+const int SEARCH_CHUNK_SIZE = 1 << 20;      // bytes searched between progress/cancel checks
+const int SEARCH_BATCH_SIZE = 256;          // hits collected before they are emitted
+
+static int hexNibble(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+/*****************************************************************************/
+/* SearchPattern */
+/*****************************************************************************/
+
+SearchPattern::SearchPattern()
+{
+    _masked = false;
+}
+
+SearchPattern SearchPattern::fromBytes(const QByteArray &ba)
+{
+    SearchPattern pattern;
+    pattern._bytes = ba;
+    pattern._mask = QByteArray(ba.length(), char(0xFF));
+    return pattern;
+}
+
+SearchPattern SearchPattern::fromHexString(const QString &text, bool *ok)
+{
+    QByteArray digits;
+    QByteArray latin = text.toLatin1();
+    for (int i = 0; i < latin.length(); i++)
+    {
+        char c = latin[i];
+        if (c == ' ' || c == '\t' || c == ',')
+            continue;
+        if (c != '?' && hexNibble(c) < 0)
+        {
+            if (ok)
+                *ok = false;
+            return SearchPattern();
+        }
+        digits.append(c);
+    }
+
+    if (digits.isEmpty() || (digits.length() % 2) != 0)
+    {
+        if (ok)
+            *ok = false;
+        return SearchPattern();
+    }
+
+    SearchPattern pattern;
+    pattern._bytes.resize(digits.length() / 2);
+    pattern._mask.resize(digits.length() / 2);
+    for (int i = 0; i < pattern._bytes.length(); i++)
+    {
+        char hi = digits[2 * i];
+        char lo = digits[2 * i + 1];
+        int value = 0;
+        int mask = 0;
+        if (hi != '?')
+        {
+            value |= hexNibble(hi) << 4;
+            mask |= 0xF0;
+        }
+        if (lo != '?')
+        {
+            value |= hexNibble(lo);
+            mask |= 0x0F;
+        }
+        pattern._bytes[i] = char(value);
+        pattern._mask[i] = char(mask);
+        if (mask != 0xFF)
+            pattern._masked = true;
+    }
+
+    if (ok)
+        *ok = true;
+    return pattern;
+}
+
+SearchPattern SearchPattern::fromValue(ValueType type, const QString &text, bool *ok)
+{
+    bool valid = false;
+    QByteArray ba;
+    QString value = text.trimmed();
+
+    switch (type)
+    {
+        case HexBytes:
+            return fromHexString(text, ok);
+        case Int16Value:
+        case Int32Value:
+        case Int64Value:
+        {
+            int size = (type == Int16Value ? 2 : (type == Int32Value ? 4 : 8));
+            qint64 number = value.toLongLong(&valid, 0);
+            quint64 raw = quint64(number);
+            if (valid && size < 8)
+            {
+                // signed or unsigned, either way it has to fit the width
+                qint64 limit = Q_INT64_C(1) << (8 * size);
+                valid = (number >= -limit / 2) && (number < limit);
+            }
+            else if (!valid)
+            {
+                raw = value.toULongLong(&valid, 0);
+                valid = valid && (size == 8);
+            }
+            if (!valid)
+                break;
+            ba.resize(size);
+            for (int i = 0; i < size; i++)
+                ba[i] = char(raw >> (8 * (size - 1 - i)));
+            break;
+        }
+        case FloatValue:
+        {
+            float f = value.toFloat(&valid);
+            if (!valid)
+                break;
+            quint32 raw;
+            memcpy(&raw, &f, sizeof(raw));
+            ba.resize(4);
+            qToBigEndian<quint32>(raw, (uchar*)ba.data());
+            break;
+        }
+        case Utf16String:
+        {
+            valid = !text.isEmpty();
+            ba.resize(text.length() * 2);
+            for (int i = 0; i < text.length(); i++)
+                qToBigEndian<quint16>(text.at(i).unicode(), (uchar*)ba.data() + i * 2);
+            break;
+        }
+    }
+
+    if (ok)
+        *ok = valid;
+    if (!valid)
+        return SearchPattern();
+    return fromBytes(ba);
+}
+
+bool SearchPattern::isValid() const
+{
+    return !_bytes.isEmpty();
+}
+
+bool SearchPattern::isMasked() const
+{
+    return _masked;
+}
+
+int SearchPattern::length() const
+{
+    return _bytes.length();
+}
+
+const QByteArray & SearchPattern::bytes() const
+{
+    return _bytes;
+}
+
+const QByteArray & SearchPattern::mask() const
+{
+    return _mask;
+}
+
+/*****************************************************************************/
+/* SearchEngine */
+/*****************************************************************************/
+
+SearchEngine::SearchEngine(const SearchPattern &pattern)
+    : _pattern(pattern)
+{
+    const int len = _pattern.length();
+    const uchar *bytes = (const uchar*)_pattern.bytes().constData();
+    const uchar *mask = (const uchar*)_pattern.mask().constData();
+
+    _anchor = -1;
+    for (int i = 0; i < len; i++)
+    {
+        if (mask[i] == 0xFF)
+        {
+            _anchor = i;
+            break;
+        }
+    }
+
+    for (int i = 0; i < 256; i++)
+        _skip[i] = len;
+    for (int i = 0; i < len - 1; i++)
+        _skip[bytes[i]] = len - 1 - i;
+}
+
+const SearchPattern & SearchEngine::pattern() const
+{
+    return _pattern;
+}
+
+int SearchEngine::indexIn(const char *data, int size, int from) const
+{
+    const int len = _pattern.length();
+    if (len == 0 || !data)
+        return -1;
+    if (from < 0)
+        from = 0;
+    if (size - from < len)
+        return -1;
+
+    if (_pattern.isMasked())
+        return maskedScan((const uchar*)data, size, from);
+    if (len >= HORSPOOL_MIN_LENGTH)
+        return horspoolScan((const uchar*)data, size, from);
+    return exactScan((const uchar*)data, size, from);
+}
+
+int SearchEngine::lastIndexIn(const char *data, int size, int from) const
+{
+    const int len = _pattern.length();
+    if (len == 0 || !data || size < len || from < 0)
+        return -1;
+    if (from > size - len)
+        from = size - len;
+
+    const uchar *p = (const uchar*)data;
+    for (int i = from; i >= 0; i--)
+        if (matchesAt(p + i))
+            return i;
+    return -1;
+}
+
+// Compares the first and the last byte of the pattern against 16 positions at
+// once and only verifies the middle part for positions passing both.
+int SearchEngine::exactScan(const uchar *data, int size, int from) const
+{
+    const int len = _pattern.length();
+    const uchar *pat = (const uchar*)_pattern.bytes().constData();
+    const int end = size - len;             // last valid start position
+    int i = from;
+
+#ifdef BITOPS_SSE2
+    const __m128i first = _mm_set1_epi8(char(pat[0]));
+    const __m128i last = _mm_set1_epi8(char(pat[len - 1]));
+    for (; i + 15 <= end; i += 16)
+    {
+        __m128i blockFirst = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i blockLast = _mm_loadu_si128((const __m128i*)(data + i + len - 1));
+        quint32 hits = quint32(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+                                                               _mm_cmpeq_epi8(blockLast, last))));
+        while (hits)
+        {
+            int pos = i + countTrailingZeros64(hits);
+            if (len <= 2 || memcmp(data + pos + 1, pat + 1, len - 2) == 0)
+                return pos;
+            hits &= hits - 1;
+        }
+    }
+#endif
+
+    for (; i <= end; i++)
+        if (data[i] == pat[0] && memcmp(data + i, pat, len) == 0)
+            return i;
+    return -1;
+}
+
+int SearchEngine::horspoolScan(const uchar *data, int size, int from) const
+{
+    const int len = _pattern.length();
+    const uchar *pat = (const uchar*)_pattern.bytes().constData();
+    const uchar lastByte = pat[len - 1];
+    const int end = size - len;
+
+    int i = from;
+    while (i <= end)
+    {
+        uchar c = data[i + len - 1];
+        if (c == lastByte && memcmp(data + i, pat, len - 1) == 0)
+            return i;
+        i += _skip[c];
+    }
+    return -1;
+}
+
+int SearchEngine::maskedScan(const uchar *data, int size, int from) const
+{
+    const int len = _pattern.length();
+    const int end = size - len;
+    int i = from;
+
+    if (_anchor < 0)
+    {
+        // Nothing fully specified to filter on, e.g. "1? ?3"
+        for (; i <= end; i++)
+            if (matchesAt(data + i))
+                return i;
+        return -1;
+    }
+
+    const uchar anchorByte = (uchar)_pattern.bytes()[_anchor];
+
+#ifdef BITOPS_SSE2
+    const __m128i anchor = _mm_set1_epi8(char(anchorByte));
+    for (; i + 15 <= end; i += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + i + _anchor));
+        quint32 hits = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(block, anchor)));
+        while (hits)
+        {
+            int pos = i + countTrailingZeros64(hits);
+            if (matchesAt(data + pos))
+                return pos;
+            hits &= hits - 1;
+        }
+    }
+#endif
+
+    for (; i <= end; i++)
+        if (data[i + _anchor] == anchorByte && matchesAt(data + i))
+            return i;
+    return -1;
+}
+
+bool SearchEngine::matchesAt(const uchar *data) const
+{
+    const int len = _pattern.length();
+    const uchar *bytes = (const uchar*)_pattern.bytes().constData();
+    const uchar *mask = (const uchar*)_pattern.mask().constData();
+    for (int k = 0; k < len; k++)
+        if ((data[k] & mask[k]) != bytes[k])
+            return false;
+    return true;
+}
+
+/*****************************************************************************/
+/* SearchThread */
+/*****************************************************************************/
+
+SearchThread::SearchThread(const QByteArray &data, const SearchPattern &pattern, QObject *parent)
+    : QThread(parent),
+      _data(data),
+      _engine(pattern),
+      _cancelled(0),
+      _hitCount(0)
+{
+    qRegisterMetaType<QList<int> >("QList<int>");
+}
+
+void SearchThread::cancel()
+{
+    _cancelled.fetchAndStoreOrdered(1);
+}
+
+bool SearchThread::isCancelled() const
+{
+    return _cancelled.fetchAndAddOrdered(0) != 0;
+}
+
+int SearchThread::hitCount() const
+{
+    return _hitCount.fetchAndAddOrdered(0);
+}
+
+void SearchThread::run()
+{
+    const char *data = _data.constData();
+    const int size = _data.size();
+    const int len = _engine.pattern().length();
+    QList<int> batch;
+
+    _hitCount.fetchAndStoreOrdered(0);
+    int pos = 0;
+    while (pos <= size - len && !isCancelled())
+    {
+        // Limit each step to one chunk so cancel() and progress stay responsive
+        int chunkEnd = qMin(size, pos + SEARCH_CHUNK_SIZE + len - 1);
+        int idx = _engine.indexIn(data, chunkEnd, pos);
+        if (idx < 0)
+        {
+            pos = chunkEnd - len + 1;
+            if (!batch.isEmpty())
+            {
+                emit hitsFound(batch);
+                batch.clear();
+            }
+            emit progress(int((qint64(pos) * 100) / qMax(1, size)));
+            continue;
+        }
+
+        batch.append(idx);
+        _hitCount.fetchAndAddRelaxed(1);
+        if (batch.size() >= SEARCH_BATCH_SIZE)
+        {
+            emit hitsFound(batch);
+            batch.clear();
+        }
+        pos = idx + 1;
+    }
+
+    if (!batch.isEmpty() && !isCancelled())
+        emit hitsFound(batch);
+    emit progress(100);
+}
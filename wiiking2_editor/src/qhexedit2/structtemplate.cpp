@@ -0,0 +1,72 @@
+#include "qhexedit2/structtemplate.h"
+
+StructTemplate::StructTemplate()
+{
+    _treeValid = true;
+}
+
+void StructTemplate::addField(int offset, int length, const QString & name, const QColor & color)
+{
+    if (length <= 0)
+        return;
+
+    StructField field;
+    field.offset = offset;
+    field.length = length;
+    field.name = name;
+    field.color = color;
+    _fields.append(field);
+    _treeValid = false;
+}
+
+void StructTemplate::clear()
+{
+    _fields.clear();
+    _tree.clear();
+    _treeValid = true;
+}
+
+bool StructTemplate::isEmpty() const
+{
+    return _fields.isEmpty();
+}
+
+const QVector<StructField> & StructTemplate::fields() const
+{
+    return _fields;
+}
+
+int StructTemplate::fieldAt(int pos) const
+{
+    QVector<int> ids;
+    ensureTree();
+    _tree.containing(pos, ids);
+
+    int result = -1;
+    for (int i = 0; i < ids.size(); i++)
+        if ((result < 0) || (_fields[ids[i]].length < _fields[result].length))
+            result = ids[i];
+    return result;
+}
+
+void StructTemplate::fieldsIn(int from, int to, QVector<int> & ids) const
+{
+    ensureTree();
+    _tree.overlapping(from, to, ids);
+}
+
+void StructTemplate::ensureTree() const
+{
+    if (_treeValid)
+        return;
+
+    QVector<int> starts(_fields.size());
+    QVector<int> ends(_fields.size());
+    for (int i = 0; i < _fields.size(); i++)
+    {
+        starts[i] = _fields[i].offset;
+        ends[i] = _fields[i].offset + _fields[i].length;
+    }
+    _tree.build(starts, ends);
+    _treeValid = true;
+}
@@ -0,0 +1,277 @@
+#include "qhexedit2/undoengine.h"
+
+UndoEngine::UndoEngine(XByteArray * xData, QObject *parent) : QObject(parent)
+{
+    _xData = xData;
+    _arenaHead = 0;
+    _index = 0;
+    _memoryLimit = DEFAULT_MEMORY_LIMIT;
+    _mergeBarrier = true;
+}
+
+void UndoEngine::push(Cmd cmd, int pos, const QByteArray & ba, int len, bool mergeable)
+{
+    int size = _xData->size();
+    if ((pos < 0) || (pos > size))
+        return;
+
+    Entry entry;
+    entry.pos = pos;
+    entry.mergeable = mergeable;
+    QByteArray newBa;
+    switch (cmd)
+    {
+        case insert:
+            entry.oldLength = 0;
+            newBa = ba;
+            break;
+        case remove:
+            entry.oldLength = qMin(len, size - pos);
+            break;
+        case replace:
+            entry.oldLength = qMin(ba.length(), size - pos);
+            newBa = ba.left(entry.oldLength);
+            break;
+    }
+    entry.newLength = newBa.length();
+    if ((entry.oldLength <= 0) && (entry.newLength == 0))
+        return;
+
+    QByteArray oldBa = _xData->data().mid(pos, entry.oldLength);
+    QByteArray oldChanged = _xData->dataChanged(pos, entry.oldLength);
+
+    // a new edit discards everything which could have been redone
+    truncate(_index);
+    apply(pos, entry.oldLength, newBa);
+
+    if (!mergeable || _mergeBarrier || !mergeWithTop(entry, oldBa, oldChanged))
+        append(entry, oldBa, oldChanged, newBa);
+    _mergeBarrier = false;
+    _index = _entries.size();
+    enforceLimit();
+
+    emit indexChanged(_index);
+    emit memoryUsageChanged(memoryUsage());
+}
+
+void UndoEngine::undo()
+{
+    if (!canUndo())
+        return;
+
+    const Entry & entry = _entries[--_index];
+    apply(entry.pos, entry.newLength, oldBytes(entry));
+    if (entry.oldLength > 0)
+        _xData->setDataChanged(entry.pos, oldFlags(entry));
+    _mergeBarrier = true;
+    emit indexChanged(_index);
+}
+
+void UndoEngine::redo()
+{
+    if (!canRedo())
+        return;
+
+    const Entry & entry = _entries[_index++];
+    apply(entry.pos, entry.oldLength, newBytes(entry));
+    _mergeBarrier = true;
+    emit indexChanged(_index);
+}
+
+void UndoEngine::clear()
+{
+    _entries.clear();
+    _arena.clear();
+    _arenaHead = 0;
+    _index = 0;
+    _mergeBarrier = true;
+    emit indexChanged(_index);
+    emit memoryUsageChanged(memoryUsage());
+}
+
+bool UndoEngine::canUndo() const
+{
+    return _index > 0;
+}
+
+bool UndoEngine::canRedo() const
+{
+    return _index < _entries.size();
+}
+
+int UndoEngine::count() const
+{
+    return _entries.size();
+}
+
+int UndoEngine::index() const
+{
+    return _index;
+}
+
+void UndoEngine::setMemoryLimit(int bytes)
+{
+    _memoryLimit = bytes;
+    enforceLimit();
+    emit memoryUsageChanged(memoryUsage());
+}
+
+int UndoEngine::memoryLimit() const
+{
+    return _memoryLimit;
+}
+
+int UndoEngine::memoryUsage() const
+{
+    return (_arena.size() - _arenaHead) + _entries.size() * int(sizeof(Entry));
+}
+
+int UndoEngine::flagBytes(int length)
+{
+    return (length + 7) / 8;
+}
+
+int UndoEngine::payloadSize(const Entry & entry) const
+{
+    return entry.oldLength + flagBytes(entry.oldLength) + entry.newLength;
+}
+
+QByteArray UndoEngine::oldBytes(const Entry & entry) const
+{
+    return _arena.mid(entry.offset, entry.oldLength);
+}
+
+QByteArray UndoEngine::oldFlags(const Entry & entry) const
+{
+    QByteArray flags(entry.oldLength, char(0));
+    const uchar *bits = (const uchar*)_arena.constData() + entry.offset + entry.oldLength;
+    for (int i = 0; i < entry.oldLength; i++)
+        if (bits[i >> 3] & (1 << (i & 7)))
+            flags[i] = char(1);
+    return flags;
+}
+
+QByteArray UndoEngine::newBytes(const Entry & entry) const
+{
+    return _arena.mid(entry.offset + entry.oldLength + flagBytes(entry.oldLength), entry.newLength);
+}
+
+void UndoEngine::append(Entry entry, const QByteArray & oldBa, const QByteArray & oldChanged, const QByteArray & newBa)
+{
+    entry.offset = _arena.size();
+    _arena.append(oldBa);
+
+    QByteArray bits(flagBytes(entry.oldLength), char(0));
+    for (int i = 0; i < entry.oldLength; i++)
+        if (oldChanged[i])
+            bits[i >> 3] = char(bits[i >> 3] | (1 << (i & 7)));
+    _arena.append(bits);
+
+    _arena.append(newBa);
+    _entries.append(entry);
+}
+
+// Folds next, which was just applied, into the top entry. Both are read as
+// "replace oldLength bytes at pos by newLength bytes", next in the
+// coordinates after the top entry.
+bool UndoEngine::mergeWithTop(const Entry & next, const QByteArray & oldBa, const QByteArray & oldChanged)
+{
+    if (_entries.isEmpty() || !_entries.last().mergeable)
+        return false;
+
+    Entry top = _entries.last();
+    int a = top.pos;
+    int aEnd = top.pos + top.newLength;
+    int b = next.pos;
+    int bEnd = next.pos + next.oldLength;
+    if ((b > aEnd) || (bEnd < a))
+        return false;                       // not touching
+
+    int start = qMin(a, b);
+    int end = qMax(aEnd, bEnd);
+    int oldLength = end - start - top.newLength + top.oldLength;
+    int newLength = end - start + next.newLength - next.oldLength;
+    if (qMax(oldLength, newLength) > MERGE_LIMIT)
+        return false;
+
+    // The bytes around the top entry's range were first overwritten by next,
+    // so their original state is in next's old part
+    QByteArray mergedOld = oldBytes(top);
+    QByteArray mergedChanged = oldFlags(top);
+    if (start < a)
+    {
+        mergedOld.prepend(oldBa.left(a - start));
+        mergedChanged.prepend(oldChanged.left(a - start));
+    }
+    if (end > aEnd)
+    {
+        mergedOld.append(oldBa.mid(aEnd - b, end - aEnd));
+        mergedChanged.append(oldChanged.mid(aEnd - b, end - aEnd));
+    }
+
+    _entries.removeLast();
+    _arena.truncate(top.offset);
+    top.pos = start;
+    top.oldLength = oldLength;
+    top.newLength = newLength;
+    append(top, mergedOld, mergedChanged, _xData->data().mid(start, newLength));
+    return true;
+}
+
+void UndoEngine::truncate(int count)
+{
+    if (count >= _entries.size())
+        return;
+    _arena.truncate(_entries[count].offset);
+    _entries.resize(count);
+    if (_entries.isEmpty())
+    {
+        _arena.clear();
+        _arenaHead = 0;
+    }
+}
+
+void UndoEngine::enforceLimit()
+{
+    if (_memoryLimit <= 0)
+        return;
+
+    // Only entries which are applied can go, and the newest one always stays
+    int usage = memoryUsage();
+    int drop = 0;
+    while ((usage > _memoryLimit) && (drop < _index) && (drop < _entries.size() - 1))
+    {
+        usage -= payloadSize(_entries[drop]) + int(sizeof(Entry));
+        drop++;
+    }
+    if (drop == 0)
+        return;
+
+    _entries.remove(0, drop);
+    _index -= drop;
+    _arenaHead = _entries.first().offset;
+
+    // Compact once the dead head outweighs the live entries
+    if (_arenaHead > _arena.size() / 2)
+    {
+        _arena.remove(0, _arenaHead);
+        _arena.squeeze();
+        for (int i = 0; i < _entries.size(); i++)
+            _entries[i].offset -= _arenaHead;
+        _arenaHead = 0;
+    }
+}
+
+void UndoEngine::apply(int pos, int removeLength, const QByteArray & ba)
+{
+    if (removeLength == ba.length())
+    {
+        if (removeLength > 0)
+            _xData->replace(pos, ba);
+        return;
+    }
+    if (removeLength > 0)
+        _xData->remove(pos, removeLength);
+    if (ba.length() > 0)
+        _xData->insert(pos, ba);
+}
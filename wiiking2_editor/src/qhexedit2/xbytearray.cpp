@@ -5,7 +5,8 @@ XByteArray::XByteArray()
     _oldSize = -99;
     _addressNumbers = 4;
     _addressOffset = 0;
-
+    _dirtyBegin = -1;
+    _dirtyEnd = -1;
 }
 
 int XByteArray::addressOffset()
@@ -39,33 +40,49 @@ QByteArray & XByteArray::data()
 void XByteArray::setData(QByteArray data)
 {
     _data = data;
-    _changedData = QByteArray(data.length(), char(0));
+    _changedData.reset(data.length());
+    _dirtyBegin = -1;
+    _dirtyEnd = -1;
 }
 
 bool XByteArray::dataChanged(int i)
 {
-    return bool(_changedData[i]);
+    return _changedData.testBit(i);
 }
 
 QByteArray XByteArray::dataChanged(int i, int len)
 {
-    return _changedData.mid(i, len);
+    return _changedData.toBytes(i, len);
 }
 
 void XByteArray::setDataChanged(int i, bool state)
 {
-    _changedData[i] = char(state);
+    _changedData.setRange(i, 1, state);
 }
 
 void XByteArray::setDataChanged(int i, const QByteArray & state)
 {
-    int length = state.length();
-    int len;
-    if ((i + length) > _changedData.length())
-        len = _changedData.length() - i;
-    else
-        len = length;
-    _changedData.replace(i, len, state);
+    _changedData.setBytes(i, state);
+}
+
+int XByteArray::nextChanged(int from)
+{
+    return _changedData.nextSet(from);
+}
+
+int XByteArray::previousChanged(int from)
+{
+    return _changedData.previousSet(from);
+}
+
+int XByteArray::changedRunStart(int from)
+{
+    return _changedData.previousClear(from) + 1;
+}
+
+int XByteArray::changedRunEnd(int from)
+{
+    return _changedData.nextClear(from);
 }
 
 int XByteArray::realAddressNumbers()
@@ -88,19 +105,23 @@ int XByteArray::size()
 QByteArray & XByteArray::insert(int i, char ch)
 {
     _data.insert(i, ch);
-    _changedData.insert(i, char(1));
+    _changedData.insert(i, 1, true);
+    markDirty(i, _data.size());
     return _data;
 }
 
 QByteArray & XByteArray::insert(int i, const QByteArray & ba)
 {
     _data.insert(i, ba);
-    _changedData.insert(i, QByteArray(ba.length(), char(1)));
+    _changedData.insert(i, ba.length(), true);
+    markDirty(i, _data.size());
     return _data;
 }
 
 QByteArray & XByteArray::remove(int i, int len)
 {
+    // Everything behind i moves, so the old tail is dirty as well
+    markDirty(i, _data.size());
     _data.remove(i, len);
     _changedData.remove(i, len);
     return _data;
@@ -109,7 +130,8 @@ QByteArray & XByteArray::remove(int i, int len)
 QByteArray & XByteArray::replace(int index, char ch)
 {
     _data[index] = ch;
-    _changedData[index] = char(1);
+    _changedData.setRange(index, 1, true);
+    markDirty(index, index + 1);
     return _data;
 }
 
@@ -127,10 +149,35 @@ QByteArray & XByteArray::replace(int index, int length, const QByteArray & ba)
     else
         len = length;
     _data.replace(index, len, ba.mid(0, len));
-    _changedData.replace(index, len, QByteArray(len, char(1)));
+    _changedData.setRange(index, len, true);
+    markDirty(index, index + len);
     return _data;
 }
 
+bool XByteArray::takeDirtyRange(int &index, int &length)
+{
+    if (_dirtyBegin < 0)
+        return false;
+
+    index = _dirtyBegin;
+    length = _dirtyEnd - _dirtyBegin;
+    _dirtyBegin = -1;
+    _dirtyEnd = -1;
+    return true;
+}
+
+void XByteArray::markDirty(int begin, int end)
+{
+    if (_dirtyBegin < 0)
+    {
+        _dirtyBegin = begin;
+        _dirtyEnd = end;
+        return;
+    }
+    _dirtyBegin = qMin(_dirtyBegin, begin);
+    _dirtyEnd = qMax(_dirtyEnd, end);
+}
+
 QChar XByteArray::asciiChar(int index)
 {
     char ch = _data[index];
@@ -141,27 +188,31 @@ QChar XByteArray::asciiChar(int index)
 
 QString XByteArray::toRedableString(int start, int end)
 {
-    int adrWidth = realAddressNumbers();
-    if (_addressNumbers > adrWidth)
-        adrWidth = _addressNumbers;
-    if (end < 0)
+    return QString::fromLatin1(toText(HexDumpFormatter::HexDump, start, end));
+}
+
+QByteArray XByteArray::toText(HexDumpFormatter::Style style, int start, int end)
+{
+    if ((end < 0) || (end > _data.size()))
         end = _data.size();
+    if (start > end)
+        start = end;
 
-    QString result;
-    for (int i=start; i < end; i += 16)
-    {
-        QString adrStr = QString("%1").arg(_addressOffset + i, adrWidth, 16, QChar('0'));
-        QString hexStr;
-        QString ascStr;
-        for (int j=0; j<16; j++)
-        {
-            if ((i + j) < _data.size())
-            {
-                hexStr.append(" ").append(_data.mid(i+j, 1).toHex());
-                ascStr.append(asciiChar(i+j));
-            }
-        }
-        result += adrStr + " " + QString("%1").arg(hexStr, -48) + "  " + QString("%1").arg(ascStr, -17) + "\n";
-    }
-    return result;
+    HexDumpFormatter formatter(style);
+    formatter.setAddressOffset(_addressOffset);
+    formatter.setAddressWidth(qMax(realAddressNumbers(), _addressNumbers));
+    return formatter.format(_data.constData() + start, end - start, start);
+}
+
+bool XByteArray::writeText(QIODevice *device, HexDumpFormatter::Style style, int start, int end)
+{
+    if ((end < 0) || (end > _data.size()))
+        end = _data.size();
+    if (start > end)
+        start = end;
+
+    HexDumpFormatter formatter(style);
+    formatter.setAddressOffset(_addressOffset);
+    formatter.setAddressWidth(qMax(realAddressNumbers(), _addressNumbers));
+    return formatter.write(device, _data.constData() + start, end - start, start);
 }
@@ -0,0 +1,362 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "savegenerator.h"
+#include "checksum.h"
+#include "savetemplate.h"
+#include "slotlayout.h"
+#include "tracer.h"
+#include "wiitime.h"
+
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <string.h>
+
+static const quint64 SECONDS_PER_HOUR = 3600;
+// From the release of the game to the end of 2030, in seconds since 2000
+static const quint64 FIRST_SAVE_TIME  = 374803200LL;
+static const quint64 LAST_SAVE_TIME   = 978307199LL;
+
+// How a field is randomised, values are drawn uniformly from Min to Max.
+// The ranges are the ones the editor allows, flags take any bits.
+struct FieldRange
+{
+    enum Kind
+    {
+        Byte,
+        Word,
+        Qword,
+        Float,      //!< Whole numbers from Min to Max
+        Packed7,    //!< Both 7 bit counters of a quint16
+        Bits16,     //!< Width bits at Shift inside a quint16
+        Bits32      //!< Width bits at Shift inside a quint32
+    };
+
+    quint32 Offset;
+    int     Count;  //!< Consecutive elements
+    Kind    Type;
+    qint64  Min;
+    qint64  Max;
+    int     Shift;
+    int     Width;
+};
+
+#define RANGE(field, count, type, min, max) \
+    { offsetof(SlotLayout, field), count, FieldRange::type, min, max, 0, 0 }
+#define RANGE_BITS(bits, type, min, max) \
+    { bits::OFFSET, 1, FieldRange::type, min, max, bits::SHIFT, bits::WIDTH }
+
+static const FieldRange SLOT_RANGES[] =
+{
+    RANGE(playTime,           1,  Qword,   0, 1000 * SECONDS_PER_HOUR * TICKS_PER_SECOND),
+    RANGE(saveTime,           1,  Qword,   FIRST_SAVE_TIME * TICKS_PER_SECOND, LAST_SAVE_TIME * TICKS_PER_SECOND),
+    RANGE(playerPosition,     3,  Float,   -100000, 100000),
+    RANGE(playerRotation,     3,  Float,   -180, 180),
+    RANGE(cameraPosition,     3,  Float,   -100000, 100000),
+    RANGE(cameraRotation,     3,  Float,   -180, 180),
+    RANGE(hornetFlags,        1,  Byte,    0, 255),
+    RANGE(heroModeFlags,      1,  Byte,    0, 255),
+    RANGE(materialFlags,      4,  Byte,    0, 255),
+    RANGE(introFlags,         1,  Byte,    0, 255),
+    RANGE(equipmentFlags,     11, Byte,    0, 255),
+    RANGE(walletFlags,        1,  Byte,    0, 255),
+    RANGE(itemFlags,          10, Byte,    0, 255),
+    RANGE(materialQuantities, 8,  Packed7, 0, 99),
+    RANGE(bugQuantities,      6,  Packed7, 0, 99),
+    RANGE_BITS(GratitudeCrystalField, Bits16, 0, 80),
+    RANGE(rupees,             1,  Word,    0, 9999),
+    RANGE_BITS(ArrowAmmoField,        Bits32, 0, 127),
+    RANGE_BITS(BombAmmoField,         Bits32, 0, 127),
+    RANGE_BITS(SeedAmmoField,         Bits32, 0, 127),
+    RANGE(totalHP,            1,  Word,    24, 80),
+    RANGE(roomID,             1,  Byte,    0, 255),
+    RANGE(night,              1,  Byte,    0, 1),
+};
+
+#undef RANGE
+#undef RANGE_BITS
+
+static const int SLOT_RANGE_COUNT = sizeof(SLOT_RANGES) / sizeof(SLOT_RANGES[0]);
+
+// Skyloft, the Sky, the three surface provinces and their first dungeons
+static const char* const STAGES[] =
+{
+    "F000", "F001r", "F020", "F100", "F200", "F300", "D100", "D200", "D300"
+};
+
+static const int STAGE_COUNT = sizeof(STAGES) / sizeof(STAGES[0]);
+
+static const char NAME_CHARACTERS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789 ";
+
+// splitmix64, small and good enough to seed and to draw field values
+static quint64 nextRandom(quint64& state)
+{
+    quint64 z = (state += Q_UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+static qint64 randomIn(quint64& state, qint64 min, qint64 max)
+{
+    return min + qint64(nextRandom(state) % quint64(max - min + 1));
+}
+
+static void setBits(char* word, int size, int shift, int width, quint32 value)
+{
+    quint32 mask = ((1u << width) - 1) << shift;
+    if (size == 2)
+        beStore<quint16>(word, quint16((beLoad<quint16>(word) & ~mask) | ((value << shift) & mask)));
+    else
+        beStore<quint32>(word, (beLoad<quint32>(word) & ~mask) | ((value << shift) & mask));
+}
+
+SaveGenerator::SaveGenerator(quint64 seed) :
+    m_seed(seed),
+    m_occupancy(100),
+    m_threads(0),
+    m_totalWeight(0),
+    m_written(0)
+{
+}
+
+void SaveGenerator::setSeed(quint64 seed)
+{
+    m_seed = seed;
+}
+
+quint64 SaveGenerator::seed() const
+{
+    return m_seed;
+}
+
+void SaveGenerator::setOccupancy(int percent)
+{
+    m_occupancy = qBound(0, percent, 100);
+}
+
+int SaveGenerator::occupancy() const
+{
+    return m_occupancy;
+}
+
+void SaveGenerator::addRegion(quint32 region, int weight)
+{
+    if (weight <= 0)
+        return;
+
+    RegionWeight entry;
+    entry.Region = region;
+    entry.Weight = weight;
+    m_regions.append(entry);
+    m_totalWeight += weight;
+}
+
+void SaveGenerator::setThreads(int count)
+{
+    m_threads = qMax(0, count);
+}
+
+quint32 SaveGenerator::pickRegion(quint64 random) const
+{
+    if (m_totalWeight == 0)
+        return SaveLayout::NTSCURegion;
+
+    int pick = int(random % quint64(m_totalWeight));
+    foreach (const RegionWeight& entry, m_regions)
+    {
+        if (pick < entry.Weight)
+            return entry.Region;
+        pick -= entry.Weight;
+    }
+    return m_regions.last().Region;
+}
+
+void SaveGenerator::generate(quint64 index, char* save) const
+{
+    TRACE_SCOPE("SaveGenerator::generate");
+    // Every save gets its own stream, derived from the seed and its index
+    quint64 state = m_seed;
+    state = nextRandom(state) ^ index;
+    nextRandom(state);
+
+    SaveTemplate::createFile(save, pickRegion(nextRandom(state)));
+    for (int i = 0; i < SaveTemplate::SLOT_COUNT; i++)
+    {
+        quint64 slotState = nextRandom(state);
+        if (int(nextRandom(state) % 100) < m_occupancy)
+            randomizeSlot(save, i, slotState);
+    }
+}
+
+QByteArray SaveGenerator::generate(quint64 index) const
+{
+    QByteArray save(SaveTemplate::SAVE_SIZE, '\0');
+    generate(index, save.data());
+    return save;
+}
+
+void SaveGenerator::randomizeSlot(char* save, int index, quint64 state) const
+{
+    char* slot = save + SaveTemplate::SLOT_OFFSET + SlotLayout::SIZE * index;
+    SlotLayout* layout = (SlotLayout*)slot;
+    *layout = SaveTemplate::freshGame();
+
+    for (int f = 0; f < SLOT_RANGE_COUNT; f++)
+    {
+        const FieldRange& range = SLOT_RANGES[f];
+        for (int i = 0; i < range.Count; i++)
+        {
+            switch (range.Type)
+            {
+                case FieldRange::Byte:
+                    slot[range.Offset + i] = char(randomIn(state, range.Min, range.Max));
+                    break;
+                case FieldRange::Word:
+                    beStore<quint16>(slot + range.Offset + i * 2, quint16(randomIn(state, range.Min, range.Max)));
+                    break;
+                case FieldRange::Qword:
+                    beStore<quint64>(slot + range.Offset + i * 8, quint64(randomIn(state, range.Min, range.Max)));
+                    break;
+                case FieldRange::Float:
+                    beStore<float>(slot + range.Offset + i * 4, float(randomIn(state, range.Min, range.Max)));
+                    break;
+                case FieldRange::Packed7:
+                    setBits(slot + range.Offset + i * 2, 2, 0, 7, quint32(randomIn(state, range.Min, range.Max)));
+                    setBits(slot + range.Offset + i * 2, 2, 7, 7, quint32(randomIn(state, range.Min, range.Max)));
+                    break;
+                case FieldRange::Bits16:
+                    setBits(slot + range.Offset, 2, range.Shift, range.Width, quint32(randomIn(state, range.Min, range.Max)));
+                    break;
+                case FieldRange::Bits32:
+                    setBits(slot + range.Offset, 4, range.Shift, range.Width, quint32(randomIn(state, range.Min, range.Max)));
+                    break;
+            }
+        }
+    }
+
+    // Fields which depend on each other
+    layout->currentHP.set(quint16(randomIn(state, 0, layout->totalHP.get())));
+    layout->unknownHP.set(layout->totalHP.get());
+
+    int nameLength = int(randomIn(state, 1, 8));
+    for (int i = 0; i < 8; i++)
+    {
+        quint16 c = i < nameLength ? NAME_CHARACTERS[randomIn(state, 0, sizeof(NAME_CHARACTERS) - 2)] : 0;
+        layout->playerName[i].set(c);
+    }
+
+    const char* stage = STAGES[randomIn(state, 0, STAGE_COUNT - 1)];
+    memset(layout->currentMap,  0, sizeof(layout->currentMap));
+    memset(layout->currentArea, 0, sizeof(layout->currentArea));
+    memset(layout->currentRoom, 0, sizeof(layout->currentRoom));
+    memcpy(layout->currentMap,  stage, strlen(stage));
+    memcpy(layout->currentArea, stage, strlen(stage));
+    memcpy(layout->currentRoom, stage, strlen(stage));
+
+    Checksum checksum;
+    layout->checksum.set(checksum.CRC32((const quint8*)save, SaveTemplate::SLOT_OFFSET + SlotLayout::SIZE * index,
+                                        offsetof(SlotLayout, checksum)));
+}
+
+// Builds and writes every threads-th save, starting at first
+class GenerateTask : public QRunnable
+{
+public:
+    GenerateTask(SaveGenerator* generator, const QDir& dir, quint64 first, quint64 count, int step, int width) :
+        m_generator(generator),
+        m_dir(dir),
+        m_first(first),
+        m_count(count),
+        m_step(step),
+        m_width(width)
+    {
+    }
+
+    void run()
+    {
+        static QMutex mutex;
+        QByteArray save(SaveTemplate::SAVE_SIZE, '\0');
+        quint64 written = 0;
+        QStringList errors;
+        for (quint64 i = m_first; i < m_count; i += m_step)
+        {
+            m_generator->generate(i, save.data());
+            QString path = m_dir.filePath(QString("wiiking2-%1.sav").arg(i, m_width, 10, QChar('0')));
+            QFile file(path);
+            if (file.open(QFile::WriteOnly) && file.write(save) == save.size())
+                written++;
+            else
+                errors << QString("Unable to write %1").arg(path);
+        }
+
+        QMutexLocker locker(&mutex);
+        m_generator->m_written += written;
+        m_generator->m_errors << errors;
+    }
+
+private:
+    SaveGenerator* m_generator;
+    QDir    m_dir;
+    quint64 m_first;
+    quint64 m_count;
+    int     m_step;
+    int     m_width;
+};
+
+bool SaveGenerator::run(const QString& outputDir, quint64 count)
+{
+    m_written = 0;
+    m_errors.clear();
+
+    QDir dir(outputDir);
+    if (!dir.mkpath("."))
+    {
+        m_errors << QString("Unable to create %1").arg(outputDir);
+        return false;
+    }
+
+    // Build the templates before the threads start asking for them
+    SaveTemplate::freshGame();
+    foreach (const RegionWeight& entry, m_regions)
+        SaveTemplate::emptyFile(entry.Region);
+
+    int threads = m_threads > 0 ? m_threads : QThread::idealThreadCount();
+    threads = int(qMin(quint64(qMax(threads, 1)), qMax(count, quint64(1))));
+    int width = QString::number(count > 0 ? count - 1 : 0).length();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (int i = 0; i < threads; i++)
+        pool.start(new GenerateTask(this, dir, i, count, threads, width));
+    pool.waitForDone();
+
+    return m_errors.isEmpty();
+}
+
+quint64 SaveGenerator::written() const
+{
+    return m_written;
+}
+
+QStringList SaveGenerator::errors() const
+{
+    return m_errors;
+}
@@ -0,0 +1,151 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "savetemplate.h"
+#include "checksum.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <string.h>
+
+const float SaveTemplate::START_POS_X = -4798.150391f;
+const float SaveTemplate::START_POS_Y =  1237.629517f;
+const float SaveTemplate::START_POS_Z = -6573.722656f;
+
+static SlotLayout* slotAt(char* save, int index)
+{
+    return (SlotLayout*)(save + SaveTemplate::SLOT_OFFSET + SlotLayout::SIZE * index);
+}
+
+static quint32 slotChecksum(const char* save, int index)
+{
+    Checksum checksum;
+    return checksum.CRC32((const quint8*)save, SaveTemplate::SLOT_OFFSET + SlotLayout::SIZE * index,
+                          offsetof(SlotLayout, checksum));
+}
+
+QByteArray SaveTemplate::emptyFile(quint32 region)
+{
+    static QMutex mutex;
+    static QHash<quint32, QByteArray> templates;
+
+    QMutexLocker locker(&mutex);
+    if (!templates.contains(region))
+        templates.insert(region, buildEmptyFile(region));
+    return templates.value(region);
+}
+
+SlotLayout SaveTemplate::freshGame()
+{
+    static QMutex mutex;
+    static bool built = false;
+    static SlotLayout fresh;
+
+    QMutexLocker locker(&mutex);
+    if (!built)
+    {
+        fresh = buildFreshGame();
+        built = true;
+    }
+    return fresh;
+}
+
+QByteArray SaveTemplate::buildEmptyFile(quint32 region)
+{
+    QByteArray file(SAVE_SIZE, '\0');
+    char* save = file.data();
+    qToLittleEndian<quint32>(region, (uchar*)save);
+    // The game expects 0x1D at 0x001F
+    save[0x001F] = 0x1D;
+
+    // Empty slots are marked as new, the game treats zeroed ones as corrupt
+    for (int i = 0; i < SLOT_COUNT; i++)
+    {
+        SlotLayout* slot = slotAt(save, i);
+        slot->newGame.set(1);
+        slot->checksum.set(slotChecksum(save, i));
+    }
+    return file;
+}
+
+SlotLayout SaveTemplate::buildFreshGame()
+{
+    char save[SLOT_OFFSET + SlotLayout::SIZE];
+    memset(save, 0, sizeof(save));
+
+    SlotLayout* slot = slotAt(save, 0);
+    memcpy(slot->currentMap,  "F000", 4);
+    memcpy(slot->currentArea, "F000", 4);
+    memcpy(slot->currentRoom, "F000", 4);
+    slot->playerPosition.set(Vector3(START_POS_X, START_POS_Y, START_POS_Z));
+    slot->playerRotation.set(Vector3(0.0f, 0.0f, 0.0f));
+    slot->cameraPosition.set(Vector3(START_POS_X, START_POS_Y, START_POS_Z));
+    slot->cameraRotation.set(Vector3(0.0f, 0.0f, 0.0f));
+    slot->checksum.set(slotChecksum(save, 0));
+    return *slot;
+}
+
+void SaveTemplate::createFile(char* save, quint32 region)
+{
+    memcpy(save, emptyFile(region).constData(), SAVE_SIZE);
+}
+
+bool SaveTemplate::createGame(char* save, int index, quint64 saveTime, const QString& playerName)
+{
+    if (index < 0 || index >= SLOT_COUNT)
+        return false;
+
+    *slotAt(save, index) = freshGame();
+    setSaveTime(save, index, saveTime);
+    if (!playerName.isEmpty())
+        setPlayerName(save, index, playerName);
+    return true;
+}
+
+bool SaveTemplate::setSaveTime(char* save, int index, quint64 saveTime)
+{
+    if (index < 0 || index >= SLOT_COUNT)
+        return false;
+
+    BEValue<quint64> value;
+    value.set(saveTime);
+    patch(save, index, &slotAt(save, index)->saveTime, &value, sizeof(value));
+    return true;
+}
+
+bool SaveTemplate::setPlayerName(char* save, int index, const QString& name)
+{
+    if (index < 0 || index >= SLOT_COUNT)
+        return false;
+
+    BEValue<quint16> value[8];
+    for (int i = 0; i < 8; i++)
+        value[i].set(i < name.length() ? name.at(i).unicode() : 0);
+    patch(save, index, slotAt(save, index)->playerName, value, sizeof(value));
+    return true;
+}
+
+// Writes size bytes over field and moves the slot checksum along with them
+void SaveTemplate::patch(char* save, int index, void* field, const void* value, int size)
+{
+    SlotLayout* slot = slotAt(save, index);
+    Checksum checksum;
+    quint32 crc = checksum.CRC32Patch(slot->checksum.get(), offsetof(SlotLayout, checksum),
+                                      (char*)field - (char*)slot, (const quint8*)field, (const quint8*)value, size);
+    memcpy(field, value, size);
+    slot->checksum.set(crc);
+}
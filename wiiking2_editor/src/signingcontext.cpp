@@ -0,0 +1,159 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "signingcontext.h"
+#include "databincodec.h"
+#include "ec233.h"
+
+#include <QCryptographicHash>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <string.h>
+
+SigningContext::SigningContext(quint32 ngId, quint32 ngKeyId, const QByteArray& ngPriv, const QByteArray& ngSig, const QByteArray& macAddr) :
+    m_ngId(ngId),
+    m_ngPriv(ngPriv.left(Ec233::ELEMENT_SIZE)),
+    m_macAddr(macAddr.left(6))
+{
+    m_ngPriv.append(QByteArray(Ec233::ELEMENT_SIZE - m_ngPriv.size(), '\0'));
+    m_macAddr.append(QByteArray(6 - m_macAddr.size(), '\0'));
+    QByteArray sig = ngSig.left(Ec233::SIGNATURE_SIZE);
+    sig.append(QByteArray(Ec233::SIGNATURE_SIZE - sig.size(), '\0'));
+
+    const quint8* priv = (const quint8*)m_ngPriv.constData();
+    m_publicKey = QByteArray(Ec233::POINT_SIZE, '\0');
+    Ec233::publicKey(priv, (quint8*)m_publicKey.data());
+
+    m_ngCert = makeCert("Root-CA00000001-MS00000002", QString("NG%1").arg(ngId, 8, 16, QChar('0')).toLatin1(),
+                        (const quint8*)sig.constData(), priv, ngKeyId);
+
+    m_apPriv = QByteArray(Ec233::ELEMENT_SIZE, '\0');
+    m_apPriv[10] = 1;                       // the AP key is the same for every save, only its certificate differs
+    QByteArray apSigner = QString("Root-CA00000001-MS00000002-NG%1").arg(ngId, 8, 16, QChar('0')).toLatin1();
+    QByteArray apName = QByteArray("AP0000000100000002");
+    quint8 apSig[Ec233::SIGNATURE_SIZE];
+    memset(apSig, 0, sizeof(apSig));
+    m_apCert = makeCert(apSigner, apName, apSig, (const quint8*)m_apPriv.constData(), 0);
+
+    // the AP certificate is signed over everything after the signature
+    QByteArray hash = QCryptographicHash::hash(m_apCert.mid(0x80, 0x100), QCryptographicHash::Sha1);
+    Ec233::sign(priv, (const quint8*)hash.constData(), apSig);
+    memcpy(m_apCert.data() + 4, apSig, sizeof(apSig));
+}
+
+quint32 SigningContext::ngId() const
+{
+    return m_ngId;
+}
+
+QByteArray SigningContext::macAddress() const
+{
+    return m_macAddr;
+}
+
+QByteArray SigningContext::publicKey() const
+{
+    return m_publicKey;
+}
+
+QByteArray SigningContext::ngCert() const
+{
+    return m_ngCert;
+}
+
+QByteArray SigningContext::apCert() const
+{
+    return m_apCert;
+}
+
+bool SigningContext::signDataBin(QByteArray& dataBin, QString* error) const
+{
+    const int bkOffset = DataBinCodec::HEADER_SIZE;
+    if (dataBin.size() < int(bkOffset + DataBinCodec::BK_HEADER_SIZE))
+    {
+        if (error)
+            *error = "File is too small to be a data.bin";
+        return false;
+    }
+
+    quint8* bk = (quint8*)dataBin.data() + bkOffset;
+    quint32 filesSize = qFromBigEndian<quint32>(bk + 0x10);
+    qint64 signedSize = qint64(DataBinCodec::BK_HEADER_SIZE) + filesSize;
+    if (bkOffset + signedSize > dataBin.size())
+    {
+        if (error)
+            *error = "The file table is larger than the file";
+        return false;
+    }
+
+    qToBigEndian<quint32>(m_ngId, bk + 0x08);
+    qToBigEndian<quint32>(filesSize + DataBinCodec::BK_HEADER_SIZE + TAIL_SIZE, bk + 0x1C);
+    memcpy(bk + 0x68, m_macAddr.constData(), 6);
+
+    dataBin.resize(bkOffset + signedSize + TAIL_SIZE);
+    quint8* tail = (quint8*)dataBin.data() + bkOffset + signedSize;
+
+    QByteArray hash = QCryptographicHash::hash(QByteArray::fromRawData(dataBin.constData() + bkOffset, signedSize),
+                                               QCryptographicHash::Sha1);
+    hash = QCryptographicHash::hash(hash, QCryptographicHash::Sha1);
+
+    memset(tail, 0, SIGNATURE_SIZE);
+    Ec233::sign((const quint8*)m_apPriv.constData(), (const quint8*)hash.constData(), tail);
+    qToBigEndian<quint32>(0x2F536969, tail + Ec233::SIGNATURE_SIZE);
+    memcpy(tail + SIGNATURE_SIZE, m_ngCert.constData(), CERT_SIZE);
+    memcpy(tail + SIGNATURE_SIZE + CERT_SIZE, m_apCert.constData(), CERT_SIZE);
+    return true;
+}
+
+QSharedPointer<const SigningContext> SigningContext::cached(quint32 ngId, quint32 ngKeyId, const QByteArray& ngPriv,
+                                                            const QByteArray& ngSig, const QByteArray& macAddr)
+{
+    static QMutex mutex;
+    static QHash<QByteArray, QSharedPointer<const SigningContext> > contexts;
+
+    QCryptographicHash keyHash(QCryptographicHash::Sha1);
+    quint32 ids[2] = { ngId, ngKeyId };
+    keyHash.addData((const char*)ids, sizeof(ids));
+    keyHash.addData(ngPriv);
+    keyHash.addData(ngSig);
+    keyHash.addData(macAddr);
+    QByteArray key = keyHash.result();
+
+    QMutexLocker locker(&mutex);
+    QSharedPointer<const SigningContext> context = contexts.value(key);
+    if (context.isNull())
+    {
+        context = QSharedPointer<const SigningContext>(new SigningContext(ngId, ngKeyId, ngPriv, ngSig, macAddr));
+        contexts.insert(key, context);
+    }
+    return context;
+}
+
+QByteArray SigningContext::makeCert(const QByteArray& signer, const QByteArray& name, const quint8* signature,
+                                    const quint8* priv, quint32 keyId)
+{
+    QByteArray cert(CERT_SIZE, '\0');
+    quint8* p = (quint8*)cert.data();
+    qToBigEndian<quint32>(0x00010002, p);
+    memcpy(p + 4, signature, Ec233::SIGNATURE_SIZE);
+    memcpy(p + 0x80, signer.constData(), qMin(signer.size(), 0x3F));
+    qToBigEndian<quint32>(2, p + 0xC0);
+    memcpy(p + 0xC4, name.constData(), qMin(name.size(), 0x3F));
+    qToBigEndian<quint32>(keyId, p + 0x104);
+    Ec233::publicKey(priv, p + 0x108);
+    return cert;
+}
@@ -23,15 +23,26 @@
 #include "wiikeys.h"
 #include "checksum.h"
 #include "settingsmanager.h"
+#include "databincodec.h"
+#include "databinreader.h"
+#include "databinresigner.h"
+#include "signingcontext.h"
+#include "slottransfer.h"
+#include "savetemplate.h"
+#include "tracer.h"
 #include <WiiSaveReader.hpp>
 #include <WiiSaveWriter.hpp>
 #include <utility.hpp>
-#include <QMessageBox>
 
 #include <QtEndian>
+#include <QBuffer>
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTemporaryFile>
 #include <time.h>
 
 // This constructor allows us to create a new save file.
@@ -77,9 +88,11 @@ SkywardSwordFile::~SkywardSwordFile()
 
 bool SkywardSwordFile::open(Game game, const QString& filepath)
 {
+    TRACE_SCOPE("SkywardSwordFile::open");
     if (m_isOpen)
         close();
 
+    m_lastError.clear();
     if (m_game != game)
         m_game = game;
 
@@ -96,9 +109,10 @@ bool SkywardSwordFile::open(Game game, const QString& filepath)
 
         if (file.open(QIODevice::ReadOnly))
         {
-            if (file.size() != 0xFBE0)
+            if (file.size() != SaveLayout::SIZE)
             {
                 file.close();
+                m_lastError = tr("\"%1\" is not a Skyward Sword save file").arg(m_filename);
                 return false;
             }
 
@@ -108,14 +122,17 @@ bool SkywardSwordFile::open(Game game, const QString& filepath)
                 m_data = NULL;
             }
 
-            m_data = new char[0xFBE0];
+            m_data = new char[SaveLayout::SIZE];
 
-
-            file.read((char*)m_data, 0xFBE0);
-            file.close();
+            {
+                TRACE_PHASE_SCOPE("SkywardSwordFile::open read", IoPhase);
+                file.read((char*)m_data, SaveLayout::SIZE);
+                file.close();
+            }
             m_isOpen = true;
             return true;
         }
+        m_lastError = file.errorString();
     }
 
     return false;
@@ -123,12 +140,14 @@ bool SkywardSwordFile::open(Game game, const QString& filepath)
 
 bool SkywardSwordFile::save(const QString& filename)
 {
+    TRACE_SCOPE("SkywardSwordFile::save");
     if (!m_isOpen)
         return false;
 
     if (!filename.isEmpty())
         m_filename = filename;
 
+    m_lastError.clear();
     if (m_filename.lastIndexOf(".bin") == m_filename.size() - 4)
     {
 //#ifdef DEBUG
@@ -142,28 +161,32 @@ bool SkywardSwordFile::save(const QString& filename)
 
     QString tmpFilename = m_filename;
     tmpFilename = tmpFilename.remove(m_filename.lastIndexOf("."), tmpFilename.length() - tmpFilename.lastIndexOf(".")) + ".tmp";
+
+    for (int i = 0; i < GameCount; ++i)
+    {
+        Game oldGame = game();
+        setGame((Game)i);
+        if (!hasValidChecksum())
+            updateChecksum(); // ensure the file has the correct Checksum
+        setGame(oldGame);
+    }
+
+    TRACE_PHASE_SCOPE("SkywardSwordFile::save write", IoPhase);
     FILE* f = fopen(tmpFilename.toStdString().c_str(), "wb");
     if (f)
     {
-        for (int i = 0; i < GameCount; ++i)
-        {
-            Game oldGame = game();
-            setGame((Game)i);
-            if (!hasValidChecksum())
-                updateChecksum(); // ensure the file has the correct Checksum
-            setGame(oldGame);
-        }
-        fwrite(m_data, 1, 0xFBE0, f);
+        fwrite(m_data, 1, SaveLayout::SIZE, f);
         fclose(f);
 
         f = fopen(tmpFilename.toStdString().c_str(), "rb");
         if (f)
         {
-            char* tmpBuf = new char[0xFBE0];
-            fread(tmpBuf, 1, 0xFBE0, f);
+            char* tmpBuf = new char[SaveLayout::SIZE];
+            fread(tmpBuf, 1, SaveLayout::SIZE, f);
             fclose(f);
+            delete[] tmpBuf;
             QFile file(tmpFilename);
-            if (file.exists() && file.size() == 0xFBE0)
+            if (file.exists() && file.size() == SaveLayout::SIZE)
             {
 
                 file.remove(m_filename);
@@ -173,10 +196,13 @@ bool SkywardSwordFile::save(const QString& filename)
                 return true;
             }
             else
+            {
+                m_lastError = tr("Unable to write \"%1\"").arg(tmpFilename);
                 return false;
+            }
         }
-        return false;
     }
+    m_lastError = tr("Unable to write \"%1\"").arg(tmpFilename);
     return false;
 }
 
@@ -196,39 +222,21 @@ void SkywardSwordFile::createNewGame(SkywardSwordFile::Game game)
     }
 
     setGame(game);
-    memset(m_data + gameOffset(), 0, 0x53C0);
-    setNew(false);
-    m_game = game;
-    setSaveTime(QDateTime::currentDateTime());
-    setCurrentArea   ("F000");
-    setCurrentRoom   ("F000");
-    setCurrentMap    ("F000");
-    setPlayerPosition(DEFAULT_POS_X, DEFAULT_POS_Y, DEFAULT_POS_Z);
-    setPlayerRotation(0.0f, 0.0f, 0.0f);
-    setCameraPosition(DEFAULT_POS_X, DEFAULT_POS_Y, DEFAULT_POS_Z);
-    setCameraRotation(0.0f, 0.0f, 0.0f);
+    // The fresh slot comes with its checksum, only the save time is patched
+    SaveTemplate::createGame(m_data, game, toWiiTime(QDateTime::currentDateTime()));
+    m_isDirty = true;
+    emit checksumUpdated();
     emit modified();
 }
 
 void SkywardSwordFile::createEmptyFile(Region region)
 {
     // Need to create a new buffer so we can make our changes.
-    m_data = new char[0xFBE0];
-    // Zero out the buffer, just to make sure we don't have a 'corrupt' file
-    memset(m_data, 0, 0xFBE0);
-    // Set the region to the specified one.
-    setRegion(region);
-    // The game expects adress 0x001F to be 0x1D so do so.
-    m_data[0x001F] = 0x1D;
-
-    // Now each game needs to marked as "New" or the game will detect them
-    // Why the game uses a non-zero value for new games is beyond me.
-    for (int i = 0; i < 3; i++)
-    {
-        m_game = (IGameFile::Game)i;
-        updateChecksum();
-        setNew(true);
-    }
+    m_data = new char[SaveLayout::SIZE];
+    // Region, the 0x1D at 0x001F and three checksummed "New" slots
+    SaveTemplate::createFile(m_data, region);
+    m_dataBinImage.clear();
+    m_dataBinBanner = DataBinReader::Banner();
     m_game = IGameFile::Game1;
     m_isDirty = true;
     m_isOpen = true;
@@ -244,8 +252,7 @@ void SkywardSwordFile::exportGame(const QString& filepath, Game game, Region reg
 {
     if (game == GameNone)
         game = Game1;
-    char* outBuf = new char[0xFBE0];
-    memcpy(outBuf, (m_data + 0x20 + (0x53C0 * game)), 0x53C0);
+    SlotLayout slot = SlotLayout::fromData(m_data + SaveLayout::slotOffset(game));
     FILE* out = fopen(filepath.toStdString().c_str(), "wb");
     struct Header
     {
@@ -261,10 +268,69 @@ void SkywardSwordFile::exportGame(const QString& filepath, Game game, Region reg
     memset(&header.padding, 0, 0x14);
 
     fwrite(&header, 1, sizeof(header), out);
-    fwrite(outBuf, 1, 0x53C0, out);
+    fwrite(&slot, 1, SlotLayout::SIZE, out);
     fclose(out);
 }
 
+bool SkywardSwordFile::copyGame(Game from, Game to)
+{
+    return copyGame(*this, from, to);
+}
+
+bool SkywardSwordFile::copyGame(const SkywardSwordFile& source, Game from, Game to)
+{
+    if (!m_data || !source.m_data || !SlotTransfer::copy(source.m_data, from, m_data, to))
+        return false;
+
+    m_isDirty = true;
+    emit modified();
+    return true;
+}
+
+bool SkywardSwordFile::moveGame(Game from, Game to)
+{
+    return moveGame(*this, from, to);
+}
+
+bool SkywardSwordFile::moveGame(SkywardSwordFile& source, Game from, Game to)
+{
+    if (!m_data || !source.m_data || !SlotTransfer::move(source.m_data, from, m_data, to))
+        return false;
+
+    if (&source != this)
+    {
+        source.m_isDirty = true;
+        emit source.modified();
+    }
+    m_isDirty = true;
+    emit modified();
+    return true;
+}
+
+bool SkywardSwordFile::swapGames(Game first, Game second)
+{
+    if (!m_data || !SlotTransfer::swap(m_data, first, second))
+        return false;
+
+    m_isDirty = true;
+    emit modified();
+    return true;
+}
+
+SkywardSwordFile::Game SkywardSwordFile::duplicateGame(Game from)
+{
+    if (!m_data)
+        return GameNone;
+
+    int to = SlotTransfer::duplicate(m_data, from);
+    if (to < 0)
+        return GameNone;
+
+    m_isDirty = true;
+    emit modified();
+    return (Game)to;
+}
+
 void SkywardSwordFile::deleteGame(Game game)
 {
     if (!m_data)
@@ -272,7 +338,7 @@ void SkywardSwordFile::deleteGame(Game game)
 
     Game oldGame = m_game;
     m_game = game;
-    memset((uchar*)(m_data + gameOffset()), 0, 0x53BC);
+    memset(layout(), 0, offsetof(SlotLayout, checksum));
     setNew(true);
     updateChecksum();
     m_game = oldGame;
@@ -295,6 +361,8 @@ void SkywardSwordFile::close()
         delete m_saveGame;
 
     m_saveGame = NULL;
+    m_dataBinImage.clear();
+    m_dataBinBanner = DataBinReader::Banner();
     delete[] m_data;
     m_data = NULL;
     m_isOpen = false;
@@ -319,7 +387,8 @@ bool SkywardSwordFile::hasValidChecksum()
     if (!m_data)
         return false;
 
-    return (*(quint32*)(m_data + gameOffset() + 0x53BC) == qFromBigEndian<quint32>(m_checksumEngine.CRC32((const unsigned char*)m_data, gameOffset(), 0x53BC)));
+    TRACE_PHASE_SCOPE("SkywardSwordFile::hasValidChecksum", ChecksumPhase);
+    return layout()->checksum.get() == m_checksumEngine.CRC32((const unsigned char*)m_data, gameOffset(), offsetof(SlotLayout, checksum));
 }
 
 SkywardSwordFile::Game SkywardSwordFile::game() const
@@ -346,7 +415,7 @@ SkywardSwordFile::Region SkywardSwordFile::region() const
 {
     if (!m_data)
         return NTSCURegion;
-    return (Region)(*(quint32*)(m_data));
+    return (Region)qFromLittleEndian<quint32>((const uchar*)m_data);
 }
 
 void SkywardSwordFile::setRegion(SkywardSwordFile::Region val)
@@ -377,7 +446,11 @@ void SkywardSwordFile::setRegion(SkywardSwordFile::Region val)
         }
     }
 
-    *(quint32*)(m_data) = val;
+    // the banner differs per region, the image has to be rebuilt
+    m_dataBinImage.clear();
+    m_dataBinBanner = DataBinReader::Banner();
+
+    qToLittleEndian<quint32>(val, (uchar*)m_data);
     m_isDirty = true;
     emit modified();
 }
@@ -387,7 +460,7 @@ PlayTime SkywardSwordFile::playTime() const
     if (!m_data)
         return PlayTime();
     PlayTime playTime;
-    quint64 tmp = qFromBigEndian<quint64>(*(quint64*)(m_data + gameOffset()));
+    quint64 tmp = layout()->playTime.get();
     playTime.Days    = (((tmp / TICKS_PER_SECOND) / 60) / 60) / 24;
     playTime.Hours   = (((tmp / TICKS_PER_SECOND) / 60) / 60) % 24;
     playTime.Minutes = (( tmp / TICKS_PER_SECOND) / 60) % 60;
@@ -405,7 +478,7 @@ void SkywardSwordFile::setPlayTime(PlayTime val)
     totalSeconds += ( val.Hours   * 60) * 60;
     totalSeconds += ( val.Minutes * 60);
     totalSeconds +=   val.Seconds;
-    *(quint64*)(m_data + gameOffset()) = qToBigEndian<quint64>(TICKS_PER_SECOND * totalSeconds);
+    layout()->playTime.set(TICKS_PER_SECOND * totalSeconds);
     m_isDirty = true;
 
     this->updateChecksum();
@@ -417,12 +490,12 @@ QDateTime SkywardSwordFile::saveTime() const
     if (!m_data)
         return QDateTime::currentDateTime();
 
-    return fromWiiTime(qFromBigEndian(*(quint64*)(m_data + gameOffset() + 0x0008)));
+    return fromWiiTime(layout()->saveTime.get());
 }
 
 void SkywardSwordFile::setSaveTime(const QDateTime& time)
 {
-    *(qint64*)(m_data + gameOffset() + 0x0008) = qToBigEndian<qint64>(toWiiTime(time));
+    layout()->saveTime.set(toWiiTime(time));
     m_isDirty = true;
     this->updateChecksum();
     emit modified();
@@ -433,9 +506,7 @@ Vector3 SkywardSwordFile::playerPosition() const
     if (!m_data)
         return Vector3(0.0f, 0.0f, 0.0f);
 
-    return Vector3(zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x0010)),
-                   zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x0014)),
-                   zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x0018)));
+    return layout()->playerPosition.get();
 }
 
 void SkywardSwordFile::setPlayerPosition(float x, float y, float z)
@@ -447,9 +518,7 @@ void SkywardSwordFile::setPlayerPosition(Vector3 pos)
 {
     if (!m_data)
         return;
-    *(float*)(m_data + gameOffset() + 0x0010) = zelda::utility::swapFloat(pos.X);
-    *(float*)(m_data + gameOffset() + 0x0014) = zelda::utility::swapFloat(pos.Y);
-    *(float*)(m_data + gameOffset() + 0x0018) = zelda::utility::swapFloat(pos.Z);
+    layout()->playerPosition.set(pos);
     m_isDirty = true;
     emit modified();
 }
@@ -458,9 +527,7 @@ Vector3 SkywardSwordFile::playerRotation() const
 {
     if (!m_data)
         return Vector3(0, 0, 0);
-    return Vector3(zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x001C)),
-                   zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x0020)),
-                   zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x0024)));
+    return layout()->playerRotation.get();
 }
 
 void SkywardSwordFile::setPlayerRotation(float roll, float pitch, float yaw)
@@ -472,9 +539,7 @@ void SkywardSwordFile::setPlayerRotation(Vector3 rotation)
 {
     if (!m_data)
         return;
-    *(float*)(m_data + gameOffset() + 0x001C) = zelda::utility::swapFloat(rotation.X);
-    *(float*)(m_data + gameOffset() + 0x0020) = zelda::utility::swapFloat(rotation.Y);
-    *(float*)(m_data + gameOffset() + 0x0024) = zelda::utility::swapFloat(rotation.Z);
+    layout()->playerRotation.set(rotation);
     m_isDirty = true;
     updateChecksum();
     emit modified();
@@ -484,9 +549,7 @@ Vector3 SkywardSwordFile::cameraPosition() const
 {
     if (!m_data)
         return Vector3(0.0f, 0.0f, 0.0f);
-    return Vector3(zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x0028)),
-                   zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x002C)),
-                   zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x0030)));
+    return layout()->cameraPosition.get();
 }
 
 void SkywardSwordFile::setCameraPosition(float x, float y, float z)
@@ -498,9 +561,7 @@ void SkywardSwordFile::setCameraPosition(Vector3 pos)
 {
     if (!m_data)
         return;
-    *(float*)(m_data + gameOffset() + 0x0028) = zelda::utility::swapFloat(pos.X);
-    *(float*)(m_data + gameOffset() + 0x002C) = zelda::utility::swapFloat(pos.Y);
-    *(float*)(m_data + gameOffset() + 0x0030) = zelda::utility::swapFloat(pos.Z);
+    layout()->cameraPosition.set(pos);
     updateChecksum();
     emit modified();
 }
@@ -509,9 +570,7 @@ Vector3 SkywardSwordFile::cameraRotation() const
 {
     if (!m_data)
         return Vector3(0.0f, 0.0f, 0.0f);
-    return Vector3(zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x0034)),
-                   zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x0038)),
-                   zelda::utility::swapFloat(*(float*)(m_data + gameOffset() + 0x003C)));
+    return layout()->cameraRotation.get();
 }
 
 void SkywardSwordFile::setCameraRotation(float roll, float pitch, float yaw)
@@ -524,9 +583,7 @@ void SkywardSwordFile::setCameraRotation(Vector3 rotation)
     if (!m_data)
         return;
 
-    *(float*)(m_data + gameOffset() + 0x0034) = zelda::utility::swapFloat(rotation.X);
-    *(float*)(m_data + gameOffset() + 0x0038) = zelda::utility::swapFloat(rotation.Y);
-    *(float*)(m_data + gameOffset() + 0x003C) = zelda::utility::swapFloat(rotation.Z);
+    layout()->cameraRotation.set(rotation);
     m_isDirty = true;
     emit modified();
 }
@@ -537,11 +594,9 @@ QString SkywardSwordFile::playerName() const
         return QString("");
 
     ushort tmpName[8];
-    for (int i = 0, j=0; i < 8; ++i, j+= 2)
-    {
-        tmpName[i] = *(ushort*)(m_data + gameOffset() + (0x08D4 + j));
-        tmpName[i] = qFromBigEndian<quint16>(tmpName[i]);
-    }
+    SlotLayout* slot = layout();
+    for (int i = 0; i < 8; ++i)
+        tmpName[i] = slot->playerName[i].get();
 
     return QString(QString::fromUtf16(tmpName));
 }
@@ -551,14 +606,15 @@ void SkywardSwordFile::setPlayerName(const QString &name)
     if (!m_data)
         return;
 
-    for (int i = 0, j = 0; i < 8; ++i, ++j)
+    SlotLayout* slot = layout();
+    for (int i = 0; i < 8; ++i)
     {
         if (i > name.length())
         {
-            *(ushort*)(m_data + gameOffset() + (0x08D4 + j++)) = 0;
+            slot->playerName[i].set(0);
             continue;
         }
-        *(ushort*)(m_data + gameOffset() + (0x08D4 + j++)) = qToBigEndian<quint16>(name.utf16()[i]);
+        slot->playerName[i].set(name.utf16()[i]);
     }
     m_isDirty = true;
     this->updateChecksum();
@@ -814,14 +870,13 @@ void SkywardSwordFile::setEquipment(WeaponEquipment weapon, bool val)
 
 quint32 SkywardSwordFile::ammo(Ammo type)
 {
-    quint32 val = qFromBigEndian(*(quint32*)(m_data + gameOffset() + 0x0A60));
     quint32 ret = 0;
 
     switch(type)
     {
-        case ArrowAmmo: ret = (val >> 0)  & 127; break;
-        case BombAmmo:  ret = (val >> 7)  & 127; break;
-        case SeedAmmo:  ret = (val >> 23) & 127; break;
+        case ArrowAmmo: ret = slot().get<ArrowAmmoField>(); break;
+        case BombAmmo:  ret = slot().get<BombAmmoField>();  break;
+        case SeedAmmo:  ret = slot().get<SeedAmmoField>();  break;
     }
 
     return ret;
@@ -829,19 +884,13 @@ quint32 SkywardSwordFile::ammo(Ammo type)
 
 void SkywardSwordFile::setAmmo(Ammo type, quint32 val)
 {
-    quint32 tmp = qFromBigEndian(*(quint32*)(m_data + gameOffset() + 0x0A60));
-    quint32 arrows = (tmp >> 0)  & 127;
-    quint32 bombs  = (tmp >> 7)  & 127;
-    quint32 seeds  = (tmp >> 23) & 127;
-
     switch(type)
     {
-        case ArrowAmmo: arrows = val & 127; break;
-        case BombAmmo:  bombs  = val & 127; break;
-        case SeedAmmo:  seeds  = val & 127; break;
+        case ArrowAmmo: slot().set<ArrowAmmoField>(val); break;
+        case BombAmmo:  slot().set<BombAmmoField>(val);  break;
+        case SeedAmmo:  slot().set<SeedAmmoField>(val);  break;
     }
 
-   *(quint32*)(m_data + gameOffset() + 0x0A60) = qToBigEndian(arrows | (bombs << 7) | (seeds << 23));
     m_isDirty = true;
     this->updateChecksum();
     emit modified();
@@ -1118,16 +1167,14 @@ quint32 SkywardSwordFile::gratitudeCrystalAmount()
 {
     if (!m_data)
         return 0;
-    quint32 ret = (quint32)((qFromBigEndian<quint16>(*(quint16*)(m_data + gameOffset() + 0x0A50)) >> 3) & 127);
-    return ret;
+    return slot().get<GratitudeCrystalField>();
 }
 
 void SkywardSwordFile::setGratitudeCrystalAmount(quint16 val)
 {
     if (!m_data)
         return;
-    quint16 oldVal = qFromBigEndian<quint16>(*(quint16*)(m_data + gameOffset() + 0x0A50)) & 0xFC00;
-    *(quint16*)(m_data + gameOffset() + 0x0A50) = qToBigEndian<quint16>(oldVal | (val << 3 & 0x03FF));
+    slot().set<GratitudeCrystalField>(val);
     m_isDirty = true;
     this->updateChecksum();
     emit modified();
@@ -1138,14 +1185,14 @@ ushort SkywardSwordFile::rupees() const
     if (!m_data)
         return 0;
 
-    return qFromBigEndian<quint16>(*(ushort*)(m_data + gameOffset() + 0x0A5E));
+    return layout()->rupees.get();
 }
 
 void SkywardSwordFile::setRupees(int val)
 {
     if (!m_data)
         return;
-    *(ushort*)(m_data + gameOffset() + 0x0A5E) = qToBigEndian<quint16>((ushort)val);
+    layout()->rupees.set((quint16)val);
     m_isDirty = true;
     this->updateChecksum();
     emit modified();
@@ -1155,7 +1202,7 @@ ushort SkywardSwordFile::totalHP() const
 {
     if (!m_data)
         return 0;
-    return qToBigEndian<quint16>(*(ushort*)(m_data + gameOffset() + 0x5302));
+    return layout()->totalHP.get();
 }
 
 void SkywardSwordFile::setTotalHP(int val)
@@ -1163,7 +1210,7 @@ void SkywardSwordFile::setTotalHP(int val)
     if (!m_data)
         return;
 
-    *(ushort*)(m_data + gameOffset() + 0x5302) = qToBigEndian<quint16>((ushort)val);
+    layout()->totalHP.set((quint16)val);
     m_isDirty = true;
     emit modified();
 }
@@ -1173,7 +1220,7 @@ ushort SkywardSwordFile::unkHP() const
     if (!m_data)
         return 0;
 
-    return qFromBigEndian<quint16>(*(ushort*)(m_data + gameOffset() + 0x5304));
+    return layout()->unknownHP.get();
 }
 
 void SkywardSwordFile::setUnkHP(int val)
@@ -1181,7 +1228,7 @@ void SkywardSwordFile::setUnkHP(int val)
     if (!m_data)
         return;
 
-    *(ushort*)(m_data + gameOffset() + 0x5304) = qToBigEndian<quint16>((ushort)val);
+    layout()->unknownHP.set((quint16)val);
     m_isDirty = true;
     emit modified();
 }
@@ -1191,26 +1238,26 @@ ushort SkywardSwordFile::currentHP() const
     if (!m_data)
         return 0;
 
-    return qFromBigEndian<quint16>(*(quint16*)(m_data + gameOffset() + 0x5306));
+    return layout()->currentHP.get();
 }
 
 void SkywardSwordFile::setCurrentHP(int val)
 {
     if (!m_data)
         return;
-    *(ushort*)(m_data + gameOffset() + 0x5306) = qToBigEndian<quint16>((ushort)val);
+    layout()->currentHP.set((quint16)val);
     m_isDirty = true;
     emit modified();
 }
 
 uint SkywardSwordFile::roomID() const
 {
-    return (uint)(*(uchar*)(m_data + gameOffset() + 0x5309));
+    return layout()->roomID.get();
 }
 
 void SkywardSwordFile::setRoomID(int val)
 {
-    *(uchar*)(m_data + gameOffset() + 0x5309) = (uchar)val;
+    layout()->roomID.set((quint8)val);
     m_isDirty = true;
     this->updateChecksum();
     emit modified();
@@ -1218,12 +1265,12 @@ void SkywardSwordFile::setRoomID(int val)
 
 QString SkywardSwordFile::currentMap() const
 {
-    return readNullTermString(gameOffset() + 0x531c);
+    return readNullTermString(gameOffset() + offsetof(SlotLayout, currentMap));
 }
 
 void SkywardSwordFile::setCurrentMap(const QString& map)
 {
-    writeNullTermString(map, gameOffset() + 0x531c);
+    writeNullTermString(map, gameOffset() + offsetof(SlotLayout, currentMap));
     m_isDirty = true;
     this->updateChecksum();
     emit modified();
@@ -1231,12 +1278,12 @@ void SkywardSwordFile::setCurrentMap(const QString& map)
 
 QString SkywardSwordFile::currentArea() const
 {
-    return readNullTermString(gameOffset() + 0x533c);
+    return readNullTermString(gameOffset() + offsetof(SlotLayout, currentArea));
 }
 
 void SkywardSwordFile::setCurrentArea(const QString& map)
 {
-    writeNullTermString(map, gameOffset() + 0x533c);
+    writeNullTermString(map, gameOffset() + offsetof(SlotLayout, currentArea));
     m_isDirty = true;
     this->updateChecksum();
     emit modified();
@@ -1244,12 +1291,12 @@ void SkywardSwordFile::setCurrentArea(const QString& map)
 
 QString SkywardSwordFile::currentRoom() const // Not sure about this one
 {
-    return readNullTermString(gameOffset() + 0x535c);
+    return readNullTermString(gameOffset() + offsetof(SlotLayout, currentRoom));
 }
 
 void SkywardSwordFile::setCurrentRoom(const QString& map) // Not sure about this one
 {
-    writeNullTermString(map, gameOffset() + 0x535c);
+    writeNullTermString(map, gameOffset() + offsetof(SlotLayout, currentRoom));
     m_isDirty = true;
     this->updateChecksum();
     emit modified();
@@ -1266,24 +1313,53 @@ void SkywardSwordFile::setGameData(const QByteArray &data)
 QByteArray SkywardSwordFile::gameData()
 {
     if (!m_data)
-        return QByteArray(0x53C0, 0);
+        return QByteArray(SlotLayout::SIZE, 0);
+
+    return QByteArray(m_data + gameOffset(), SlotLayout::SIZE);
+}
+
+SlotLayout SkywardSwordFile::slotLayout() const
+{
+    SlotLayout slot;
+    if (!m_data)
+        slot.clear();
+    else
+        slot = *layout();
+    return slot;
+}
+
+void SkywardSwordFile::setSlotLayout(const SlotLayout& slot)
+{
+    if (!m_data)
+        return;
+
+    *layout() = slot;
+    m_isDirty = true;
+    this->updateChecksum();
+    emit modified();
+}
+
+QByteArray SkywardSwordFile::fileData() const
+{
+    if (!m_data)
+        return QByteArray();
 
-    return QByteArray(m_data + gameOffset(), 0x53C0);
+    return QByteArray(m_data, SaveLayout::SIZE);
 }
 
 quint8* SkywardSwordFile::skipData() const
 {
     if (!m_data)
         return NULL;
-    quint8* skip = new quint8[0x80];
-    memcpy(skip, (m_data + 0x20 + (0x53C0 * 3)), 0x80);
+    quint8* skip = new quint8[SaveLayout::SKIP_SIZE];
+    memcpy(skip, m_data + SaveLayout::SKIP_OFFSET, SaveLayout::SKIP_SIZE);
 
     return skip;
 }
 
 void SkywardSwordFile::setSkipData(const quint8 *data)
 {
-    memcpy((m_data + 0x20 + (0x53C0 * 3)), data, 0x80);
+    memcpy(m_data + SaveLayout::SKIP_OFFSET, data, SaveLayout::SKIP_SIZE);
     m_isDirty = true;
     emit modified();
 }
@@ -1293,7 +1369,7 @@ uint SkywardSwordFile::checksum() const
     if (!m_data)
         return 0;
 
-    return qFromBigEndian<quint32>(*(quint32*)(m_data + gameOffset() + 0x53bc));
+    return layout()->checksum.get();
 }
 
 uint SkywardSwordFile::gameOffset() const
@@ -1301,7 +1377,17 @@ uint SkywardSwordFile::gameOffset() const
     if (!m_data)
         return 0;
 
-    return (0x20 + (0x53C0 * m_game));
+    return (0x20 + (SlotLayout::SIZE * m_game));
+}
+
+BEView SkywardSwordFile::slot() const
+{
+    return BEView(m_data + gameOffset());
+}
+
+SlotLayout* SkywardSwordFile::layout() const
+{
+    return (SlotLayout*)(m_data + gameOffset());
 }
 
 void SkywardSwordFile::updateChecksum()
@@ -1309,10 +1395,14 @@ void SkywardSwordFile::updateChecksum()
     if (!m_data)
         return;
 
-    quint32 checksum = m_checksumEngine.CRC32((const unsigned char*)m_data, gameOffset(), 0x53BC);
+    quint32 checksum;
+    {
+        TRACE_PHASE_SCOPE("SkywardSwordFile::updateChecksum", ChecksumPhase);
+        checksum = m_checksumEngine.CRC32((const unsigned char*)m_data, gameOffset(), offsetof(SlotLayout, checksum));
+    }
     if (this->checksum() != checksum)
     {
-        *(uint*)(m_data + gameOffset() + 0x53BC) =  qToBigEndian<quint32>(checksum); // change it to Big Endian
+        layout()->checksum.set(checksum);
         emit checksumUpdated();
     }
 }
@@ -1322,12 +1412,12 @@ bool SkywardSwordFile::isNew() const
     if (!m_data)
         return true;
 
-    return (*(char*)(m_data + gameOffset() + 0x53AD)) != 0;
+    return layout()->newGame.get() != 0;
 }
 
 void SkywardSwordFile::setNew(bool val)
 {
-    *(char*)(m_data + gameOffset() + 0x53AD) = val;
+    layout()->newGame.set(val);
     m_isDirty = true;
     emit modified();
 }
@@ -1398,6 +1488,22 @@ void SkywardSwordFile::setFlag(quint32 offset, quint32 flag, bool val)
 
 bool SkywardSwordFile::isValidFile(const QString &filepath, Region* outRegion)
 {
+    // For a data.bin only the file table is read, nothing is decrypted
+    if (filepath.endsWith(".bin"))
+    {
+        DataBinReader reader(filepath);
+        if (!reader.open())
+            return false;
+
+        int index = reader.indexOf("wiiking2.sav");
+        QByteArray gameId = reader.gameId().toLatin1();
+        if (index < 0 || reader.files()[index].Size != SaveLayout::SIZE || gameId.size() != 4)
+            return false;
+
+        Region region = (Region)qFromLittleEndian<quint32>((const uchar*)gameId.constData());
+        *outRegion = region;
+        return (region == NTSCURegion || region == NTSCJRegion || region == PALRegion);
+    }
 
     FILE* file = fopen(filepath.toStdString().c_str(), "rb");
     if (!file)
@@ -1409,7 +1515,7 @@ bool SkywardSwordFile::isValidFile(const QString &filepath, Region* outRegion)
     quint32 size = ftell(file);
     fclose(file);
     *outRegion = region;
-    return (region == NTSCURegion || region == NTSCJRegion || region == PALRegion) && size == 0xFBE0;
+    return (region == NTSCURegion || region == NTSCJRegion || region == PALRegion) && size == SaveLayout::SIZE;
 }
 
 // SLOTS
@@ -1822,15 +1928,7 @@ quint32 SkywardSwordFile::quantity(bool isRight, int offset) const
 {
     if (!m_data)
         return 0;
-    switch(isRight)
-    {
-        case false:
-            return (quint32)(qFromBigEndian<quint16>((*(quint16*)(m_data + gameOffset() + offset))) >> 7) & 127;
-        case true:
-            return (quint32)(qFromBigEndian<quint16>(*(quint16*)(m_data + gameOffset() + offset))) & 127;
-    }
-
-    return 0;
+    return slot().packed7(offset, !isRight);
 }
 
 void SkywardSwordFile::setQuantity(bool isRight, int offset, quint32 val)
@@ -1838,36 +1936,18 @@ void SkywardSwordFile::setQuantity(bool isRight, int offset, quint32 val)
     if (!m_data)
         return;
 
-    quint16 oldVal = qFromBigEndian<quint16>(*(quint16*)(m_data + gameOffset() + offset));
-    switch(isRight)
-    {
-        case false:
-        {
-            quint16 newVal = (oldVal&127)|(((quint16)val << 7));
-            *(quint16*)(m_data + gameOffset() + offset) = qToBigEndian<quint16>(newVal);
-        }
-        break;
-        case true:
-        {
-            oldVal = (oldVal >> 7) & 127;
-            quint16 newVal = (val|(oldVal << 7));
-            *(quint16*)(m_data + gameOffset() + offset) = qToBigEndian<quint16>(newVal);
-        }
-        break;
-    }
+    slot().setPacked7(offset, !isRight, val);
 }
 
 bool SkywardSwordFile::isNight() const
 {
-    return (*(quint8*)(m_data + gameOffset() + 0x53B3) & 0x01) == 0x01;
+    return (layout()->night.get() & 0x01) == 0x01;
 }
 
 void SkywardSwordFile::setNight(const bool val)
 {
-    if (val)
-        *(quint8*)(m_data + gameOffset() + 0x53B3) |= 0x01;
-    else
-        *(quint8*)(m_data + gameOffset() + 0x53B3) &= ~0x01;
+    quint8 night = layout()->night.get();
+    layout()->night.set(val ? (night | 0x01) : (night & ~0x01));
 
     this->updateChecksum();
     emit modified();
@@ -1886,10 +1966,12 @@ void SkywardSwordFile::setData(char *data)
 
 bool SkywardSwordFile::loadDataBin(const QString& filepath, Game game)
 {
+    TRACE_SCOPE("SkywardSwordFile::loadDataBin");
     if (!filepath.isEmpty())
         m_filename = filepath;
 
     m_isDirty = false;
+    m_lastError.clear();
     try
     {
         if (m_saveGame != NULL)
@@ -1899,10 +1981,68 @@ bool SkywardSwordFile::loadDataBin(const QString& filepath, Game game)
         }
 
         if (m_data != NULL)
-            delete m_data;
+        {
+            delete[] m_data;
+            m_data = NULL;
+        }
+
+        m_dataBinImage.clear();
+        m_dataBinBanner = DataBinReader::Banner();
+        {
+            TRACE_PHASE_SCOPE("SkywardSwordFile::loadDataBin read", IoPhase);
+            QFile image(m_filename);
+            if (image.open(QFile::ReadOnly))
+                m_dataBinImage = image.readAll();
+        }
+
+        // The file is only read once, DataBinReader decodes the image in
+        // memory and decrypts nothing but the banner and wiiking2.sav
+        QByteArray saveData;
+        DataBinReader::Banner banner;
+        {
+            TRACE_PHASE_SCOPE("SkywardSwordFile::loadDataBin decrypt", CryptoPhase);
+            QBuffer buffer(&m_dataBinImage);
+            buffer.open(QIODevice::ReadOnly);
+            DataBinReader reader(&buffer);
+            if (reader.open())
+            {
+                quint32 region = qFromLittleEndian<quint32>((const uchar*)reader.gameId().toLatin1().constData());
+                if (region != SkywardSwordFile::NTSCURegion && region != SkywardSwordFile::NTSCJRegion && region != SkywardSwordFile::PALRegion)
+                {
+                    m_isOpen = false;
+                    m_game = IGameFile::GameNone;
+                    m_lastError = tr("The Wii save is not a Skyward Sword save");
+                    return false;
+                }
+                if (reader.indexOf("wiiking2.sav") < 0)
+                {
+                    m_game = IGameFile::GameNone;
+                    m_isOpen = false;
+                    m_lastError = tr("The Wii save does not contain wiiking2.sav");
+                    return false;
+                }
+                if (reader.readBanner(&banner))
+                    saveData = reader.readFile("wiiking2.sav");
+            }
+        }
+
+        if (saveData.size() == SaveLayout::SIZE)
+        {
+            m_dataBinBanner = banner;
+            m_data = new char[SaveLayout::SIZE];
+            memcpy(m_data, saveData.constData(), SaveLayout::SIZE);
+            updateChecksum();
+            m_game = game;
+            m_isOpen = true;
+            return true;
+        }
 
-        zelda::io::WiiSaveReader reader(m_filename.toStdString());
-        m_saveGame = reader.readSave();
+        // Layouts DataBinReader does not know are left to libzelda
+        {
+            TRACE_PHASE_SCOPE("SkywardSwordFile::loadDataBin decrypt", CryptoPhase);
+            zelda::io::WiiSaveReader reader(m_filename.toStdString());
+            m_saveGame = reader.readSave();
+        }
 
         char gameId[5];
         int tmp = (int)m_saveGame->banner()->gameID() & 0xFFFFFFFF;
@@ -1917,6 +2057,7 @@ bool SkywardSwordFile::loadDataBin(const QString& filepath, Game game)
             {
                 m_game = IGameFile::GameNone;
                 m_isOpen = false;
+                m_lastError = tr("The Wii save does not contain wiiking2.sav");
                 return false;
             }
 
@@ -1930,18 +2071,17 @@ bool SkywardSwordFile::loadDataBin(const QString& filepath, Game game)
         {
             m_isOpen = false;
             m_game = IGameFile::GameNone;
+            m_lastError = tr("The Wii save is not a Skyward Sword save");
             return false;
         }
     }
     catch (zelda::error::Exception e)
     {
-        QMessageBox msg(QMessageBox::Warning, "Error loading file", e.message().c_str());
-        msg.exec();
+        m_lastError = QString::fromStdString(e.message());
     }
     catch (std::string what)
     {
-        QMessageBox msg(QMessageBox::Warning, "Error loading file", what.c_str());
-        msg.exec();
+        m_lastError = QString::fromStdString(what);
     }
 
     return false;
@@ -1949,120 +2089,200 @@ bool SkywardSwordFile::loadDataBin(const QString& filepath, Game game)
 
 bool SkywardSwordFile::saveDataBin()
 {
+    TRACE_SCOPE("SkywardSwordFile::saveDataBin");
     if (!WiiKeys::instance()->isOpen() || !WiiKeys::instance()->isValid())
     {
-        QMessageBox msg(QMessageBox::Warning, "Invalid or Missing Keys", "Required keys are either missing or invalid\nPlease check:\nEdit->Preferences\nTo ensure you have valid keys.");
-        msg.exec();
+        m_lastError = tr("Required keys are either missing or invalid\nPlease check:\nEdit->Preferences\nTo ensure you have valid keys.");
         return false;
     }
 
-    m_isDirty = false;
-    if (m_saveGame != NULL)
+    // A new save starts out as the prebuilt image for its region
+    if (m_saveGame == NULL && m_dataBinImage.isEmpty())
     {
-        //qDebug() << "Changing wiiking2.sav data";
-        //WiiFile* wiiking2 = m_saveGame->getFile("/wiiking2.sav");
-        //wiiking2->setData((unsigned char*)m_data);
-        qDebug() << "Done saving to" << m_filename;
-        zelda::io::WiiSaveWriter writer(m_filename.toStdString());
-        writer.writeSave(m_saveGame, (quint8*)WiiKeys::instance()->macAddr().data(), WiiKeys::instance()->NGID(),(quint8*)WiiKeys::instance()->NGPriv().data(), (quint8*)WiiKeys::instance()->NGSig().data(), WiiKeys::instance()->NGKeyID());
+        m_dataBinImage = dataBinTemplate(region(), &m_lastError);
+        if (m_dataBinImage.isEmpty())
+            return false;
+    }
+
+    if (writeSignedDataBin())
+    {
+        m_isDirty = false;
         return true;
     }
-    else
+
+    // The image was understood but could not be written
+    if (!m_lastError.isEmpty())
+        return false;
+
+    if (m_saveGame == NULL)
     {
-        m_saveGame = new zelda::WiiSave();
-        int r = region();
-        char gameId[5];
-        memset(gameId, 0, 5);
-        memcpy(gameId, (char*)&r, 4);
-        qDebug() << "Attempting to load embedded banner.tpl";
-        QFile banner(":/BannerData/banner.tpl");
-        if (banner.open(QFile::ReadOnly))
-        {
-            QDataStream dataStream(&banner);
-            char* bannerData = new char[192*168*2];
-            dataStream.readRawData(bannerData, 192*168*2);
-            banner.close();
-            zelda::WiiBanner* wiiBanner = NULL;
-
-            wiiBanner = new zelda::WiiBanner();
-            wiiBanner->setBannerImage(new zelda::WiiImage(192, 64, (quint8*)bannerData));
-            quint64 titleId = 0x00010000;
-            quint64 fullId = ((quint64)r << 32)  | qToBigEndian(titleId) >> 32;
-            wiiBanner->setGameID(qFromBigEndian(fullId));
-
-            qDebug() << "Got Banner.tpl";
-            qDebug() << "Attempting to load embedded icon.tpl";
-            QFile icon(":/BannerData/icon.tpl");
-            if (icon.open(QFile::ReadOnly))
-            {
-                QDataStream dataStream(&icon);
-                quint8* iconData = new quint8[48*48*2];
-                dataStream.readRawData((char*)iconData, 48*48*2);
-                icon.close();
-                wiiBanner->addIcon(new zelda::WiiImage(48, 48, iconData));
-                qDebug() << "Got icon.tpl";
-            }
-            else
-            {
-                qWarning() << "Failed to load icon.tpl bailing out!";
-                delete wiiBanner;
-                wiiBanner = NULL;
-                delete m_saveGame;
-                m_saveGame = NULL;
-                return false;
-            }
+        m_lastError = tr("Unable to write %1").arg(m_filename);
+        return false;
+    }
 
-            QFile title(QString(":/BannerData/%1/title.bin").arg(gameId));
-            if (title.open(QFile::ReadOnly))
-            {
-                QString titleString = QString::fromUtf16((ushort*)title.readAll().data());
-                wiiBanner->setTitle(titleString.toUtf8().data());
-                title.close();
-            }
-            else
-            {
-                delete wiiBanner;
-                wiiBanner = NULL;
-                delete m_saveGame;
-                m_saveGame = NULL;
-                return false;
-            }
+    //qDebug() << "Changing wiiking2.sav data";
+    //WiiFile* wiiking2 = m_saveGame->getFile("/wiiking2.sav");
+    //wiiking2->setData((unsigned char*)m_data);
+    zelda::io::WiiSaveWriter writer(m_filename.toStdString());
+    writer.writeSave(m_saveGame, (quint8*)WiiKeys::instance()->macAddr().data(), WiiKeys::instance()->NGID(),(quint8*)WiiKeys::instance()->NGPriv().data(), (quint8*)WiiKeys::instance()->NGSig().data(), WiiKeys::instance()->NGKeyID());
+    qDebug() << "Done saving to" << m_filename;
+    m_isDirty = false;
+    return true;
+}
 
-            title.setFileName(QString(":/BannerData/%1/subtitle.bin").arg(gameId));
-            if (title.open(QFile::ReadOnly))
-            {
-                QString titleString = QString::fromUtf16((ushort*)title.readAll().data());
-                wiiBanner->setSubtitle(titleString.toUtf8().data());
-                title.close();
-            }
-            else
-            {
-                delete wiiBanner;
-                wiiBanner = NULL;
-                delete m_saveGame;
-                m_saveGame = NULL;
-                return false;
-            }
+// Building a data.bin from scratch means loading the banner and icon,
+// converting the titles and running WiiSaveWriter. The result only depends
+// on the region, so it is done once per region and the image is reused byte
+// for byte; writeSignedDataBin() patches the save data in.
+QByteArray SkywardSwordFile::dataBinTemplate(Region region, QString* error)
+{
+    static QMutex mutex;
+    static QHash<quint32, QByteArray> templates;
 
-            wiiBanner->setPermissions(zelda::WiiFile::GroupRW | zelda::WiiFile::OwnerRW);
-            wiiBanner->setAnimationSpeed(0); // no animations
-            m_saveGame->setBanner(wiiBanner);
-            m_saveGame->addFile("/wiiking2.sav", new zelda::WiiFile("wiiking2.sav", zelda::WiiFile::GroupRW | zelda::WiiFile::OwnerRW, (quint8*)m_data, 0xFBE0));
-            m_saveGame->addFile("/skip.dat", new zelda::WiiFile("skip.dat", zelda::WiiFile::GroupRW | zelda::WiiFile::OwnerRW, skipData(), 0x80));
-            zelda::io::WiiSaveWriter writer(m_filename.toStdString());
-            writer.writeSave(m_saveGame, (quint8*)WiiKeys::instance()->macAddr().data(), WiiKeys::instance()->NGID(),(quint8*)WiiKeys::instance()->NGPriv().data(), (quint8*)WiiKeys::instance()->NGSig().data(), WiiKeys::instance()->NGKeyID());
-            delete m_saveGame;
-            m_saveGame = NULL;
-            return true;
-        }
-        else
-        {
-            delete m_saveGame;
-            m_saveGame = NULL;
+    QMutexLocker locker(&mutex);
+    if (!templates.contains(region))
+    {
+        QByteArray image = buildDataBinTemplate(region, error);
+        if (image.isEmpty())
+            return image;
+        templates.insert(region, image);
+    }
+    return templates.value(region);
+}
+
+QByteArray SkywardSwordFile::buildDataBinTemplate(Region region, QString* error)
+{
+    TRACE_SCOPE("SkywardSwordFile::buildDataBinTemplate");
+    char gameId[5];
+    memset(gameId, 0, 5);
+    memcpy(gameId, (char*)&region, 4);
+
+    QFile banner(":/BannerData/banner.tpl");
+    QFile icon(":/BannerData/icon.tpl");
+    QFile title(QString(":/BannerData/%1/title.bin").arg(gameId));
+    QFile subtitle(QString(":/BannerData/%1/subtitle.bin").arg(gameId));
+    if (!banner.open(QFile::ReadOnly) || !icon.open(QFile::ReadOnly) ||
+        !title.open(QFile::ReadOnly) || !subtitle.open(QFile::ReadOnly))
+    {
+        *error = tr("The banner data for %1 is missing").arg(gameId);
+        return QByteArray();
+    }
+
+    QByteArray bannerTpl = banner.read(192*64*2);
+    QByteArray iconTpl = icon.read(48*48*2);
+    QByteArray titleData = title.readAll();
+    QByteArray subtitleData = subtitle.readAll();
+    if (bannerTpl.size() != 192*64*2 || iconTpl.size() != 48*48*2)
+    {
+        *error = tr("The banner data for %1 is damaged").arg(gameId);
+        return QByteArray();
+    }
+
+    QTemporaryFile file;
+    if (!file.open())
+    {
+        *error = tr("Unable to create a temporary file");
+        return QByteArray();
+    }
+    file.close();
+
+    // The images and files are owned by the save once added
+    zelda::WiiSave save;
+    zelda::WiiBanner* wiiBanner = new zelda::WiiBanner();
+    quint8* bannerData = new quint8[bannerTpl.size()];
+    memcpy(bannerData, bannerTpl.constData(), bannerTpl.size());
+    wiiBanner->setBannerImage(new zelda::WiiImage(192, 64, bannerData));
+    quint8* iconData = new quint8[iconTpl.size()];
+    memcpy(iconData, iconTpl.constData(), iconTpl.size());
+    wiiBanner->addIcon(new zelda::WiiImage(48, 48, iconData));
+
+    quint64 titleId = 0x00010000;
+    quint64 fullId = ((quint64)region << 32)  | qToBigEndian(titleId) >> 32;
+    wiiBanner->setGameID(qFromBigEndian(fullId));
+    wiiBanner->setTitle(QString::fromUtf16((const ushort*)titleData.constData(), titleData.size() / 2).section(QChar(0), 0, 0).toUtf8().data());
+    wiiBanner->setSubtitle(QString::fromUtf16((const ushort*)subtitleData.constData(), subtitleData.size() / 2).section(QChar(0), 0, 0).toUtf8().data());
+    wiiBanner->setPermissions(zelda::WiiFile::GroupRW | zelda::WiiFile::OwnerRW);
+    wiiBanner->setAnimationSpeed(0); // no animations
+    save.setBanner(wiiBanner);
+
+    // Placeholders, writeSignedDataBin() replaces both
+    quint8* saveData = new quint8[SaveLayout::SIZE];
+    memset(saveData, 0, SaveLayout::SIZE);
+    memcpy(saveData, &region, 4);
+    quint8* skip = new quint8[0x80];
+    memset(skip, 0, 0x80);
+    save.addFile("/wiiking2.sav", new zelda::WiiFile("wiiking2.sav", zelda::WiiFile::GroupRW | zelda::WiiFile::OwnerRW, saveData, SaveLayout::SIZE));
+    save.addFile("/skip.dat", new zelda::WiiFile("skip.dat", zelda::WiiFile::GroupRW | zelda::WiiFile::OwnerRW, skip, 0x80));
+
+    try
+    {
+        zelda::io::WiiSaveWriter writer(file.fileName().toStdString());
+        writer.writeSave(&save, (quint8*)WiiKeys::instance()->macAddr().data(), WiiKeys::instance()->NGID(),(quint8*)WiiKeys::instance()->NGPriv().data(), (quint8*)WiiKeys::instance()->NGSig().data(), WiiKeys::instance()->NGKeyID());
+    }
+    catch (zelda::error::Exception e)
+    {
+        *error = QString::fromStdString(e.message());
+        return QByteArray();
+    }
+
+    if (!file.open())
+    {
+        *error = tr("Unable to read the data.bin template");
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+// Patches wiiking2.sav and skip.dat into the data.bin that was loaded, or
+// the template for a new save, and signs it with the cached context for the
+// current keys. Only those two payloads are encrypted again, the banner and
+// every other file stay as they were. Returns false without writing anything if the
+// image does not have the expected layout, the caller then falls back to
+// WiiSaveWriter, or with m_lastError set if writing the file failed.
+bool SkywardSwordFile::writeSignedDataBin()
+{
+    if (m_dataBinImage.isEmpty())
+        return false;
+
+    QByteArray image = m_dataBinImage;
+    {
+        TRACE_PHASE_SCOPE("SkywardSwordFile::writeSignedDataBin encrypt", CryptoPhase);
+        // The file table is in the clear, reading it decrypts nothing
+        QBuffer buffer(&m_dataBinImage);
+        buffer.open(QIODevice::ReadOnly);
+        DataBinReader reader(&buffer);
+        if (!reader.open())
+            return false;
+        int save = reader.indexOf("wiiking2.sav");
+        int skip = reader.indexOf("skip.dat");
+        if (save < 0)
+            return false;
+
+        DataBinCodec codec;
+        if (!codec.replaceEncryptedFile(image, reader.files()[save], QByteArray::fromRawData(m_data, SaveLayout::SIZE)))
+            return false;
+        if (skip >= 0)
+            codec.replaceEncryptedFile(image, reader.files()[skip], QByteArray::fromRawData(m_data + SaveLayout::SKIP_OFFSET, SaveLayout::SKIP_SIZE));
+
+        WiiKeys* keys = WiiKeys::instance();
+        QSharedPointer<const SigningContext> context =
+                SigningContext::cached(keys->NGID(), keys->NGKeyID(), keys->NGPriv(), keys->NGSig(), keys->macAddr());
+        if (!context->signDataBin(image))
             return false;
-        }
     }
-    return false;
+
+    // Written to a temporary file and moved over the old one, a failed
+    // write leaves the user's data.bin as it was
+    TRACE_PHASE_SCOPE("SkywardSwordFile::writeSignedDataBin write", IoPhase);
+    if (!DataBinResigner::writeFile(m_filename, image, &m_lastError))
+        return false;
+    m_dataBinImage = image;
+    return true;
+}
+
+QString SkywardSwordFile::lastError() const
+{
+    return m_lastError;
 }
 
 QString SkywardSwordFile::bannerTitle() const
@@ -2071,6 +2291,8 @@ QString SkywardSwordFile::bannerTitle() const
     {
         return QString::fromUtf8(m_saveGame->banner()->title().c_str());
     }
+    if (!m_dataBinBanner.Image.isEmpty())
+        return m_dataBinBanner.Title;
 
     int r = region();
     char gameId[5];
@@ -2093,6 +2315,8 @@ QString SkywardSwordFile::bannerSubtitle() const
     {
         return QString::fromUtf8(m_saveGame->banner()->subtitle().c_str());
     }
+    if (!m_dataBinBanner.Image.isEmpty())
+        return m_dataBinBanner.Subtitle;
 
     int r = region();
     char gameId[5];
@@ -2111,6 +2335,9 @@ QString SkywardSwordFile::bannerSubtitle() const
 
 const QIcon SkywardSwordFile::icon() const
 {
+    if (!m_saveGame && !m_dataBinBanner.Icons.isEmpty())
+        return QIcon(QPixmap::fromImage(convertTextureToImage(m_dataBinBanner.Icons[0], DataBinReader::ICON_WIDTH, DataBinReader::ICON_HEIGHT)));
+
     if (!m_saveGame)
     {
         QFile icon(":/BannerData/icon.tpl");
@@ -2137,6 +2364,9 @@ const QIcon SkywardSwordFile::icon() const
 
 const QPixmap SkywardSwordFile::banner() const
 {
+    if (!m_saveGame && !m_dataBinBanner.Image.isEmpty())
+        return QPixmap::fromImage(convertTextureToImage(m_dataBinBanner.Image, DataBinReader::BANNER_WIDTH, DataBinReader::BANNER_HEIGHT));
+
     if (!m_saveGame)
     {
         QFile banner(":/BannerData/banner.tpl");
@@ -2161,8 +2391,3 @@ const QPixmap SkywardSwordFile::banner() const
     return QPixmap::fromImage(ret);
 }
 
-// To support MSVC I have placed these here, why can't Microsoft follow real ANSI Standards? <.<
-const float SkywardSwordFile::DEFAULT_POS_X = -4798.150391f;
-const float SkywardSwordFile::DEFAULT_POS_Y =  1237.629517f;
-const float SkywardSwordFile::DEFAULT_POS_Z = -6573.722656f;
-
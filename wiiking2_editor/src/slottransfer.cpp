@@ -0,0 +1,106 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "slottransfer.h"
+#include "checksum.h"
+
+#include <string.h>
+
+bool SlotTransfer::isValid(int index)
+{
+    return index >= 0 && index < SLOT_COUNT;
+}
+
+SlotLayout* SlotTransfer::slot(char* save, int index)
+{
+    return (SlotLayout*)(save + SLOT_OFFSET + SlotLayout::SIZE * index);
+}
+
+const SlotLayout* SlotTransfer::slot(const char* save, int index)
+{
+    return (const SlotLayout*)(save + SLOT_OFFSET + SlotLayout::SIZE * index);
+}
+
+bool SlotTransfer::isNew(const char* save, int index)
+{
+    return isValid(index) && slot(save, index)->newGame.get() != 0;
+}
+
+bool SlotTransfer::copy(const char* source, int from, char* target, int to)
+{
+    if (!isValid(from) || !isValid(to))
+        return false;
+
+    const SlotLayout* src = slot(source, from);
+    SlotLayout* dst = slot(target, to);
+    if (src != dst)
+        *dst = *src;
+    return true;
+}
+
+bool SlotTransfer::move(char* source, int from, char* target, int to)
+{
+    if (!copy(source, from, target, to))
+        return false;
+
+    if (slot(source, from) != slot(target, to))
+        clear(source, from);
+    return true;
+}
+
+bool SlotTransfer::swap(char* save, int first, int second)
+{
+    if (!isValid(first) || !isValid(second))
+        return false;
+
+    if (first != second)
+    {
+        SlotLayout tmp = *slot(save, first);
+        *slot(save, first) = *slot(save, second);
+        *slot(save, second) = tmp;
+    }
+    return true;
+}
+
+int SlotTransfer::duplicate(char* save, int from)
+{
+    if (!isValid(from))
+        return -1;
+
+    for (int i = 0; i < SLOT_COUNT; i++)
+    {
+        if (i != from && isNew(save, i))
+        {
+            copy(save, from, save, i);
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool SlotTransfer::clear(char* save, int index)
+{
+    if (!isValid(index))
+        return false;
+
+    SlotLayout* empty = slot(save, index);
+    memset(empty, 0, offsetof(SlotLayout, checksum));
+    empty->newGame.set(1);
+
+    Checksum checksum;
+    empty->checksum.set(checksum.CRC32((const quint8*)save, SLOT_OFFSET + SlotLayout::SIZE * index,
+                                       offsetof(SlotLayout, checksum)));
+    return true;
+}
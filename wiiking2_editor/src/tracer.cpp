@@ -0,0 +1,288 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "tracer.h"
+
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QThreadStorage>
+#include <QVector>
+
+struct TraceEvent
+{
+    const char* Name;
+    qint64      Start;      //!< ns since the clock started
+    qint64      Duration;
+    int         Thread;
+};
+
+// Head counts the events ever written to the ring, modulo 2^32. Only the
+// recording thread writes, it fills the next event and then publishes it
+// by storing Written into Head.
+struct TraceRing
+{
+    TraceEvent Events[Tracer::RING_SIZE];
+    quint32    Written;     //!< Only touched by the recording thread
+    QAtomicInt Head;
+    quint32    Tail;        //!< Where clear() cut off, under the registry mutex
+    int        Thread;
+    bool       InUse;       //!< Under the registry mutex
+};
+
+// Rings outlive their threads so a dump still has their events, a ring is
+// handed to the next new thread once its own has finished.
+struct TraceRegistry
+{
+    QMutex              Mutex;
+    QList<TraceRing*>   Rings;
+    QHash<int, QString> ThreadNames;
+    int                 ThreadCount;
+
+    TraceRegistry() : ThreadCount(0) {}
+};
+
+struct TraceClock
+{
+    QElapsedTimer Timer;
+
+    TraceClock() { Timer.start(); }
+};
+
+// Hands the ring back when its thread finishes
+struct TraceRingRef
+{
+    TraceRing* Ring;
+
+    ~TraceRingRef();
+};
+
+// A stale read of the flag only records or drops a few events
+static bool enabledFlag = false;
+static const TraceClock CLOCK;
+static QThreadStorage<TraceRingRef*> localRing;
+
+// Never deleted, threads may finish after static destruction has started
+static TraceRegistry* registry()
+{
+    static TraceRegistry* instance = new TraceRegistry;
+    return instance;
+}
+
+TraceRingRef::~TraceRingRef()
+{
+    QMutexLocker locker(&registry()->Mutex);
+    Ring->InUse = false;
+}
+
+static TraceRing* threadRing()
+{
+    if (localRing.hasLocalData())
+        return localRing.localData()->Ring;
+
+    TraceRegistry* reg = registry();
+    QMutexLocker locker(&reg->Mutex);
+    TraceRing* ring = NULL;
+    foreach (TraceRing* r, reg->Rings)
+    {
+        if (!r->InUse)
+        {
+            ring = r;
+            break;
+        }
+    }
+    if (!ring)
+    {
+        ring = new TraceRing;
+        ring->Written = 0;
+        ring->Tail = 0;
+        reg->Rings << ring;
+    }
+    ring->InUse = true;
+    ring->Thread = ++reg->ThreadCount;
+
+    QThread* thread = QThread::currentThread();
+    QCoreApplication* app = QCoreApplication::instance();
+    if (app && thread == app->thread())
+        reg->ThreadNames[ring->Thread] = "main";
+    else
+        reg->ThreadNames[ring->Thread] = QString("%1 %2")
+                .arg(thread->objectName().isEmpty() ? QString("thread") : thread->objectName())
+                .arg(ring->Thread);
+
+    TraceRingRef* ref = new TraceRingRef;
+    ref->Ring = ring;
+    localRing.setLocalData(ref);
+    return ring;
+}
+
+static quint32 ringHead(TraceRing* ring)
+{
+    return quint32(ring->Head.fetchAndAddAcquire(0));
+}
+
+// Events still in the ring, the newest RING_SIZE at most
+static quint32 ringCount(TraceRing* ring, quint32 head)
+{
+    return qMin(head - ring->Tail, quint32(Tracer::RING_SIZE));
+}
+
+// Copies the events of every ring. An event older than the newest
+// RING_SIZE - 1 after copying may have been overwritten while it was
+// copied, those are left out.
+static QVector<TraceEvent> snapshot(QHash<int, QString>* threadNames)
+{
+    TraceRegistry* reg = registry();
+    QMutexLocker locker(&reg->Mutex);
+    QVector<TraceEvent> events;
+    foreach (TraceRing* ring, reg->Rings)
+    {
+        quint32 head = ringHead(ring);
+        quint32 first = head - ringCount(ring, head);
+        QVector<TraceEvent> copy;
+        copy.reserve(head - first);
+        for (quint32 i = first; i != head; i++)
+            copy << ring->Events[i % Tracer::RING_SIZE];
+
+        qint32 overwritten = qint32(ringHead(ring) - (Tracer::RING_SIZE - 1) - first);
+        for (int i = qMax(overwritten, 0); i < copy.size(); i++)
+            events << copy[i];
+    }
+    *threadNames = reg->ThreadNames;
+    return events;
+}
+
+static QByteArray jsonString(const QString& str)
+{
+    QByteArray result("\"");
+    foreach (char c, str.toUtf8())
+    {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        if (uchar(c) >= 0x20)
+            result += c;
+    }
+    return result + "\"";
+}
+
+Tracer::Tracer(const char* name) :
+    m_name(name),
+    m_phase(PhaseTimer::PhaseCount),
+    m_recording(enabledFlag),
+    m_start(m_recording ? CLOCK.Timer.nsecsElapsed() : -1)
+{
+}
+
+Tracer::Tracer(const char* name, PhaseTimer::Phase phase) :
+    m_name(name),
+    m_phase(PhaseTimer::isEnabled() ? phase : PhaseTimer::PhaseCount),
+    m_recording(enabledFlag),
+    m_start(m_recording || m_phase != PhaseTimer::PhaseCount ? CLOCK.Timer.nsecsElapsed() : -1)
+{
+}
+
+Tracer::~Tracer()
+{
+    if (m_start < 0)
+        return;
+
+    qint64 end = CLOCK.Timer.nsecsElapsed();
+    if (m_phase != PhaseTimer::PhaseCount)
+        PhaseTimer::add(m_phase, end - m_start);
+    if (!m_recording)
+        return;
+
+    TraceRing* ring = threadRing();
+    TraceEvent& event = ring->Events[ring->Written % RING_SIZE];
+    event.Name = m_name;
+    event.Start = m_start;
+    event.Duration = end - m_start;
+    event.Thread = ring->Thread;
+    ring->Written++;
+    ring->Head.fetchAndStoreRelease(int(ring->Written));
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    enabledFlag = enabled;
+}
+
+bool Tracer::isEnabled()
+{
+    return enabledFlag;
+}
+
+void Tracer::clear()
+{
+    TraceRegistry* reg = registry();
+    QMutexLocker locker(&reg->Mutex);
+    foreach (TraceRing* ring, reg->Rings)
+        ring->Tail = ringHead(ring);
+}
+
+int Tracer::eventCount()
+{
+    TraceRegistry* reg = registry();
+    QMutexLocker locker(&reg->Mutex);
+    int count = 0;
+    foreach (TraceRing* ring, reg->Rings)
+        count += ringCount(ring, ringHead(ring));
+    return count;
+}
+
+bool Tracer::writeChromeTrace(QIODevice* device)
+{
+    QHash<int, QString> threadNames;
+    QVector<TraceEvent> events = snapshot(&threadNames);
+    long long pid = QCoreApplication::applicationPid();
+
+    // ts and dur are in microseconds
+    QByteArray json("{\"traceEvents\":[");
+    char line[256];
+    bool first = true;
+    foreach (const TraceEvent& event, events)
+    {
+        qsnprintf(line, sizeof(line),
+                  "%s\n{\"name\":\"%s\",\"cat\":\"wiiking2\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lld,\"tid\":%d}",
+                  first ? "" : ",", event.Name, event.Start / 1e3, event.Duration / 1e3, pid, event.Thread);
+        json += line;
+        first = false;
+    }
+    QHash<int, QString>::const_iterator it;
+    for (it = threadNames.constBegin(); it != threadNames.constEnd(); ++it)
+    {
+        qsnprintf(line, sizeof(line), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lld,\"tid\":%d,\"args\":{\"name\":",
+                  first ? "" : ",", pid, it.key());
+        json += line;
+        json += jsonString(it.value()) + "}}";
+        first = false;
+    }
+    json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return device->write(json) == json.size();
+}
+
+bool Tracer::save(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+    return writeChromeTrace(&file);
+}
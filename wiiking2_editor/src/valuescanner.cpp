@@ -0,0 +1,375 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "valuescanner.h"
+#include "bitops.h"
+
+#include <QtEndian>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+// Sets bit i of out when data[i] == value
+static void byteEqualMask(const uchar* data, int size, uchar value, quint64* out)
+{
+    int i = 0;
+#ifdef BITOPS_SSE2
+    const __m128i needle = _mm_set1_epi8(char(value));
+    for (; i + 64 <= size; i += 64)
+    {
+        quint64 m0 = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)),      needle)));
+        quint64 m1 = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i + 16)), needle)));
+        quint64 m2 = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i + 32)), needle)));
+        quint64 m3 = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i + 48)), needle)));
+        out[i / 64] = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+    }
+#endif
+    for (; i < size; i += 64)
+    {
+        quint64 bits = 0;
+        for (int j = 0; j < 64 && i + j < size; j++)
+            if (data[i + j] == value)
+                bits |= Q_UINT64_C(1) << j;
+        out[i / 64] = bits;
+    }
+}
+
+// Sets bit i of out when a[i] == b[i]
+static void byteSameMask(const uchar* a, const uchar* b, int size, quint64* out)
+{
+    int i = 0;
+#ifdef BITOPS_SSE2
+    for (; i + 64 <= size; i += 64)
+    {
+        quint64 bits = 0;
+        for (int k = 0; k < 4; k++)
+        {
+            __m128i va = _mm_loadu_si128((const __m128i*)(a + i + k * 16));
+            __m128i vb = _mm_loadu_si128((const __m128i*)(b + i + k * 16));
+            bits |= quint64(quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)))) << (k * 16);
+        }
+        out[i / 64] = bits;
+    }
+#endif
+    for (; i < size; i += 64)
+    {
+        quint64 bits = 0;
+        for (int j = 0; j < 64 && i + j < size; j++)
+            if (a[i + j] == b[i + j])
+                bits |= Q_UINT64_C(1) << j;
+        out[i / 64] = bits;
+    }
+}
+
+ValueScanner::ValueScanner()
+    : m_type(UInt8Value),
+      m_size(1)
+{
+}
+
+void ValueScanner::reset()
+{
+    m_candidates.clear();
+    m_current.clear();
+    m_previous.clear();
+}
+
+bool ValueScanner::isStarted() const
+{
+    return !m_current.isEmpty();
+}
+
+ValueScanner::ValueType ValueScanner::valueType() const
+{
+    return m_type;
+}
+
+int ValueScanner::valueSize() const
+{
+    return m_size;
+}
+
+int ValueScanner::valueSize(ValueType type)
+{
+    switch (type)
+    {
+        case UInt8Value:  return 1;
+        case UInt16Value: return 2;
+        case UInt32Value:
+        case FloatValue:  return 4;
+    }
+    return 1;
+}
+
+bool ValueScanner::firstScan(const QByteArray& snapshot, ValueType type, Predicate pred, double value, bool aligned)
+{
+    reset();
+    if (pred == Increased || pred == Decreased || pred == Changed || pred == Unchanged)
+        return false;
+
+    if ((pred == EqualTo || pred == NotEqualTo) && !isRepresentable(value, type))
+        return false;
+
+    m_type = type;
+    m_size = valueSize(type);
+    if (snapshot.size() < m_size)
+        return false;
+
+    m_current = snapshot;
+    m_previous = snapshot;
+
+    quint64 pattern = ~Q_UINT64_C(0);
+    if (aligned && m_size == 2)
+        pattern = Q_UINT64_C(0x5555555555555555);
+    else if (aligned && m_size == 4)
+        pattern = Q_UINT64_C(0x1111111111111111);
+    m_candidates.fill(pattern, (snapshot.size() + 63) / 64);
+    clearTail();
+
+    return nextScan(snapshot, pred, value);
+}
+
+bool ValueScanner::nextScan(const QByteArray& snapshot, Predicate pred, double value)
+{
+    if (!isStarted() || snapshot.size() != m_current.size())
+        return false;
+    if ((pred == EqualTo || pred == NotEqualTo) && !isRepresentable(value, m_type))
+        return false;
+
+    m_previous = m_current;
+    m_current = snapshot;
+
+    switch (pred)
+    {
+        case AnyValue:
+            break;
+        case EqualTo:
+        case NotEqualTo:
+            filterEqual(snapshot, value, pred == EqualTo);
+            break;
+        case Changed:
+        case Unchanged:
+            filterUnchanged(snapshot, pred == Unchanged);
+            break;
+        case GreaterThan:
+        case LessThan:
+        case Increased:
+        case Decreased:
+            filterCompare(snapshot, pred, value);
+            break;
+    }
+    return true;
+}
+
+int ValueScanner::candidateCount() const
+{
+    int count = 0;
+    for (int i = 0; i < m_candidates.size(); i++)
+        count += popCount64(m_candidates[i]);
+    return count;
+}
+
+QList<int> ValueScanner::candidates(int max) const
+{
+    QList<int> ret;
+    for (int i = 0; i < m_candidates.size(); i++)
+    {
+        quint64 bits = m_candidates[i];
+        while (bits)
+        {
+            if (max >= 0 && ret.size() >= max)
+                return ret;
+            ret << i * 64 + countTrailingZeros64(bits);
+            bits &= bits - 1;
+        }
+    }
+    return ret;
+}
+
+double ValueScanner::value(int offset) const
+{
+    if (offset < 0 || offset + m_size > m_current.size())
+        return 0;
+    return decode((const uchar*)m_current.constData() + offset, m_type);
+}
+
+double ValueScanner::previousValue(int offset) const
+{
+    if (offset < 0 || offset + m_size > m_previous.size())
+        return 0;
+    return decode((const uchar*)m_previous.constData() + offset, m_type);
+}
+
+double ValueScanner::decode(const uchar* data, ValueType type)
+{
+    switch (type)
+    {
+        case UInt8Value:
+            return data[0];
+        case UInt16Value:
+            return qFromBigEndian<quint16>(data);
+        case UInt32Value:
+            return qFromBigEndian<quint32>(data);
+        case FloatValue:
+        {
+            quint32 raw = qFromBigEndian<quint32>(data);
+            float val;
+            memcpy(&val, &raw, sizeof(val));
+            return val;
+        }
+    }
+    return 0;
+}
+
+bool ValueScanner::isRepresentable(double value, ValueType type)
+{
+    switch (type)
+    {
+        case UInt8Value:  return value >= 0 && value <= 0xFF && value == floor(value);
+        case UInt16Value: return value >= 0 && value <= 0xFFFF && value == floor(value);
+        case UInt32Value: return value >= 0 && value <= 0xFFFFFFFFu && value == floor(value);
+        case FloatValue:  return fabs(value) <= FLT_MAX;
+    }
+    return false;
+}
+
+QByteArray ValueScanner::encode(double value, ValueType type)
+{
+    QByteArray ret(valueSize(type), 0);
+    uchar* data = (uchar*)ret.data();
+    switch (type)
+    {
+        case UInt8Value:
+            data[0] = quint8(value);
+            break;
+        case UInt16Value:
+            qToBigEndian<quint16>(quint16(value), data);
+            break;
+        case UInt32Value:
+            qToBigEndian<quint32>(quint32(value), data);
+            break;
+        case FloatValue:
+        {
+            float val = float(value);
+            quint32 raw;
+            memcpy(&raw, &val, sizeof(raw));
+            qToBigEndian<quint32>(raw, data);
+            break;
+        }
+    }
+    return ret;
+}
+
+// A value matches when all of its bytes match, so the per byte masks are
+// shifted onto the start offset and and-ed together.
+void ValueScanner::filterEqual(const QByteArray& snapshot, double value, bool equal)
+{
+    const QByteArray bytes = encode(value, m_type);
+    const int words = m_candidates.size();
+    QVector<quint64> match(words, ~Q_UINT64_C(0));
+    QVector<quint64> byteMask(words);
+
+    for (int k = 0; k < m_size; k++)
+    {
+        byteEqualMask((const uchar*)snapshot.constData(), snapshot.size(), (uchar)bytes[k], byteMask.data());
+        andBytesMask(match, byteMask, k);
+    }
+
+    for (int i = 0; i < words; i++)
+        m_candidates[i] &= (equal ? match[i] : ~match[i]);
+    clearTail();
+}
+
+void ValueScanner::filterUnchanged(const QByteArray& snapshot, bool unchanged)
+{
+    const int words = m_candidates.size();
+    QVector<quint64> same(words, ~Q_UINT64_C(0));
+    QVector<quint64> byteMask(words);
+
+    byteSameMask((const uchar*)snapshot.constData(), (const uchar*)m_previous.constData(), snapshot.size(), byteMask.data());
+    for (int k = 0; k < m_size; k++)
+        andBytesMask(same, byteMask, k);
+
+    for (int i = 0; i < words; i++)
+        m_candidates[i] &= (unchanged ? same[i] : ~same[i]);
+    clearTail();
+}
+
+// Ordering predicates need the decoded value, but by the time they are used
+// the set is usually sparse, so only the remaining candidates are visited.
+void ValueScanner::filterCompare(const QByteArray& snapshot, Predicate pred, double value)
+{
+    const uchar* cur = (const uchar*)snapshot.constData();
+    const uchar* prev = (const uchar*)m_previous.constData();
+
+    for (int i = 0; i < m_candidates.size(); i++)
+    {
+        quint64 bits = m_candidates[i];
+        quint64 keep = 0;
+        while (bits)
+        {
+            int bit = countTrailingZeros64(bits);
+            int offset = i * 64 + bit;
+            double val = decode(cur + offset, m_type);
+            bool ok = false;
+            switch (pred)
+            {
+                case GreaterThan: ok = val > value; break;
+                case LessThan:    ok = val < value; break;
+                case Increased:   ok = val > decode(prev + offset, m_type); break;
+                case Decreased:   ok = val < decode(prev + offset, m_type); break;
+                default: break;
+            }
+            if (ok)
+                keep |= Q_UINT64_C(1) << bit;
+            bits &= bits - 1;
+        }
+        m_candidates[i] = keep;
+    }
+}
+
+// mask &= byteMask >> shift, carrying bits over from the following word
+void ValueScanner::andBytesMask(QVector<quint64>& mask, const QVector<quint64>& byteMask, int shift) const
+{
+    const int words = mask.size();
+    if (shift == 0)
+    {
+        for (int i = 0; i < words; i++)
+            mask[i] &= byteMask[i];
+        return;
+    }
+
+    for (int i = 0; i < words; i++)
+    {
+        quint64 next = (i + 1 < words ? byteMask[i + 1] : 0);
+        mask[i] &= (byteMask[i] >> shift) | (next << (64 - shift));
+    }
+}
+
+// Offsets where the value would run past the end are never candidates
+void ValueScanner::clearTail()
+{
+    const int first = m_current.size() - m_size + 1;
+    for (int i = first; i < m_candidates.size() * 64; i++)
+    {
+        if ((i & 63) == 0)
+        {
+            for (int w = i / 64; w < m_candidates.size(); w++)
+                m_candidates[w] = 0;
+            return;
+        }
+        m_candidates[i / 64] &= ~(Q_UINT64_C(1) << (i & 63));
+    }
+}
@@ -0,0 +1,272 @@
+// This file is part of WiiKing2 Editor.
+//
+// WiiKing2 Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Wiiking2 Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with WiiKing2 Editor.  If not, see <http://www.gnu.org/licenses/>
+
+#include "valuescannerdock.h"
+#include "skywardswordfile.h"
+#include "slotlayout.h"
+
+#include <QComboBox>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+
+ValueScannerDock::ValueScannerDock(QWidget *parent) :
+    QDockWidget(tr("Value Scanner"), parent),
+    m_gameFile(NULL)
+{
+    setObjectName("valueScannerDock");
+
+    QWidget* contents = new QWidget(this);
+
+    m_typeCombo = new QComboBox(contents);
+    m_typeCombo->addItem(tr("Byte"),   ValueScanner::UInt8Value);
+    m_typeCombo->addItem(tr("Short"),  ValueScanner::UInt16Value);
+    m_typeCombo->addItem(tr("Int"),    ValueScanner::UInt32Value);
+    m_typeCombo->addItem(tr("Float"),  ValueScanner::FloatValue);
+    m_alignedCheck = new QCheckBox(tr("Aligned"), contents);
+
+    m_predicateCombo = new QComboBox(contents);
+    m_predicateCombo->addItem(tr("Unknown value"), ValueScanner::AnyValue);
+    m_predicateCombo->addItem(tr("Equal to"),      ValueScanner::EqualTo);
+    m_predicateCombo->addItem(tr("Not equal to"),  ValueScanner::NotEqualTo);
+    m_predicateCombo->addItem(tr("Greater than"),  ValueScanner::GreaterThan);
+    m_predicateCombo->addItem(tr("Less than"),     ValueScanner::LessThan);
+    m_predicateCombo->addItem(tr("Increased"),     ValueScanner::Increased);
+    m_predicateCombo->addItem(tr("Decreased"),     ValueScanner::Decreased);
+    m_predicateCombo->addItem(tr("Changed"),       ValueScanner::Changed);
+    m_predicateCombo->addItem(tr("Unchanged"),     ValueScanner::Unchanged);
+    m_valueEdit = new QLineEdit(contents);
+
+    m_firstScanBtn = new QPushButton(tr("First Scan"), contents);
+    m_nextScanBtn  = new QPushButton(tr("Next Scan"), contents);
+    m_scanFilesBtn = new QPushButton(tr("Scan Files..."), contents);
+    m_scanFilesBtn->setToolTip(tr("Runs the next scan over each selected save in turn"));
+    m_resetBtn     = new QPushButton(tr("Reset"), contents);
+
+    m_resultTree = new QTreeWidget(contents);
+    m_resultTree->setRootIsDecorated(false);
+    m_resultTree->setHeaderLabels(QStringList() << tr("Offset") << tr("Adventure") << tr("Previous") << tr("Current"));
+    m_statusLabel = new QLabel(contents);
+
+    QHBoxLayout* typeLayout = new QHBoxLayout;
+    typeLayout->addWidget(m_typeCombo);
+    typeLayout->addWidget(m_alignedCheck);
+
+    QHBoxLayout* valueLayout = new QHBoxLayout;
+    valueLayout->addWidget(m_predicateCombo);
+    valueLayout->addWidget(m_valueEdit);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout;
+    buttonLayout->addWidget(m_firstScanBtn);
+    buttonLayout->addWidget(m_nextScanBtn);
+    buttonLayout->addWidget(m_scanFilesBtn);
+    buttonLayout->addWidget(m_resetBtn);
+
+    QVBoxLayout* layout = new QVBoxLayout(contents);
+    layout->addLayout(typeLayout);
+    layout->addLayout(valueLayout);
+    layout->addLayout(buttonLayout);
+    layout->addWidget(m_resultTree);
+    layout->addWidget(m_statusLabel);
+    setWidget(contents);
+
+    connect(m_firstScanBtn,   SIGNAL(clicked()),                             this, SLOT(onFirstScan()));
+    connect(m_nextScanBtn,    SIGNAL(clicked()),                             this, SLOT(onNextScan()));
+    connect(m_scanFilesBtn,   SIGNAL(clicked()),                             this, SLOT(onScanFiles()));
+    connect(m_resetBtn,       SIGNAL(clicked()),                             this, SLOT(onReset()));
+    connect(m_predicateCombo, SIGNAL(currentIndexChanged(int)),              this, SLOT(onPredicateChanged(int)));
+    connect(m_resultTree,     SIGNAL(itemDoubleClicked(QTreeWidgetItem*,int)), this, SLOT(onItemActivated(QTreeWidgetItem*)));
+
+    onPredicateChanged(m_predicateCombo->currentIndex());
+    onReset();
+}
+
+void ValueScannerDock::setGameFile(SkywardSwordFile* file)
+{
+    m_gameFile = file;
+    m_firstScanBtn->setEnabled(m_gameFile != NULL);
+    m_nextScanBtn->setEnabled(m_gameFile != NULL && m_scanner.isStarted());
+}
+
+void ValueScannerDock::onFirstScan()
+{
+    if (!m_gameFile || !m_gameFile->isOpen())
+        return;
+
+    double value = 0;
+    if (!currentValue(value))
+        return;
+
+    ValueScanner::ValueType type = (ValueScanner::ValueType)m_typeCombo->itemData(m_typeCombo->currentIndex()).toInt();
+    if (!m_scanner.firstScan(m_gameFile->fileData(), type, currentPredicate(), value, m_alignedCheck->isChecked()))
+    {
+        m_statusLabel->setText(tr("This comparison needs a previous scan"));
+        return;
+    }
+
+    m_typeCombo->setEnabled(false);
+    m_alignedCheck->setEnabled(false);
+    m_nextScanBtn->setEnabled(true);
+    m_scanFilesBtn->setEnabled(true);
+    updateResults();
+}
+
+void ValueScannerDock::onNextScan()
+{
+    if (!m_gameFile || !m_gameFile->isOpen())
+        return;
+
+    double value = 0;
+    if (!currentValue(value))
+        return;
+
+    if (!m_scanner.nextScan(m_gameFile->fileData(), currentPredicate(), value))
+    {
+        m_statusLabel->setText(tr("The save doesn't match the first snapshot"));
+        return;
+    }
+    updateResults();
+}
+
+void ValueScannerDock::onScanFiles()
+{
+    double value = 0;
+    if (!currentValue(value))
+        return;
+
+    QStringList files = QFileDialog::getOpenFileNames(this, tr("Select saves in the order they were made"), QString(),
+                                                      tr("Skyward Sword Saves (*.sav *.bin)"));
+    if (files.isEmpty())
+        return;
+
+    int skipped = 0;
+    foreach (const QString& filename, files)
+    {
+        SkywardSwordFile file(filename);
+        if (!file.isOpen() || !m_scanner.nextScan(file.fileData(), currentPredicate(), value))
+            skipped++;
+    }
+
+    updateResults();
+    if (skipped > 0)
+        m_statusLabel->setText(m_statusLabel->text() + tr(" (%1 files skipped)").arg(skipped));
+}
+
+void ValueScannerDock::onReset()
+{
+    m_scanner.reset();
+    m_resultTree->clear();
+    m_statusLabel->clear();
+    m_typeCombo->setEnabled(true);
+    m_alignedCheck->setEnabled(true);
+    m_firstScanBtn->setEnabled(m_gameFile != NULL);
+    m_nextScanBtn->setEnabled(false);
+    m_scanFilesBtn->setEnabled(false);
+}
+
+void ValueScannerDock::onPredicateChanged(int index)
+{
+    ValueScanner::Predicate pred = (ValueScanner::Predicate)m_predicateCombo->itemData(index).toInt();
+    m_valueEdit->setEnabled(pred == ValueScanner::EqualTo || pred == ValueScanner::NotEqualTo ||
+                            pred == ValueScanner::GreaterThan || pred == ValueScanner::LessThan);
+}
+
+void ValueScannerDock::onItemActivated(QTreeWidgetItem* item)
+{
+    if (!item)
+        return;
+
+    int offset = item->data(0, Qt::UserRole).toInt() - SaveLayout::SLOT_OFFSET;
+    int game = offset / SlotLayout::SIZE;
+    if (offset < 0 || game >= SkywardSwordFile::GameCount)
+        emit addressActivated(-1, item->data(0, Qt::UserRole).toInt());
+    else
+        emit addressActivated(game, offset % SlotLayout::SIZE);
+}
+
+bool ValueScannerDock::currentValue(double& value)
+{
+    if (!m_valueEdit->isEnabled())
+        return true;
+
+    bool ok = false;
+    QString text = m_valueEdit->text().trimmed();
+    if (text.startsWith("0x", Qt::CaseInsensitive))
+        value = text.mid(2).toULongLong(&ok, 16);
+    else
+        value = text.toDouble(&ok);
+
+    if (!ok)
+    {
+        m_statusLabel->setText(tr("Invalid value \"%1\"").arg(text));
+        return false;
+    }
+
+    // Only an exact match needs the value in the type's own encoding, the
+    // type can't change once a scan has started
+    ValueScanner::Predicate pred = currentPredicate();
+    ValueScanner::ValueType type = m_scanner.isStarted() ? m_scanner.valueType()
+            : (ValueScanner::ValueType)m_typeCombo->itemData(m_typeCombo->currentIndex()).toInt();
+    if ((pred == ValueScanner::EqualTo || pred == ValueScanner::NotEqualTo) && !ValueScanner::isRepresentable(value, type))
+    {
+        m_statusLabel->setText(tr("%1 can't be stored in the selected type").arg(text));
+        return false;
+    }
+    return true;
+}
+
+ValueScanner::Predicate ValueScannerDock::currentPredicate() const
+{
+    return (ValueScanner::Predicate)m_predicateCombo->itemData(m_predicateCombo->currentIndex()).toInt();
+}
+
+void ValueScannerDock::updateResults()
+{
+    m_resultTree->clear();
+
+    int count = m_scanner.candidateCount();
+    QList<int> offsets = m_scanner.candidates(MAX_LISTED_RESULTS);
+    foreach (int offset, offsets)
+    {
+        int game = (offset - SaveLayout::SLOT_OFFSET) / SlotLayout::SIZE;
+        QString adventure = (offset < SaveLayout::SLOT_OFFSET || game >= SkywardSwordFile::GameCount)
+                ? tr("Header")
+                : QString("%1 (0x%2)").arg(game + 1).arg((offset - SaveLayout::SLOT_OFFSET) % SlotLayout::SIZE, 4, 16, QChar('0'));
+
+        QTreeWidgetItem* item = new QTreeWidgetItem(m_resultTree);
+        item->setText(0, QString("0x%1").arg(offset, 4, 16, QChar('0')));
+        item->setData(0, Qt::UserRole, offset);
+        item->setText(1, adventure);
+        item->setText(2, formatValue(m_scanner.previousValue(offset)));
+        item->setText(3, formatValue(m_scanner.value(offset)));
+    }
+
+    if (count > offsets.size())
+        m_statusLabel->setText(tr("%1 candidates (first %2 listed)").arg(count).arg(offsets.size()));
+    else
+        m_statusLabel->setText(tr("%1 candidates").arg(count));
+}
+
+QString ValueScannerDock::formatValue(double value) const
+{
+    if (m_scanner.valueType() == ValueScanner::FloatValue)
+        return QString::number(value);
+    return QString("%1 (0x%2)").arg(quint64(value)).arg(quint64(value), 0, 16);
+}
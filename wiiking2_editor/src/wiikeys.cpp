@@ -65,55 +65,50 @@ bool WiiKeys::open(const QString &filepath, bool clear)
             m_ngKeyID = 0;
     }
 
-    FILE* f = fopen(filepath.toStdString().c_str(), "rb");
+    quint32    ngId;
+    quint32    ngKeyId;
+    QByteArray ngPriv;
+    QByteArray ngSig;
+    if (!readKeysFile(filepath, &ngId, &ngKeyId, &ngPriv, &ngSig))
+        return false;
 
-    if (f)
+    if (!m_ngPriv)
+    {
+        m_ngPriv = new char[0x1E];
+        memcpy(m_ngPriv, ngPriv.constData(), 0x1E);
+    }
+    if (!m_ngSig)
     {
-        fseek(f, 0, SEEK_END);
-        quint32 size = ftell(f);
-        fseek(f, 0, SEEK_SET);
+        m_ngSig = new char[0x3C];
+        memcpy(m_ngSig, ngSig.constData(), 0x3C);
+    }
 
-        if (size != 0x400)
-            return false;
+    if (m_ngID == 0)
+        m_ngID = ngId;
 
-        char buf[0x0C + 1];
-        memset(buf, 0, 0x0D);
-        fread(buf, 1, 0x0C, f);
-        if (strcmp(buf, "BackupMii v1"))
-            return false;
+    if (m_ngKeyID == 0)
+        m_ngKeyID = ngKeyId;
 
-        if (!m_ngPriv)
-        {
-            m_ngPriv = new char[0x1E];
-            fseek(f, 0x128, SEEK_SET);
-            fread(m_ngPriv, 1, 0x1E, f);
-        }
-        if (!m_ngSig)
-        {
-            m_ngSig = new char[0x3C];
-            fseek(f, 0x20C, SEEK_SET);
-            fread(m_ngSig, 1, 0x3C, f);
-        }
+    m_open = true;
+    return true;
+}
 
-        if (m_ngID == 0)
-        {
-            fseek(f, 0x124, SEEK_SET);
-            fread(&m_ngID, 1, 0x04, f);
-            m_ngID = qFromBigEndian<quint32>(m_ngID);
-        }
+bool WiiKeys::readKeysFile(const QString& filepath, quint32* ngId, quint32* ngKeyId, QByteArray* ngPriv, QByteArray* ngSig)
+{
+    QFile file(filepath);
+    if (!file.open(QFile::ReadOnly) || file.size() != 0x400)
+        return false;
 
-        if (m_ngKeyID == 0)
-        {
-            fseek(f, 0x208, SEEK_SET);
-            fread(&m_ngKeyID, 1,  0x04, f);
-            m_ngKeyID = qFromBigEndian<quint32>(m_ngKeyID);
-        }
-        fclose(f);
+    QByteArray data = file.readAll();
+    if (data.size() != 0x400 || !data.startsWith("BackupMii v1"))
+        return false;
 
-        m_open = true;
-        return true;
-    }
-    return false;
+    const uchar* p = (const uchar*)data.constData();
+    *ngId    = qFromBigEndian<quint32>(p + 0x124);
+    *ngKeyId = qFromBigEndian<quint32>(p + 0x208);
+    *ngPriv  = data.mid(0x128, 0x1E);
+    *ngSig   = data.mid(0x20C, 0x3C);
+    return true;
 }
 
 bool WiiKeys::loadKeys()
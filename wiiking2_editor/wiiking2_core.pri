@@ -0,0 +1,47 @@
+# Sources which only depend on QtCore. They are shared between the editor
+# and the command line tool.
+
+INCLUDEPATH += $$PWD/include
+
+SOURCES += \
+    $$PWD/src/checksum.cpp \
+    $$PWD/src/valuescanner.cpp \
+    $$PWD/src/flagdiffanalyzer.cpp \
+    $$PWD/src/fieldnames.cpp \
+    $$PWD/src/aes128.cpp \
+    $$PWD/src/databincodec.cpp \
+    $$PWD/src/ec233.cpp \
+    $$PWD/src/signingcontext.cpp \
+    $$PWD/src/wiikeys.cpp \
+    $$PWD/src/databinresigner.cpp \
+    $$PWD/src/databinreader.cpp \
+    $$PWD/src/convertpipeline.cpp \
+    $$PWD/src/slottransfer.cpp \
+    $$PWD/src/savetemplate.cpp \
+    $$PWD/src/savegenerator.cpp \
+    $$PWD/src/phasetimer.cpp \
+    $$PWD/src/tracer.cpp \
+    $$PWD/src/wiitime.cpp
+
+HEADERS += \
+    $$PWD/include/checksum.h \
+    $$PWD/include/bitops.h \
+    $$PWD/include/beview.h \
+    $$PWD/include/slotlayout.h \
+    $$PWD/include/wiitime.h \
+    $$PWD/include/valuescanner.h \
+    $$PWD/include/flagdiffanalyzer.h \
+    $$PWD/include/fieldnames.h \
+    $$PWD/include/aes128.h \
+    $$PWD/include/databincodec.h \
+    $$PWD/include/ec233.h \
+    $$PWD/include/signingcontext.h \
+    $$PWD/include/wiikeys.h \
+    $$PWD/include/databinresigner.h \
+    $$PWD/include/databinreader.h \
+    $$PWD/include/convertpipeline.h \
+    $$PWD/include/slottransfer.h \
+    $$PWD/include/savetemplate.h \
+    $$PWD/include/savegenerator.h \
+    $$PWD/include/phasetimer.h \
+    $$PWD/include/tracer.h
@@ -0,0 +1,94 @@
+# The editor without its main(), shared with the UI benchmark. Includes
+# wiiking2_core.pri.
+
+SOURCES += \
+    $$PWD/src/mainwindow.cpp \
+    $$PWD/src/newgamedialog.cpp \
+    $$PWD/src/aboutdialog.cpp \
+    $$PWD/src/fileinfodialog.cpp \
+    $$PWD/src/skywardswordfile.cpp \
+    $$PWD/src/preferencesdialog.cpp \
+    $$PWD/src/common.cpp \
+    $$PWD/src/qhexedit2/xbytearray.cpp \
+    $$PWD/src/qhexedit2/qhexedit_p.cpp \
+    $$PWD/src/qhexedit2/qhexedit.cpp \
+    $$PWD/src/qhexedit2/undoengine.cpp \
+    $$PWD/src/qhexedit2/hexdumpformatter.cpp \
+    $$PWD/src/qhexedit2/changebitmap.cpp \
+    $$PWD/src/qhexedit2/searchengine.cpp \
+    $$PWD/src/qhexedit2/diffengine.cpp \
+    $$PWD/src/qhexedit2/qhexdiffview.cpp \
+    $$PWD/src/qhexedit2/intervaltree.cpp \
+    $$PWD/src/qhexedit2/structtemplate.cpp \
+    $$PWD/src/newfiledialog.cpp \
+    $$PWD/src/gameinfowidget.cpp \
+    $$PWD/src/settingsmanager.cpp \
+    $$PWD/src/playtimewidget.cpp \
+    $$PWD/src/importexportquestdialog.cpp \
+    $$PWD/src/triforcewidget.cpp \
+    $$PWD/src/hexsearchwidget.cpp \
+    $$PWD/src/valuescannerdock.cpp \
+    $$PWD/src/flagdiffdock.cpp \
+    $$PWD/src/flagdiffjob.cpp \
+    $$PWD/src/comparedialog.cpp \
+    $$PWD/src/datainspectormodel.cpp \
+    $$PWD/src/filejob.cpp
+
+HEADERS  += \
+    $$PWD/include/mainwindow.h \
+    $$PWD/include/igamefile.h \
+    $$PWD/include/newgamedialog.h \
+    $$PWD/include/aboutdialog.h \
+    $$PWD/include/fileinfodialog.h \
+    $$PWD/include/skywardswordfile.h \
+    $$PWD/include/preferencesdialog.h \
+    $$PWD/include/common.h \
+    $$PWD/include/qhexedit2/xbytearray.h \
+    $$PWD/include/qhexedit2/qhexedit_p.h \
+    $$PWD/include/qhexedit2/qhexedit.h \
+    $$PWD/include/qhexedit2/undoengine.h \
+    $$PWD/include/qhexedit2/hexdumpformatter.h \
+    $$PWD/include/qhexedit2/changebitmap.h \
+    $$PWD/include/qhexedit2/searchengine.h \
+    $$PWD/include/qhexedit2/diffengine.h \
+    $$PWD/include/qhexedit2/qhexdiffview.h \
+    $$PWD/include/qhexedit2/intervaltree.h \
+    $$PWD/include/qhexedit2/structtemplate.h \
+    $$PWD/include/newfiledialog.h \
+    $$PWD/include/gameinfowidget.h \
+    $$PWD/include/settingsmanager.h \
+    $$PWD/include/playtimewidget.h \
+    $$PWD/include/importexportquestdialog.h \
+    $$PWD/include/triforcewidget.h \
+    $$PWD/include/hexsearchwidget.h \
+    $$PWD/include/valuescannerdock.h \
+    $$PWD/include/flagdiffdock.h \
+    $$PWD/include/flagdiffjob.h \
+    $$PWD/include/comparedialog.h \
+    $$PWD/include/datainspectormodel.h \
+    $$PWD/include/filejob.h
+
+FORMS    += \
+    $$PWD/forms/mainwindow.ui \
+    $$PWD/forms/newgamedialog.ui \
+    $$PWD/forms/aboutdialog.ui \
+    $$PWD/forms/fileinfodialog.ui \
+    $$PWD/forms/preferencesdialog.ui \
+    $$PWD/forms/newfiledialog.ui \
+    $$PWD/forms/gameinfowidget.ui \
+    $$PWD/forms/playtimewidget.ui \
+    $$PWD/forms/importexportquestdialog.ui
+
+RESOURCES += \
+    $$PWD/resources/resources.qrc
+
+OTHER_FILES += \
+    $$PWD/resources/mainicon.rc \
+    $$PWD/resources/styleWin32.css \
+    $$PWD/resources/styleUnix.css \
+    $$PWD/resources/clockdisplay.css
+
+TRANSLATIONS += \
+    $$PWD/resources/languages/ja.ts
+
+include($$PWD/wiiking2_core.pri)
@@ -2,6 +2,10 @@ TEMPLATE = subdirs
 CONFIG += ordered
 
 wiiking2.depends += libzelda \
-                    wiiking2_editor
+                    wiiking2_editor \
+                    wiiking2_cli \
+                    wiiking2_benchmarks
 SUBDIRS = libzelda \
-          wiiking2_editor
+          wiiking2_editor \
+          wiiking2_cli \
+          wiiking2_benchmarks